@@ -12,6 +12,11 @@
 #include "memory/DMA.hpp"
 #include "memory/BootROM.hpp"
 #include "cartridge/Cartridge.hpp"
+#include "script/ScriptHooks.hpp"
+#include "state/StateBuffer.hpp"
+
+#include <cstring>
+#include <iostream>
 
 Emulator::Emulator()
     : cpu(std::make_unique<CPU>())
@@ -98,12 +103,25 @@ void Emulator::WireComponents() {
     );
     
     // === Connect CPU to Bus (wire the address/data lines) ===
+    // Write hooks watch the CPU's writes only (not DMA or debugger pokes)
     cpu->ConnectBus(
         [this](uint16_t addr) { return bus->Read(addr); },
-        [this](uint16_t addr, uint8_t val) { bus->Write(addr, val); },
+        [this](uint16_t addr, uint8_t val) {
+            bus->Write(addr, val);
+            if (write_hooks_enabled && hooks->WatchesWrite(addr)) {
+                hooks->DispatchWrite(addr, val);
+            }
+        },
         [this](uint8_t cycles) { TickComponents(cycles); }  // Tick per M-cycle
     );
     
+    // === Connect Scripting Exec Hooks (bitmap is set by UpdateHookWiring) ===
+    cpu->ConnectExecHook([this](uint16_t pc) { hooks->DispatchExec(pc); });
+    
+    // === Connect CPU Interrupt Input (IF & IE line from interrupt controller) ===
+    // Sampled every instruction; the bus is only used on the dispatch path
+    cpu->ConnectInterruptLine(interrupts->GetPendingLine());
+    
     // === Connect PPU Interrupt Callback (Per SameBoy L558: immediate IF bit set) ===
     // Real hardware sets IF bit at exact cycle, not batched after M-cycle
     ppu->SetInterruptCallback([this](uint8_t bit) {
@@ -282,6 +300,7 @@ void Emulator::Reset() {
     interrupts->Reset();
     
     total_cycles = 0;
+    hooked_frame = 0;
     
     // If no boot ROM, start from $0100 with post-boot state
     if (!bootrom->IsEnabled()) {
@@ -305,10 +324,28 @@ uint8_t Emulator::Step() {
     uint8_t cycles = cpu->Step();
     
     total_cycles += cycles;
+    DispatchFrameHooks();
     
     return cycles;
 }
 
+uint32_t Emulator::RunCycles(uint32_t budget) {
+    uint32_t cycles = cpu->Run(budget, ppu->GetFrameCounter());
+    
+    total_cycles += cycles;
+    DispatchFrameHooks();
+    
+    return cycles;
+}
+
+// Frame hooks run between instructions, right after the frame completes
+void Emulator::DispatchFrameHooks() {
+    if (frame_hooks_enabled && ppu->GetFrameCount() != hooked_frame) {
+        hooked_frame = ppu->GetFrameCount();
+        hooks->DispatchFrame();
+    }
+}
+
 /**
  * Tick Components - Synchronize all hardware
  * 
@@ -407,7 +444,7 @@ void Emulator::ProcessDMA(uint8_t cycles) {
 void Emulator::StepCycles(uint32_t cycles) {
     uint32_t executed = 0;
     while (executed < cycles) {
-        executed += Step();
+        executed += RunCycles(cycles - executed);
     }
 }
 
@@ -420,8 +457,9 @@ void Emulator::RunFrame() {
     
     // Run until frame complete OR we've run enough cycles
     // The cycle count is needed when LCD is disabled (e.g., during boot ROM)
+    // CPU::Run returns as soon as the frame counter moves
     while (!ppu->IsFrameComplete() && cycles_this_frame < FRAME_CYCLES) {
-        cycles_this_frame += Step();
+        cycles_this_frame += RunCycles(FRAME_CYCLES - cycles_this_frame);
     }
 }
 
@@ -455,6 +493,10 @@ void Emulator::ConnectAudioBuffer(AudioBuffer* buffer) {
     apu->SetAudioBuffer(buffer);
 }
 
+void Emulator::SyncAudio() {
+    apu->SyncSynthesis();
+}
+
 void Emulator::SetButton(uint8_t button, bool pressed) {
     joypad->SetButton(button, pressed);
 }
@@ -479,6 +521,10 @@ void Emulator::ClearSerialTransferComplete() {
     serial->ClearTransferComplete();
 }
 
+void Emulator::SetSerialCallback(std::function<void(uint8_t)> callback) {
+    serial->SetTransferCallback(callback);
+}
+
 // === Debug Access ===
 
 uint16_t Emulator::GetPC() const { return cpu->GetPC(); }
@@ -489,15 +535,204 @@ uint16_t Emulator::GetDE() const { return cpu->GetDE(); }
 uint16_t Emulator::GetHL() const { return cpu->GetHL(); }
 uint8_t Emulator::GetPPUMode() const { return ppu->GetMode(); }
 uint8_t Emulator::GetLY() const { return ppu->GetLY(); }
+bool Emulator::IsCPUHalted() const { return cpu->IsHalted(); }
+bool Emulator::GetIME() const { return cpu->GetIME(); }
 
 uint8_t Emulator::DebugRead(uint16_t addr) const {
     return bus->Read(addr);
 }
 
+void Emulator::DebugWrite(uint16_t addr, uint8_t value) {
+    bus->Write(addr, value);
+}
+
+uint32_t Emulator::GetFrameCount() const {
+    return ppu->GetFrameCount();
+}
+
 bool Emulator::IsBootROMActive() const {
     return bootrom->IsEnabled();
 }
 
+void Emulator::SetTileMapCacheEnabled(bool enabled) {
+    ppu->SetTileMapCacheEnabled(enabled);
+}
+
+void Emulator::GetTileMapImage(int map, bool unsigned_tiles, uint8_t* out) {
+    const TileMapCache::Layer& layer = ppu->GetTileMapLayer(map, unsigned_tiles);
+    for (const TileMapCache::Row& row : layer) {
+        for (uint16_t word : row) {
+            for (int pixel = 0; pixel < 8; pixel++) {
+                *out++ = (word >> (14 - pixel * 2)) & 3;
+            }
+        }
+    }
+}
+
 void Emulator::SetMooneyeCallback(std::function<void(bool)> callback) {
     cpu->SetMooneyeCallback(callback);
 }
+
+// === Save States ===
+
+static constexpr char STATE_MAGIC[8] = { 'G', 'B', 'E', '3', 'S', 'T', 'A', 'T' };
+static constexpr uint32_t STATE_VERSION = 1;
+
+bool Emulator::SaveState(std::vector<uint8_t>& out, std::vector<StateSection>* sections) {
+    // The synthesis worker holds the authoritative channel state
+    apu->SyncSynthesis();
+    
+    out.clear();
+    if (sections) sections->clear();
+    StateWriter state(out);
+    
+    // Records the bytes each step appended (for lockstep diffs)
+    auto section = [&](const char* name, auto&& save) {
+        size_t offset = out.size();
+        save();
+        if (sections) sections->push_back({name, offset, out.size() - offset});
+    };
+    
+    section("header", [&] { state(STATE_MAGIC, STATE_VERSION); });
+    
+    // Cartridge first: its ROM check rejects a foreign state before
+    // anything else is touched on load
+    section("cartridge", [&] { cartridge->SaveState(state); });
+    section("cpu", [&] { cpu->SaveState(state); });
+    section("interrupts", [&] { interrupts->SaveState(state); });
+    section("ppu", [&] { ppu->SaveState(state); });
+    section("apu", [&] { apu->SaveState(state); });
+    section("timer", [&] { timer->SaveState(state); });
+    section("joypad", [&] { joypad->SaveState(state); });
+    section("serial", [&] { serial->SaveState(state); });
+    section("memory", [&] { memory->SaveState(state); });
+    section("dma", [&] { dma->SaveState(state); });
+    section("bootrom", [&] { bootrom->SaveState(state); });
+    section("clock", [&] { state(total_cycles); });
+    return true;
+}
+
+bool Emulator::LoadState(const std::vector<uint8_t>& data) {
+    char magic[8] = {};
+    uint32_t version = 0;
+    StateReader header(data.data(), data.size());
+    header(magic, version);
+    if (!header.IsValid() || std::memcmp(magic, STATE_MAGIC, sizeof(magic)) != 0 || version != STATE_VERSION) {
+        std::cerr << "Not a gb-emu3 v" << STATE_VERSION << " save state\n";
+        return false;
+    }
+    
+    // Components load in place, so keep a way back from a truncated state
+    std::vector<uint8_t> previous;
+    SaveState(previous);
+    
+    auto apply = [this](const std::vector<uint8_t>& source) {
+        StateReader state(source.data(), source.size());
+        char skip_magic[8];
+        uint32_t skip_version;
+        state(skip_magic, skip_version);
+        
+        cartridge->LoadState(state);
+        if (!state.IsValid()) return false;
+        cpu->LoadState(state);
+        interrupts->LoadState(state);
+        ppu->LoadState(state);
+        apu->LoadState(state);
+        timer->LoadState(state);
+        joypad->LoadState(state);
+        serial->LoadState(state);
+        memory->LoadState(state);
+        dma->LoadState(state);
+        bootrom->LoadState(state);
+        state(total_cycles);
+        return state.IsValid() && state.AtEnd();
+    };
+    
+    bool loaded = apply(data);
+    if (!loaded) {
+        std::cerr << "Save state doesn't match this ROM or is truncated\n";
+        apply(previous);
+    }
+    
+    bus->SetBootROMEnabled(bootrom->IsEnabled());
+    hooked_frame = ppu->GetFrameCount();
+    return loaded;
+}
+
+// === Memory Footprint ===
+
+std::vector<Emulator::FootprintEntry> Emulator::GetFootprint() const {
+    std::vector<FootprintEntry> entries = {
+        { "emulator", sizeof(Emulator), false },
+        { "cpu", sizeof(CPU), false },
+        { "interrupts", sizeof(InterruptController), false },
+        { "ppu", sizeof(PPU), false },
+        { "apu", sizeof(APU), false },
+        { "timer", sizeof(Timer), false },
+        { "joypad", sizeof(Joypad), false },
+        { "serial", sizeof(Serial), false },
+        { "bus", sizeof(Bus), false },
+        { "memory", sizeof(Memory), false },
+        { "dma", sizeof(DMA), false },
+        { "bootrom", sizeof(BootROM), false },
+        { "cartridge", sizeof(Cartridge), false },
+        { "cartridge ram", cartridge->GetRAMFootprint(), false },
+    };
+    if (size_t worker = apu->GetWorkerFootprint()) {
+        entries.push_back({ "apu worker", worker, false });
+    }
+    if (hooks) {
+        entries.push_back({ "hooks", sizeof(ScriptHooks), false });
+    }
+    if (ppu->IsTileMapCacheEnabled()) {
+        entries.push_back({ "tile map cache", sizeof(TileMapCache), false });
+    }
+    entries.push_back({ "rom", cartridge->GetROMFootprint(), true });
+    return entries;
+}
+
+// === Scripting Hooks ===
+
+uint32_t Emulator::AddFrameHook(std::function<void()> hook) {
+    uint32_t id = GetHooks().AddFrameHook(std::move(hook));
+    UpdateHookWiring();
+    return id;
+}
+
+uint32_t Emulator::AddWriteHook(uint16_t first, uint16_t last, std::function<void(uint16_t, uint8_t)> hook) {
+    uint32_t id = GetHooks().AddWriteHook(first, last, std::move(hook));
+    UpdateHookWiring();
+    return id;
+}
+
+uint32_t Emulator::AddExecHook(uint16_t addr, std::function<void(uint16_t)> hook) {
+    uint32_t id = GetHooks().AddExecHook(addr, std::move(hook));
+    UpdateHookWiring();
+    return id;
+}
+
+bool Emulator::RemoveHook(uint32_t id) {
+    if (!hooks) return false;
+    bool removed = hooks->Remove(id);
+    UpdateHookWiring();
+    return removed;
+}
+
+// The registry (~9 KB of lookup tables) only exists once a hook is added;
+// it is never freed, since a hook may be running when the last one goes
+ScriptHooks& Emulator::GetHooks() {
+    if (!hooks) hooks = std::make_unique<ScriptHooks>();
+    return *hooks;
+}
+
+void Emulator::UpdateHookWiring() {
+    // Only flags and a pointer change, so this is safe from inside a hook
+    write_hooks_enabled = hooks->HasWriteHooks();
+    cpu->SetExecHookMap(hooks->HasExecHooks() ? hooks->GetExecMap() : nullptr);
+    
+    // A new frame hook waits for the next frame rather than the last one
+    if (!frame_hooks_enabled && hooks->HasFrameHooks()) {
+        hooked_frame = ppu->GetFrameCount();
+    }
+    frame_hooks_enabled = hooks->HasFrameHooks();
+}
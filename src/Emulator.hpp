@@ -2,7 +2,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <functional>
+#include "host/ArenaAllocated.hpp"
 
 // Forward declarations - components don't know each other
 class CPU;
@@ -18,6 +20,7 @@ class Cartridge;
 class InterruptController;
 class BootROM;
 class AudioBuffer;
+class ScriptHooks;
 
 /**
  * Emulator - The "Motherboard" / LR35902 SoC Simulation
@@ -37,7 +40,7 @@ class AudioBuffer;
  * - Routes interrupt signals from peripherals to CPU
  * - Does NOT contain emulation logic - that's in the components
  */
-class Emulator {
+class Emulator : public ArenaAllocated {
 public:
     Emulator();
     ~Emulator();
@@ -70,7 +73,8 @@ public:
     void GetAudioSample(float& left, float& right) const;
     bool HasAudioSample() const;
     void ClearAudioSample();
-    void ConnectAudioBuffer(AudioBuffer* buffer);
+    void ConnectAudioBuffer(AudioBuffer* buffer);  // Also moves synthesis to a worker thread
+    void SyncAudio();  // Wait until the buffer holds every sample emulated so far
     
     // === Input (directly exposed to Joypad) ===
     void SetButton(uint8_t button, bool pressed);
@@ -81,6 +85,8 @@ public:
     uint8_t GetSerialData() const;
     bool IsSerialTransferComplete() const;
     void ClearSerialTransferComplete();
+    // Called with each sent byte as its transfer completes
+    void SetSerialCallback(std::function<void(uint8_t)> callback);
     
     // === Debug Access (directly exposed for debugging) ===
     uint16_t GetPC() const;
@@ -91,14 +97,30 @@ public:
     uint16_t GetHL() const;
     uint8_t GetPPUMode() const;
     uint8_t GetLY() const;
+    bool IsCPUHalted() const;
+    bool GetIME() const;
     uint64_t GetTotalCycles() const { return total_cycles; }
     
     // Direct memory read (for debuggers, bypasses normal restrictions)
     uint8_t DebugRead(uint16_t addr) const;
     
+    // Direct memory write (for scripts/debuggers, never triggers write hooks)
+    void DebugWrite(uint16_t addr, uint8_t value);
+    
+    // Frames completed by the PPU since reset
+    uint32_t GetFrameCount() const;
+    
     // Check if boot ROM is still running
     bool IsBootROMActive() const;
     
+    // === Tile Map Layers (see ppu/TileMapCache.hpp) ===
+    // Pre-rendered BG/window maps for map viewers, off by default (~65 KB,
+    // outside the lean headless budget); the PPU never draws from them
+    void SetTileMapCacheEnabled(bool enabled);
+    // 256x256 color indices (0-3, before BGP) of map 0 ($9800) or 1 ($9C00);
+    // turns the cache on
+    void GetTileMapImage(int map, bool unsigned_tiles, uint8_t* out);
+    
     // === Save/Load Battery-Backed RAM ===
     bool LoadSave(const std::string& path);
     bool SaveRAM(const std::string& path) const;
@@ -107,6 +129,41 @@ public:
     // Set Mooneye test result callback (passes to CPU)
     void SetMooneyeCallback(std::function<void(bool)> callback);
     
+    // === Save States (see state/StateBuffer.hpp) ===
+    // Whole-machine snapshot for the loaded ROM. Hooks, callbacks and
+    // connected audio/export outputs are not part of the state. Only call
+    // between instructions (outside Step, or from a frame hook).
+    // A failed load leaves the machine as it was.
+    // `sections` (optional) receives where each component landed in `out`.
+    struct StateSection {
+        const char* name;
+        size_t offset;
+        size_t size;
+    };
+    bool SaveState(std::vector<uint8_t>& out, std::vector<StateSection>* sections = nullptr);
+    bool LoadState(const std::vector<uint8_t>& data);
+    
+    // === Memory Footprint (see TECHNICAL.md, Headless Footprint) ===
+    // Bytes held by each part of this instance. `shared` entries (the ROM
+    // image) are shared with every instance that loaded the same file.
+    // A lean headless instance (no audio buffer, exporter or hooks) stays
+    // within FOOTPRINT_BUDGET, not counting "cartridge ram" and shared entries.
+    static constexpr size_t FOOTPRINT_BUDGET = 48 * 1024;
+    struct FootprintEntry {
+        const char* name;
+        size_t bytes;
+        bool shared;
+    };
+    std::vector<FootprintEntry> GetFootprint() const;
+    
+    // === Scripting Hooks (see script/ScriptHooks.hpp) ===
+    // Hooks cost nothing on the hot paths until one of their kind exists.
+    // Returns an id for RemoveHook (0 if the hook was empty).
+    uint32_t AddFrameHook(std::function<void()> hook);
+    uint32_t AddWriteHook(uint16_t first, uint16_t last, std::function<void(uint16_t, uint8_t)> hook);
+    uint32_t AddExecHook(uint16_t addr, std::function<void(uint16_t)> hook);
+    bool RemoveHook(uint32_t id);
+    
 private:
     // === Hardware Components (like chips on the motherboard) ===
     std::unique_ptr<CPU> cpu;
@@ -125,9 +182,23 @@ private:
     // === Clock Counter (directly exposed master clock) ===
     uint64_t total_cycles;
     
+    // === Scripting Hooks ===
+    std::unique_ptr<ScriptHooks> hooks;  // Created by the first Add*Hook
+    bool write_hooks_enabled = false;   // Mirrors hooks->HasWriteHooks() for the bus path
+    bool frame_hooks_enabled = false;
+    uint32_t hooked_frame = 0;          // PPU frame count frame hooks last ran for
+    
+    ScriptHooks& GetHooks();
+    void UpdateHookWiring();
+    
     // === Internal Wiring (connecting components like PCB traces) ===
     void WireComponents();
     
+    // Batched CPU execution (CPU::Run), returning after a frame completes
+    // so frame hooks run between instructions like they do for Step
+    uint32_t RunCycles(uint32_t budget);
+    void DispatchFrameHooks();
+    
     // Called after each T-cycle block to synchronize components
     void TickComponents(uint8_t cycles);
     
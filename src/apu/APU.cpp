@@ -1,5 +1,7 @@
 #include "APU.hpp"
 #include "AudioBuffer.hpp"
+#include "APUWorker.hpp"
+#include "../state/StateBuffer.hpp"
 #include <cmath>
 #include <cstdio>
 #include <iostream>
@@ -7,11 +9,90 @@
 constexpr uint8_t APU::DUTY_TABLE[4];
 constexpr uint8_t APU::DIVISORS[8];
 
+// === Noise LFSR Tables ===
+// The 15-bit LFSR (taps 0/1, feedback into bit 14) is maximal: every
+// non-zero state lies on one 32767-step cycle, so "state after N clocks"
+// is an index lookup. In 7-bit mode feedback also lands in bit 6; once
+// 8 clocks have passed since the last mode switch, bits 14-8 mirror bits
+// 6-0 and bit 7 is the previous bit 0, so the whole register is a function
+// of the low 7 bits and follows a 127-step cycle.
+
+static uint16_t ClockLFSR(uint16_t lfsr, bool width_mode) {
+    uint8_t xor_bit = (lfsr & 1) ^ ((lfsr >> 1) & 1);
+    lfsr = (lfsr >> 1) | (xor_bit << 14);
+    if (width_mode) {
+        lfsr &= ~(1 << 6);
+        lfsr |= xor_bit << 6;
+    }
+    return lfsr;
+}
+
+struct LFSRTables {
+    static constexpr uint16_t PERIOD15 = 32767;
+    static constexpr uint8_t PERIOD7 = 127;
+    static constexpr uint16_t NO_INDEX = 0xFFFF;
+    
+    std::array<uint16_t, PERIOD15> sequence15;  // State at step i from $7FFF
+    std::array<uint16_t, 0x8000> index15;       // State -> step (NO_INDEX for 0)
+    std::array<uint16_t, PERIOD7> sequence7;    // Settled 7-bit mode states
+    std::array<uint8_t, 0x80> index7;           // Low 7 bits -> step
+    
+    LFSRTables() {
+        index15.fill(NO_INDEX);
+        uint16_t lfsr = 0x7FFF;
+        for (uint16_t i = 0; i < PERIOD15; i++) {
+            sequence15[i] = lfsr;
+            index15[lfsr] = i;
+            lfsr = ClockLFSR(lfsr, false);
+        }
+        
+        // Let the upper bits settle, then record one full 7-bit cycle
+        lfsr = 0x7FFF;
+        for (int i = 0; i < 8; i++) lfsr = ClockLFSR(lfsr, true);
+        index7.fill(0);
+        for (uint8_t i = 0; i < PERIOD7; i++) {
+            sequence7[i] = lfsr;
+            index7[lfsr & 0x7F] = i;
+            lfsr = ClockLFSR(lfsr, true);
+        }
+    }
+};
+
+static const LFSRTables lfsr_tables;
+
+// State of the noise LFSR after `clocks` clocks, in O(1) except for the
+// first few clocks after a 15->7-bit mode switch
+static uint16_t AdvanceLFSR(uint16_t lfsr, bool width_mode, uint32_t clocks) {
+    if (!width_mode) {
+        uint16_t index = lfsr_tables.index15[lfsr & 0x7FFF];
+        if (index == LFSRTables::NO_INDEX) return lfsr;  // All-zero lock-up
+        return lfsr_tables.sequence15[(index + clocks) % LFSRTables::PERIOD15];
+    }
+    
+    while (clocks && lfsr) {
+        uint8_t index = lfsr_tables.index7[lfsr & 0x7F];
+        if ((lfsr & 0x7F) && lfsr_tables.sequence7[index] == lfsr) {
+            return lfsr_tables.sequence7[(index + clocks) % LFSRTables::PERIOD7];
+        }
+        // Upper bits not settled yet (or locked up) - clock one at a time
+        lfsr = ClockLFSR(lfsr, true);
+        clocks--;
+    }
+    return lfsr;
+}
+
 APU::APU() {
     Reset();
 }
 
+APU::~APU() = default;
+
 void APU::Reset() {
+    if (worker) {
+        FlushStepRun();
+        Record({APUEvent::RESET, 0, 0, false, 0});
+    }
+    
     ch1 = {};
     ch2 = {};
     ch3 = {};
@@ -38,6 +119,18 @@ void APU::Reset() {
 void APU::Step(uint8_t cycles) {
     if (!power_on) return;
     
+    // Threaded synthesis: only channel 3 timing is visible to the CPU
+    // (wave RAM access window, retrigger corruption); the worker does the rest
+    if (worker) {
+        StepChannel3(cycles);
+        if (step_run_count && step_run_cycles != cycles) {
+            FlushStepRun();
+        }
+        step_run_cycles = cycles;
+        step_run_count++;
+        return;
+    }
+    
     // Step each channel
     StepChannel1(cycles);
     StepChannel2(cycles);
@@ -63,6 +156,11 @@ void APU::Step(uint8_t cycles) {
 }
 
 void APU::ClockFrameSequencer() {
+    if (worker) {
+        FlushStepRun();
+        Record({APUEvent::FRAME_SEQUENCER, 0, 0, false, 0});
+    }
+    
     // Per SameBoy skip_div_event: when APU powers on with DIV bit high,
     // skip the first falling edge event
     if (skip_first_div_event) {
@@ -151,18 +249,13 @@ void APU::StepChannel4(uint8_t cycles) {
     if (!ch4.enabled) return;
     
     ch4.frequency_timer -= cycles;
-    while (ch4.frequency_timer <= 0) {
-        ch4.frequency_timer += DIVISORS[ch4.divisor_code] << ch4.clock_shift;
-        
-        // Clock LFSR
-        uint8_t xor_bit = (ch4.lfsr & 1) ^ ((ch4.lfsr >> 1) & 1);
-        ch4.lfsr = (ch4.lfsr >> 1) | (xor_bit << 14);
-        
-        if (ch4.width_mode) {
-            ch4.lfsr &= ~(1 << 6);
-            ch4.lfsr |= xor_bit << 6;
-        }
-    }
+    if (ch4.frequency_timer > 0) return;
+    
+    // Closed form of "while (timer <= 0) { timer += period; clock LFSR; }"
+    int32_t period = DIVISORS[ch4.divisor_code] << ch4.clock_shift;
+    uint32_t clocks = 1 + static_cast<uint32_t>(-ch4.frequency_timer) / period;
+    ch4.frequency_timer += static_cast<int32_t>(clocks * period);
+    ch4.lfsr = AdvanceLFSR(ch4.lfsr, ch4.width_mode, clocks);
 }
 
 void APU::ClockLength() {
@@ -449,6 +542,11 @@ uint8_t APU::ReadRegister(uint16_t addr) const {
 }
 
 void APU::WriteRegister(uint16_t addr, uint8_t value) {
+    if (worker) {
+        FlushStepRun();
+        Record({APUEvent::WRITE_REGISTER, static_cast<uint8_t>(addr & 0xFF), value, div_bit12_high, 0});
+    }
+    
     // Per SameBoy lines 1257-1266: on DMG, NRx1 writes are allowed when powered off
     // (allows setting length counters)
     bool is_length_reg = (addr == 0xFF11 || addr == 0xFF16 || addr == 0xFF1B || addr == 0xFF20);
@@ -727,8 +825,94 @@ void APU::WriteWaveRAM(uint8_t index, uint8_t value) {
             return;  // Write ignored outside access window
         }
         // During window, write to current playback position
-        wave_ram[ch3.position / 2] = value;
-        return;
+        index = ch3.position / 2;
     }
     wave_ram[index] = value;
+    
+    // Worker gets the resolved store - its wave window flag isn't tracked
+    if (worker) {
+        FlushStepRun();
+        Record({APUEvent::WRITE_WAVE, index, value, false, 0});
+    }
+}
+
+// === Synthesis Worker ===
+
+void APU::SetAudioBuffer(AudioBuffer* buffer) {
+    if (worker) {
+        // Take back the synthesis state so inline stepping (or a new
+        // worker) continues exactly where the old worker stopped
+        SyncSynthesis();
+        CopyStateFrom(worker->GetSynth());
+        worker.reset();
+    }
+    
+    audio_buffer = buffer;
+    if (buffer) {
+        worker = std::make_unique<APUWorker>(*this, buffer);
+    }
+}
+
+void APU::SyncSynthesis() {
+    if (!worker) return;
+    FlushStepRun();
+    worker->Sync();
+}
+
+size_t APU::GetWorkerFootprint() const {
+    return worker ? sizeof(APUWorker) + sizeof(APU) : 0;
+}
+
+void APU::Record(const APUEvent& event) {
+    worker->Record(event);
+}
+
+void APU::FlushStepRun() {
+    if (!step_run_count) return;
+    Record({APUEvent::STEP, step_run_cycles, 0, false, step_run_count});
+    step_run_count = 0;
+}
+
+void APU::CopyStateFrom(const APU& other) {
+    ch1 = other.ch1;
+    ch2 = other.ch2;
+    ch3 = other.ch3;
+    ch4 = other.ch4;
+    power_on = other.power_on;
+    nr50 = other.nr50;
+    channel_left = other.channel_left;
+    channel_right = other.channel_right;
+    io_registers = other.io_registers;
+    wave_ram = other.wave_ram;
+    frame_sequencer_step = other.frame_sequencer_step;
+    skip_first_div_event = other.skip_first_div_event;
+    div_bit12_high = other.div_bit12_high;
+    left_sample = other.left_sample;
+    right_sample = other.right_sample;
+    sample_ready = other.sample_ready;
+    sample_counter = other.sample_counter;
+}
+
+// === Save State ===
+
+template <typename Self, typename Archive>
+void APU::Serialize(Self& self, Archive& archive) {
+    archive(self.ch1, self.ch2, self.ch3, self.ch4);
+    archive(self.power_on, self.nr50, self.channel_left, self.channel_right);
+    archive(self.io_registers, self.wave_ram);
+    archive(self.frame_sequencer_step, self.skip_first_div_event, self.div_bit12_high);
+    archive(self.left_sample, self.right_sample, self.sample_ready, self.sample_counter);
+}
+
+void APU::SaveState(StateWriter& state) const {
+    Serialize(worker ? worker->GetSynth() : *this, state);
+}
+
+void APU::LoadState(StateReader& state) {
+    // Let the worker finish the old timeline before both APUs jump
+    SyncSynthesis();
+    Serialize(*this, state);
+    if (worker) {
+        worker->GetSynth().CopyStateFrom(*this);
+    }
 }
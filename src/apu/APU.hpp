@@ -2,8 +2,14 @@
 
 #include <cstdint>
 #include <array>
+#include <memory>
+#include "../host/ArenaAllocated.hpp"
 
 class AudioBuffer;
+class APUWorker;
+struct APUEvent;
+class StateWriter;
+class StateReader;
 
 /**
  * APU - Audio Processing Unit
@@ -18,10 +24,18 @@ class AudioBuffer;
  * - Register access at $FF10-$FF3F
  * - DIV bit input (fed from Timer for frame sequencer)
  * - Audio output samples
+ * 
+ * Threaded Synthesis:
+ * - Connecting an AudioBuffer starts an APUWorker thread
+ * - This instance then only runs what the CPU can observe (channel 3
+ *   wave window, length/sweep/DAC status) and logs its inputs
+ * - The worker replays the log into its own APU to mix samples, so
+ *   GetSample()/HasSample() are only meaningful without a buffer
  */
-class APU {
+class APU : public ArenaAllocated {
 public:
     APU();
+    ~APU();
     
     void Reset();
     
@@ -52,9 +66,26 @@ public:
     void ClearSampleReady() { sample_ready = false; }
     
     // === Audio Buffer Connection ===
-    void SetAudioBuffer(AudioBuffer* buffer) { audio_buffer = buffer; }
+    // Non-null starts the synthesis worker, nullptr stops it and
+    // resumes inline synthesis from the worker's final state
+    void SetAudioBuffer(AudioBuffer* buffer);
+    
+    // Block until the worker has synthesized everything logged so far
+    // (no-op for inline synthesis)
+    void SyncSynthesis();
+    
+    // Bytes held by the synthesis worker (its APU and event log), 0 inline
+    size_t GetWorkerFootprint() const;
+    
+    // === Save State (see StateBuffer.hpp) ===
+    // With a worker running, call SyncSynthesis() before SaveState();
+    // the full channel state lives in the synthesis APU
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
     
 private:
+    friend class APUWorker;
+    
     // === Channel 1: Pulse with Sweep ===
     struct Channel1 {
         // Registers (directly exposed NR10-NR14)
@@ -161,6 +192,18 @@ private:
     uint32_t sample_counter;        // Fractional counter for accurate 48kHz downsampling
     AudioBuffer* audio_buffer = nullptr;  // External buffer for SDL audio
     
+    // === Synthesis Worker (emulation thread side) ===
+    std::unique_ptr<APUWorker> worker;
+    uint8_t step_run_cycles = 0;    // Pending run of identical Step() calls,
+    uint32_t step_run_count = 0;    // flushed before any other event
+    
+    void Record(const APUEvent& event);
+    void FlushStepRun();
+    void CopyStateFrom(const APU& other);
+    
+    template <typename Self, typename Archive>
+    static void Serialize(Self& self, Archive& archive);
+    
     // === Internal Operations (directly expose the channel logic) ===
     void StepChannel1(uint8_t cycles);
     void StepChannel2(uint8_t cycles);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * APUEvent - One entry of the APU register-write log
+ *
+ * Everything that can change APU state from the outside, in the order the
+ * emulation thread saw it. Replaying the same events into a second APU
+ * reproduces its state (and therefore its samples) exactly.
+ *
+ * - STEP: `count` consecutive Step(`cycles`) calls (run-length encoded)
+ * - FRAME_SEQUENCER: one DIV bit 12 falling edge
+ * - WRITE_REGISTER: NR10-NR52 write of `value` to $FF00+`addr`,
+ *   with the DIV bit 12 level sampled at the time of the write
+ * - WRITE_WAVE: resolved wave RAM store (index already redirected or
+ *   dropped by the channel 3 access window on the emulation thread)
+ * - RESET: APU::Reset()
+ */
+struct APUEvent {
+    enum Type : uint8_t {
+        STEP,
+        FRAME_SEQUENCER,
+        WRITE_REGISTER,
+        WRITE_WAVE,
+        RESET
+    };
+
+    Type type;
+    uint8_t addr;           // Register low byte / wave RAM index / step cycles
+    uint8_t value;
+    bool div_bit12_high;
+    uint32_t count;         // STEP run length
+};
+
+/**
+ * APUEventLog - Lock-free Ring Buffer for APU Events
+ *
+ * Single-producer single-consumer queue between the emulation thread
+ * (records events) and the APU synthesis worker (replays them).
+ * Same layout as AudioBuffer, but the producer never drops: a full log
+ * means the worker is behind, and Push() reports it so the caller can wait.
+ */
+class APUEventLog {
+public:
+    // ~2 frames of worst-case register traffic (power of 2 for fast modulo)
+    static constexpr size_t CAPACITY = 16384;
+
+    APUEventLog() : write_pos(0), read_pos(0) {}
+
+    /**
+     * Append an event. Called from emulation thread.
+     * Returns false if the log is full.
+     */
+    bool Push(const APUEvent& event) {
+        size_t write = write_pos.load(std::memory_order_relaxed);
+        size_t next_write = (write + 1) & (CAPACITY - 1);
+
+        if (next_write == read_pos.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        events[write] = event;
+        write_pos.store(next_write, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Take the oldest event. Called from worker thread.
+     * Returns false if the log is empty.
+     */
+    bool Pop(APUEvent& event) {
+        size_t read = read_pos.load(std::memory_order_relaxed);
+
+        if (read == write_pos.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        event = events[read];
+        read_pos.store((read + 1) & (CAPACITY - 1), std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<APUEvent, CAPACITY> events;
+    std::atomic<size_t> write_pos;
+    std::atomic<size_t> read_pos;
+};
@@ -0,0 +1,72 @@
+#include "APUWorker.hpp"
+#include "APU.hpp"
+#include <chrono>
+
+APUWorker::APUWorker(const APU& initial_state, AudioBuffer* buffer)
+    : synth(std::make_unique<APU>())
+    , running(true)
+    , events_replayed(0)
+{
+    synth->CopyStateFrom(initial_state);
+    synth->audio_buffer = buffer;
+    thread = std::thread(&APUWorker::Run, this);
+}
+
+APUWorker::~APUWorker() {
+    running.store(false, std::memory_order_release);
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void APUWorker::Record(const APUEvent& event) {
+    // Log full means synthesis is more than a couple of frames behind;
+    // wait for it rather than dropping state changes
+    while (!log.Push(event)) {
+        std::this_thread::yield();
+    }
+    events_recorded++;
+}
+
+void APUWorker::Sync() {
+    while (events_replayed.load(std::memory_order_acquire) != events_recorded) {
+        std::this_thread::yield();
+    }
+}
+
+void APUWorker::Run() {
+    APUEvent event;
+    while (running.load(std::memory_order_acquire)) {
+        if (!log.Pop(event)) {
+            // Nothing logged yet - the emulation thread flushes at least
+            // every frame sequencer tick (~2ms), so a short nap is enough
+            std::this_thread::sleep_for(std::chrono::microseconds(250));
+            continue;
+        }
+        Replay(event);
+        events_replayed.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void APUWorker::Replay(const APUEvent& event) {
+    switch (event.type) {
+        case APUEvent::STEP:
+            for (uint32_t i = 0; i < event.count; i++) {
+                synth->Step(event.addr);
+            }
+            break;
+        case APUEvent::FRAME_SEQUENCER:
+            synth->ClockFrameSequencer();
+            break;
+        case APUEvent::WRITE_REGISTER:
+            synth->SetDivBit12High(event.div_bit12_high);
+            synth->WriteRegister(0xFF00 | event.addr, event.value);
+            break;
+        case APUEvent::WRITE_WAVE:
+            synth->wave_ram[event.addr] = event.value;
+            break;
+        case APUEvent::RESET:
+            synth->Reset();
+            break;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "APUEventLog.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+class APU;
+class AudioBuffer;
+
+/**
+ * APUWorker - Audio Synthesis Thread
+ *
+ * Owns a second APU instance that only exists to produce samples.
+ * The emulation-thread APU keeps everything the CPU can observe
+ * (NR52 status bits, length counters, channel 3 wave RAM window) and
+ * records its inputs into an APUEventLog; this worker replays that log
+ * into its own APU, which does the pulse/noise stepping, mixing and
+ * AudioBuffer pushes.
+ *
+ * Both APUs start from the same state and see the same Step() call
+ * sequence, so the synthesized samples are identical to what a single
+ * inline APU would have produced.
+ *
+ * Interface:
+ * - Record(): append an event (emulation thread)
+ * - Sync(): wait until every recorded event has been replayed
+ * - GetSynth(): synthesis APU, only safe to touch after Sync() (and
+ *   before the next Record(), which publishes any changes to the worker)
+ */
+class APUWorker {
+public:
+    APUWorker(const APU& initial_state, AudioBuffer* buffer);
+    ~APUWorker();
+
+    APUWorker(const APUWorker&) = delete;
+    APUWorker& operator=(const APUWorker&) = delete;
+
+    void Record(const APUEvent& event);
+    void Sync();
+
+    const APU& GetSynth() const { return *synth; }
+    APU& GetSynth() { return *synth; }
+
+private:
+    std::unique_ptr<APU> synth;
+    APUEventLog log;
+    std::thread thread;
+    std::atomic<bool> running;
+
+    uint64_t events_recorded = 0;               // Emulation thread only
+    std::atomic<uint64_t> events_replayed;      // Published by worker after replay
+
+    void Run();
+    void Replay(const APUEvent& event);
+};
@@ -70,6 +70,26 @@ public:
         read_pos.store(read, std::memory_order_release);
     }
     
+    /**
+     * Pop up to max_samples into an interleaved float buffer without
+     * padding. Returns the number of stereo samples actually read.
+     */
+    size_t Read(float* output, size_t max_samples) {
+        size_t read = read_pos.load(std::memory_order_relaxed);
+        size_t write = write_pos.load(std::memory_order_acquire);
+        size_t count = 0;
+
+        while (count < max_samples && read != write) {
+            output[count * 2]     = buffer[read].left;
+            output[count * 2 + 1] = buffer[read].right;
+            read = (read + 1) & (CAPACITY - 1);
+            count++;
+        }
+
+        read_pos.store(read, std::memory_order_release);
+        return count;
+    }
+
     /**
      * Get the number of samples available for reading.
      */
@@ -0,0 +1,179 @@
+#include "TimeStretch.hpp"
+#include "AudioBuffer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Consecutive starved blocks before giving up and fading to silence
+// (the emulator is paused, not just late)
+static constexpr int MAX_STARVED_BLOCKS = 8;
+
+TimeStretch::TimeStretch() : target_fill(DEFAULT_TARGET_FILL), speed(1.0f) {
+    for (size_t i = 0; i < HOP; i++) {
+        fade_in[i] = 0.5f - 0.5f * std::cos(3.14159265358979f * (i + 0.5f) / HOP);
+    }
+    Reset();
+}
+
+void TimeStretch::Reset() {
+    input_size = 0;
+    primed = false;
+    continuation = 0;
+    analysis_pos = 0.0;
+    starved_blocks = 0;
+    block.fill(0.0f);
+    block_pos = HOP;
+}
+
+void TimeStretch::Process(AudioBuffer& source, float* output, size_t sample_count) {
+    size_t written = 0;
+
+    while (written < sample_count) {
+        if (block_pos == HOP) {
+            Fill(source);
+
+            // Samples queued but not yet played, in input time
+            size_t consumed = std::min(static_cast<size_t>(analysis_pos), input_size);
+            size_t backlog = source.Available() + input_size - consumed;
+            float target = static_cast<float>(target_fill);
+            float correction = 1.0f + 0.5f * (static_cast<float>(backlog) - target) / target;
+            float ratio = std::max(MIN_RATIO, std::min(MAX_RATIO, GetSpeed() * correction));
+
+            if (!SynthesizeBlock(ratio)) {
+                block.fill(0.0f);
+            }
+            block_pos = 0;
+        }
+
+        size_t count = std::min(HOP - block_pos, sample_count - written);
+        std::memcpy(output + written * 2, block.data() + block_pos * 2, count * 2 * sizeof(float));
+        block_pos += count;
+        written += count;
+    }
+}
+
+void TimeStretch::Fill(AudioBuffer& source) {
+    size_t read = source.Read(input.data() + input_size * 2, INPUT_CAPACITY - input_size);
+    for (size_t i = input_size; i < input_size + read; i++) {
+        mono[i] = input[i * 2] + input[i * 2 + 1];
+    }
+    input_size += read;
+}
+
+void TimeStretch::Discard(size_t count) {
+    size_t remaining = input_size - count;
+    std::memmove(input.data(), input.data() + count * 2, remaining * 2 * sizeof(float));
+    std::memmove(mono.data(), mono.data() + count, remaining * sizeof(float));
+    input_size = remaining;
+    continuation -= count;
+    analysis_pos -= count;
+}
+
+bool TimeStretch::SynthesizeBlock(float ratio) {
+    if (!primed) {
+        // Wait for enough input to search around the first segment
+        if (input_size < SEARCH + 2 * HOP) return false;
+        continuation = SEARCH;
+        analysis_pos = SEARCH;
+        starved_blocks = 0;
+        primed = true;
+    }
+
+    // Too little left after a Discard() for even one segment plus its
+    // continuation: nothing valid to repeat, so start over once input returns
+    if (input_size < 2 * HOP) {
+        Reset();
+        return false;
+    }
+
+    // Candidates must leave HOP samples after the segment for the next
+    // block's continuation, so a starved stretcher can keep repeating
+    // already-buffered audio instead of running off the end
+    size_t latest = input_size - 2 * HOP;
+    size_t nominal = static_cast<size_t>(analysis_pos);
+    if (nominal > latest) {
+        if (++starved_blocks > MAX_STARVED_BLOCKS) {
+            Reset();
+            return false;
+        }
+        nominal = latest;
+        analysis_pos = latest;
+    } else {
+        starved_blocks = 0;
+    }
+
+    size_t lo = nominal > SEARCH ? nominal - SEARCH : 0;
+    size_t hi = std::min(nominal + SEARCH, latest);
+    size_t best = FindBestSegment(continuation, lo, hi);
+
+    // Crossfade the previous segment's natural continuation into the new one
+    const float* from = input.data() + continuation * 2;
+    const float* to = input.data() + best * 2;
+    for (size_t i = 0; i < HOP; i++) {
+        float w = fade_in[i];
+        block[i * 2]     = from[i * 2]     + (to[i * 2]     - from[i * 2])     * w;
+        block[i * 2 + 1] = from[i * 2 + 1] + (to[i * 2 + 1] - from[i * 2 + 1]) * w;
+    }
+
+    continuation = best + HOP;
+    analysis_pos += HOP * ratio;
+
+    // Keep SEARCH samples of history behind the next nominal position
+    size_t next_lo = static_cast<size_t>(analysis_pos);
+    next_lo = next_lo > SEARCH ? next_lo - SEARCH : 0;
+    size_t keep_from = std::min(continuation, next_lo);
+    if (keep_from >= INPUT_CAPACITY / 4) {
+        Discard(keep_from);
+    }
+
+    return true;
+}
+
+size_t TimeStretch::FindBestSegment(size_t target, size_t lo, size_t hi) const {
+    // Coarse pass every 4 samples, then refine around the winner
+    size_t best = lo;
+    float best_score = -INFINITY;
+    for (size_t c = lo; c <= hi; c += 4) {
+        float score = Similarity(target, c);
+        if (score > best_score) {
+            best_score = score;
+            best = c;
+        }
+    }
+
+    size_t refine_lo = best > lo + 3 ? best - 3 : lo;
+    size_t refine_hi = std::min(best + 3, hi);
+    for (size_t c = refine_lo; c <= refine_hi; c++) {
+        float score = Similarity(target, c);
+        if (score > best_score) {
+            best_score = score;
+            best = c;
+        }
+    }
+    return best;
+}
+
+float TimeStretch::Similarity(size_t target, size_t candidate) const {
+    // Normalized cross-correlation over one HOP of the mono mix.
+    // Eight independent lanes so the compiler can vectorize the reduction
+    // without reassociating a single float sum.
+    constexpr size_t LANES = 8;
+    float dot[LANES] = {};
+    float energy[LANES] = {};
+    const float* t = mono.data() + target;
+    const float* c = mono.data() + candidate;
+
+    for (size_t i = 0; i < HOP; i += LANES) {
+        for (size_t l = 0; l < LANES; l++) {
+            dot[l] += t[i + l] * c[i + l];
+            energy[l] += c[i + l] * c[i + l];
+        }
+    }
+
+    float dot_sum = 0.0f, energy_sum = 0.0f;
+    for (size_t l = 0; l < LANES; l++) {
+        dot_sum += dot[l];
+        energy_sum += energy[l];
+    }
+    return dot_sum / std::sqrt(energy_sum + 1e-6f);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+class AudioBuffer;
+
+/**
+ * TimeStretch - WSOLA Time-Stretcher for the Audio Device
+ *
+ * Sits between AudioBuffer and the SDL audio callback and runs entirely
+ * on the audio thread. Consumes APU samples faster or slower than 48kHz
+ * without changing pitch, so fast-forward stays intelligible and brief
+ * emulation stalls stretch the audio instead of crackling.
+ *
+ * Algorithm (Waveform Similarity Overlap-Add):
+ * - Output is produced in HOP-sample blocks, each a raised-cosine
+ *   crossfade from the natural continuation of the previous segment
+ *   into a new segment taken ~HOP * ratio samples further into the input
+ * - The new segment start is searched within +/-SEARCH samples for the
+ *   best normalized correlation with that continuation (coarse pass, then
+ *   per-sample refinement), which keeps the waveform phase-coherent
+ *
+ * Ratio:
+ * - SetSpeed(): emulation speed multiplier from the frontend (1.0 = realtime)
+ * - Scaled by AudioBuffer fill level so the buffer hovers around
+ *   the target fill regardless of small pacing errors
+ */
+class TimeStretch {
+public:
+    static constexpr size_t HOP = 480;          // 10ms output block
+    static constexpr size_t SEARCH = 240;       // +/-5ms similarity search
+    static constexpr size_t DEFAULT_TARGET_FILL = 2048;  // Desired AudioBuffer backlog
+    static constexpr float MIN_RATIO = 0.5f;
+    static constexpr float MAX_RATIO = 4.0f;
+
+    TimeStretch();
+
+    // Emulation speed multiplier, written by the emulation/UI thread
+    void SetSpeed(float multiplier) { speed.store(multiplier, std::memory_order_relaxed); }
+    float GetSpeed() const { return speed.load(std::memory_order_relaxed); }
+
+    // Backlog to steer towards; lower = less latency, more stretching.
+    // Set before the first Process() call.
+    void SetTargetFill(size_t samples) { target_fill = samples; }
+
+    // Fill `sample_count` interleaved stereo samples (audio thread)
+    void Process(AudioBuffer& source, float* output, size_t sample_count);
+
+    // Drop buffered input and start over (e.g. after a long pause)
+    void Reset();
+
+private:
+    // Input history, interleaved stereo plus a mono mix for correlation.
+    // Large enough for a MAX_RATIO hop plus search margins with room to spare.
+    static constexpr size_t INPUT_CAPACITY = 16384;
+    std::array<float, INPUT_CAPACITY * 2> input;
+    std::array<float, INPUT_CAPACITY> mono;
+    size_t input_size;              // Valid samples in input/mono
+
+    // Synthesis state
+    bool primed;                    // continuation is valid
+    size_t continuation;            // Input index right after the last segment
+    double analysis_pos;            // Nominal (fractional) next segment start
+    int starved_blocks;             // Consecutive blocks clamped by missing input
+
+    // Current output block
+    std::array<float, HOP * 2> block;
+    size_t block_pos;               // Next unread sample in block (HOP = empty)
+
+    std::array<float, HOP> fade_in; // Raised-cosine crossfade window
+
+    size_t target_fill;
+    std::atomic<float> speed;
+
+    void Fill(AudioBuffer& source);
+    void Discard(size_t count);
+    bool SynthesizeBlock(float ratio);
+    size_t FindBestSegment(size_t target, size_t lo, size_t hi) const;
+    float Similarity(size_t target, size_t candidate) const;
+};
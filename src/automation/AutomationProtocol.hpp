@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * AutomationProtocol - Binary Control Protocol for --automation <socket>
+ *
+ * Wire format of the Unix stream socket served by AutomationServer.
+ * Self-contained (no emulator headers) so clients can include it directly;
+ * see tools/automation_client.cpp. All integers are little-endian.
+ *
+ * A client sends batches and gets one response per batch:
+ *   Request:  u32 size | commands (size bytes)
+ *   Response: u32 size | u32 executed | u8 status | payloads (size - 5 bytes)
+ *
+ * Commands run in order at a frame boundary. The first failing command
+ * stops the batch: `executed` is its index and `status` its error; the
+ * payloads of the commands before it are still returned. A whole step of
+ * an agent loop (buttons, run, read RAM, grab the screen) fits in one
+ * batch, so it costs one round trip. GET_OBSERVATION returns the screen
+ * cropped, downsampled, packed or grayscaled and stacked in the emulator
+ * process (5.7 KB packed instead of 23 KB), as set by SET_OBSERVATION;
+ * each call adds the current screen to the stack, the first one after
+ * SET_OBSERVATION fills every slot with it.
+ *
+ * While a client is connected it owns the clock: the emulator only
+ * advances through RUN_FRAMES (a GUI instance keeps its window live but
+ * stops running frames and reading the keyboard). One client at a time;
+ * others wait in the listen backlog.
+ */
+
+struct AutomationProtocol {
+    static constexpr uint16_t VERSION = 1;
+    static constexpr uint32_t MAX_BATCH = 4 * 1024 * 1024;
+    static constexpr uint32_t STATE_SLOTS = 16;
+    static constexpr uint32_t FRAME_BYTES = 160 * 144;
+
+    enum Command : uint8_t {
+        SET_BUTTONS = 0x01,     // u8 mask (bit = SetButton index: A, B, Select, Start, Right, Left, Up, Down)
+        RUN_FRAMES = 0x02,      // u32 count
+        READ_MEMORY = 0x03,     // u16 addr, u16 length          -> length bytes
+        WRITE_MEMORY = 0x04,    // u16 addr, u16 length, bytes
+        GET_FRAMEBUFFER = 0x05, //                               -> FRAME_BYTES color indices (0-3)
+        SAVE_STATE = 0x06,      //                               -> u32 size, state
+        LOAD_STATE = 0x07,      // u32 size, state
+        SAVE_SLOT = 0x08,       // u8 slot (kept in the server, nothing sent)
+        LOAD_SLOT = 0x09,       // u8 slot
+        GET_STATUS = 0x0A,      //                               -> u16 version, u64 cycles, u32 frames, u16 PC, u8 halted
+        QUIT = 0x0B,            // Stop the instance after this batch
+        SET_OBSERVATION = 0x0C, // u8 format (0 indices, 1 packed 2bpp, 2 gray), u8 crop x, y, width, height,
+                                // u8 downsample, u8 stack (see export/ObservationEncoder.hpp)
+        GET_OBSERVATION = 0x0D, //                               -> stacked frames, oldest first
+    };
+
+    enum Status : uint8_t {
+        OK = 0,
+        UNKNOWN_COMMAND = 1,
+        TRUNCATED = 2,          // Arguments run past the end of the batch
+        BAD_RANGE = 3,          // Memory range past $FFFF
+        STATE_REJECTED = 4,     // Emulator::LoadState refused it (other ROM, damaged)
+        EMPTY_SLOT = 5,         // Slot out of range or never saved
+        BATCH_TOO_LARGE = 6,    // size > MAX_BATCH; the server disconnects
+        BAD_OBSERVATION = 7,    // Crop off screen, downsample doesn't divide it, stack 0 or > 16
+    };
+};
@@ -0,0 +1,321 @@
+#include "AutomationServer.hpp"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0   // No SIGPIPE suppression per call; the host ignores it or dies
+#endif
+
+using Protocol = AutomationProtocol;
+
+static constexpr size_t RECEIVE_CHUNK = 64 * 1024;
+static constexpr size_t RESPONSE_HEADER = 9;   // u32 size, u32 executed, u8 status
+
+static uint16_t Read16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t Read32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static void Write32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) p[i] = static_cast<uint8_t>(value >> (i * 8));
+}
+
+static void Append(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+AutomationServer::~AutomationServer() {
+    Close();
+}
+
+bool AutomationServer::Open(const std::string& path) {
+    Close();
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Automation socket path too long: " << path << "\n";
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    // Replace a socket left behind by a killed instance, but nothing else
+    struct stat info;
+    if (lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            std::cerr << "Automation socket path exists and is not a socket: " << path << "\n";
+            return false;
+        }
+        unlink(path.c_str());
+    }
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        std::cerr << "socket failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd, 4) < 0) {
+        std::cerr << "Automation socket failed: " << path << ": " << std::strerror(errno) << "\n";
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    socket_path = path;
+    quit_requested = false;
+    std::cout << "Automation socket: " << socket_path << "\n";
+    return true;
+}
+
+void AutomationServer::Close() {
+    if (listen_fd < 0) return;
+
+    Disconnect();
+    close(listen_fd);
+    unlink(socket_path.c_str());
+    listen_fd = -1;
+}
+
+// === Connection ===
+
+bool AutomationServer::Poll(Emulator& emu, int timeout_ms) {
+    if (listen_fd < 0) return false;
+
+    // Waiting clients are only accepted once the current one has gone
+    pollfd entry = {};
+    entry.fd = client_fd >= 0 ? client_fd : listen_fd;
+    entry.events = POLLIN;
+    if (poll(&entry, 1, timeout_ms) <= 0) return HasClient();
+
+    if (client_fd < 0) {
+        Accept();
+        return HasClient();
+    }
+
+    if (!Receive() || !RunBatches(emu)) Disconnect();
+    return HasClient();
+}
+
+void AutomationServer::Accept() {
+    client_fd = accept(listen_fd, nullptr, nullptr);
+    if (client_fd < 0) return;
+
+    input_used = 0;
+    observation.Configure(ObservationEncoder::Config());
+    observation_reset = true;
+    std::cout << "Automation client connected\n";
+}
+
+void AutomationServer::Disconnect() {
+    if (client_fd < 0) return;
+
+    close(client_fd);
+    client_fd = -1;
+    input_used = 0;
+    std::cout << "Automation client disconnected\n";
+}
+
+// Drain what has arrived without blocking; false once the client is gone
+bool AutomationServer::Receive() {
+    for (;;) {
+        if (input.size() < input_used + RECEIVE_CHUNK) input.resize(input_used + RECEIVE_CHUNK);
+        ssize_t received = recv(client_fd, input.data() + input_used, RECEIVE_CHUNK, MSG_DONTWAIT);
+        if (received > 0) {
+            input_used += static_cast<size_t>(received);
+            continue;
+        }
+        if (received == 0) return false;
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+}
+
+bool AutomationServer::Send(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(client_fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+// === Batches ===
+
+// Run every complete batch received so far; false drops the client
+bool AutomationServer::RunBatches(Emulator& emu) {
+    size_t offset = 0;
+    bool keep = true;
+
+    while (keep && !quit_requested && input_used - offset >= 4) {
+        uint32_t size = Read32(&input[offset]);
+        output.assign(RESPONSE_HEADER, 0);
+
+        if (size > Protocol::MAX_BATCH) {
+            output[8] = Protocol::BATCH_TOO_LARGE;
+            Write32(&output[0], static_cast<uint32_t>(RESPONSE_HEADER - 4));
+            Send(output.data(), output.size());
+            return false;
+        }
+        if (input_used - offset - 4 < size) break;
+
+        const uint8_t* cursor = &input[offset + 4];
+        const uint8_t* end = cursor + size;
+        uint32_t executed = 0;
+        Protocol::Status status = Protocol::OK;
+        while (cursor < end) {
+            status = Execute(emu, cursor, end);
+            if (status != Protocol::OK) break;
+            executed++;
+        }
+
+        Write32(&output[0], static_cast<uint32_t>(output.size() - 4));
+        Write32(&output[4], executed);
+        output[8] = status;
+        keep = Send(output.data(), output.size());
+        offset += 4 + size;
+    }
+
+    // Keep the start of a batch that hasn't fully arrived
+    std::memmove(input.data(), input.data() + offset, input_used - offset);
+    input_used -= offset;
+    return keep;
+}
+
+AutomationProtocol::Status AutomationServer::Execute(Emulator& emu, const uint8_t*& cursor, const uint8_t* end) {
+    auto available = [&](size_t bytes) { return static_cast<size_t>(end - cursor) >= bytes; };
+
+    uint8_t command = *cursor++;
+    switch (command) {
+        case Protocol::SET_BUTTONS: {
+            if (!available(1)) return Protocol::TRUNCATED;
+            uint8_t mask = *cursor++;
+            for (uint8_t button = 0; button < 8; button++) {
+                emu.SetButton(button, (mask >> button) & 1);
+            }
+            return Protocol::OK;
+        }
+
+        case Protocol::RUN_FRAMES: {
+            if (!available(4)) return Protocol::TRUNCATED;
+            uint32_t count = Read32(cursor);
+            cursor += 4;
+            for (uint32_t i = 0; i < count; i++) {
+                emu.RunFrame();
+                if (frame_callback) frame_callback();
+            }
+            return Protocol::OK;
+        }
+
+        case Protocol::READ_MEMORY:
+        case Protocol::WRITE_MEMORY: {
+            if (!available(4)) return Protocol::TRUNCATED;
+            uint32_t addr = Read16(cursor);
+            uint32_t length = Read16(cursor + 2);
+            cursor += 4;
+            if (addr + length > 0x10000) return Protocol::BAD_RANGE;
+
+            if (command == Protocol::READ_MEMORY) {
+                for (uint32_t i = 0; i < length; i++) {
+                    output.push_back(emu.DebugRead(static_cast<uint16_t>(addr + i)));
+                }
+            } else {
+                if (!available(length)) return Protocol::TRUNCATED;
+                for (uint32_t i = 0; i < length; i++) {
+                    emu.DebugWrite(static_cast<uint16_t>(addr + i), cursor[i]);
+                }
+                cursor += length;
+            }
+            return Protocol::OK;
+        }
+
+        case Protocol::GET_FRAMEBUFFER: {
+            const uint8_t* framebuffer = emu.GetFramebuffer();
+            output.insert(output.end(), framebuffer, framebuffer + Protocol::FRAME_BYTES);
+            return Protocol::OK;
+        }
+
+        case Protocol::SAVE_STATE: {
+            if (!emu.SaveState(state_scratch)) return Protocol::STATE_REJECTED;
+            Append(output, state_scratch.size(), 4);
+            output.insert(output.end(), state_scratch.begin(), state_scratch.end());
+            return Protocol::OK;
+        }
+
+        case Protocol::LOAD_STATE: {
+            if (!available(4)) return Protocol::TRUNCATED;
+            uint32_t size = Read32(cursor);
+            cursor += 4;
+            if (!available(size)) return Protocol::TRUNCATED;
+            state_scratch.assign(cursor, cursor + size);
+            cursor += size;
+            return emu.LoadState(state_scratch) ? Protocol::OK : Protocol::STATE_REJECTED;
+        }
+
+        case Protocol::SAVE_SLOT:
+        case Protocol::LOAD_SLOT: {
+            if (!available(1)) return Protocol::TRUNCATED;
+            uint8_t slot = *cursor++;
+            if (slot >= slots.size()) return Protocol::EMPTY_SLOT;
+
+            if (command == Protocol::SAVE_SLOT) {
+                return emu.SaveState(slots[slot]) ? Protocol::OK : Protocol::STATE_REJECTED;
+            }
+            if (slots[slot].empty()) return Protocol::EMPTY_SLOT;
+            return emu.LoadState(slots[slot]) ? Protocol::OK : Protocol::STATE_REJECTED;
+        }
+
+        case Protocol::GET_STATUS:
+            Append(output, Protocol::VERSION, 2);
+            Append(output, emu.GetTotalCycles(), 8);
+            Append(output, emu.GetFrameCount(), 4);
+            Append(output, emu.GetPC(), 2);
+            output.push_back(emu.IsCPUHalted() ? 1 : 0);
+            return Protocol::OK;
+
+        case Protocol::SET_OBSERVATION: {
+            if (!available(7)) return Protocol::TRUNCATED;
+            ObservationEncoder::Config config;
+            if (cursor[0] > static_cast<uint8_t>(ObservationEncoder::Format::GRAYSCALE)) return Protocol::BAD_OBSERVATION;
+            config.format = static_cast<ObservationEncoder::Format>(cursor[0]);
+            config.crop_x = cursor[1];
+            config.crop_y = cursor[2];
+            config.crop_width = cursor[3];
+            config.crop_height = cursor[4];
+            config.downsample = cursor[5];
+            config.stack = cursor[6];
+            cursor += 7;
+            if (!observation.Configure(config)) return Protocol::BAD_OBSERVATION;
+            observation_stack.resize(observation.GetOutputSize());
+            observation_reset = true;
+            return Protocol::OK;
+        }
+
+        case Protocol::GET_OBSERVATION:
+            observation_stack.resize(observation.GetOutputSize());
+            observation.Encode(emu.GetFramebuffer(), observation_stack.data(), observation_reset);
+            observation_reset = false;
+            output.insert(output.end(), observation_stack.begin(), observation_stack.end());
+            return Protocol::OK;
+
+        case Protocol::QUIT:
+            quit_requested = true;
+            return Protocol::OK;
+
+        default:
+            return Protocol::UNKNOWN_COMMAND;
+    }
+}
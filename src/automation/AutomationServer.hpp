@@ -0,0 +1,79 @@
+#pragma once
+
+#include "AutomationProtocol.hpp"
+#include "../Emulator.hpp"
+#include "../export/ObservationEncoder.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * AutomationServer - Drive a Running Instance over a Unix Socket
+ *
+ * Listens on a Unix stream socket and executes AutomationProtocol batches
+ * against one Emulator. The host loop calls Poll() at frame boundaries;
+ * nothing is read or run mid-frame, and the emulator is only touched from
+ * the thread that calls Poll().
+ *
+ * Threads:
+ * - Everything runs on the emulation thread inside Poll()
+ *
+ * Interface:
+ * - Open(path): bind + listen (a stale socket file is replaced)
+ * - Poll(emu, timeout_ms): accept, read and run complete batches, waiting
+ *   up to timeout_ms (-1 = forever) for input; true while a client is
+ *   connected (it owns the clock)
+ * - SetFrameCallback(): called after every frame RUN_FRAMES runs, for the
+ *   host's per-frame work (shared-memory export, ...)
+ * - Close(): disconnect, close and unlink the socket file
+ */
+class AutomationServer {
+public:
+    AutomationServer() = default;
+    ~AutomationServer();
+
+    AutomationServer(const AutomationServer&) = delete;
+    AutomationServer& operator=(const AutomationServer&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return listen_fd >= 0; }
+
+    bool Poll(Emulator& emu, int timeout_ms);
+    bool HasClient() const { return client_fd >= 0; }
+    bool QuitRequested() const { return quit_requested; }
+
+    void SetFrameCallback(std::function<void()> callback) { frame_callback = std::move(callback); }
+
+private:
+    std::string socket_path;
+    int listen_fd = -1;
+    int client_fd = -1;
+    bool quit_requested = false;
+
+    // Bytes received but not yet executed, and the response being built;
+    // both keep their capacity between batches
+    std::vector<uint8_t> input;
+    size_t input_used = 0;
+    std::vector<uint8_t> output;
+    std::vector<uint8_t> state_scratch;
+    std::array<std::vector<uint8_t>, AutomationProtocol::STATE_SLOTS> slots;
+    
+    // GET_OBSERVATION output; frames stack up across batches
+    ObservationEncoder observation;
+    std::vector<uint8_t> observation_stack;
+    bool observation_reset = true;
+
+    std::function<void()> frame_callback;
+
+    void Accept();
+    void Disconnect();
+    bool Receive();
+    bool RunBatches(Emulator& emu);
+    AutomationProtocol::Status Execute(Emulator& emu, const uint8_t*& cursor, const uint8_t* end);
+    bool Send(const uint8_t* data, size_t size);
+};
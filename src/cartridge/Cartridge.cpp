@@ -1,4 +1,5 @@
 #include "Cartridge.hpp"
+#include "../state/StateBuffer.hpp"
 
 #include <fstream>
 #include <algorithm>
@@ -7,7 +8,8 @@
 #include <iomanip>
 #include <sstream>
 #include <filesystem>
-#include <ctime>
+#include <map>
+#include <mutex>
 
 // Nintendo logo for validation (first 24 bytes shown)
 static constexpr uint8_t NINTENDO_LOGO[] = {
@@ -308,28 +310,42 @@ static const char* GetLicensee(uint8_t old_code, const char* new_code) {
 }
 
 Cartridge::Cartridge()
-    : ram_enabled(false)
-    , ram_dirty(false)
-    , mbc_type(0)
-    , rom_bank(1)
-    , ram_bank(0)
-    , ram_bank_mode(false)
-    , mbc1_multicart(false)
-    , last_rtc_second(0)
-    , rtc_latch_register(0)
-    , cartridge_type(0)
+    : cartridge_type(0)
     , rom_size_code(0)
     , ram_size_code(0)
     , has_battery(false)
     , has_timer(false)
     , rom_loaded(false)
 {
-    rtc_real = {};
-    rtc_latched = {};
+    // No cartridge inserted: all windows read open bus
+    mapper = std::make_unique<MapperROMOnly>(memory);
+    mapper->Reset();
 }
 
 Cartridge::~Cartridge() = default;
 
+// === Shared ROM Images ===
+// Instances loading the same file (batch hosts, lockstep, movie replay)
+// share one read-only image instead of each holding a private copy. The
+// cache only holds weak references: the image goes away with its last user.
+
+static std::mutex rom_cache_mutex;
+static std::map<std::string, std::weak_ptr<const std::vector<uint8_t>>> rom_cache;
+
+// Path + size + mtime, so an edited ROM on disk is re-read
+static std::string ROMCacheKey(const std::string& path, uintmax_t file_size) {
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::canonical(path, error);
+    auto mtime = std::filesystem::last_write_time(path, error);
+    return (error ? path : canonical.string()) + "|" + std::to_string(file_size) + "|" +
+           std::to_string(mtime.time_since_epoch().count());
+}
+
+static const std::vector<uint8_t>& ROMImage(const CartridgeMemory& memory) {
+    static const std::vector<uint8_t> empty;
+    return memory.rom ? *memory.rom : empty;
+}
+
 bool Cartridge::LoadROM(const std::string& path) {
     // === Modern file loading: supports various methods ===
     
@@ -362,83 +378,144 @@ bool Cartridge::LoadROM(const std::string& path) {
         return false;
     }
     
-    // 4. Open and read file
-    std::ifstream file(path, std::ios::binary);
-    if (!file) {
-        std::cerr << "Error: Failed to open ROM file\n";
-        return false;
+    // 4. Reuse the image if another instance already loaded this file
+    std::string cache_key = ROMCacheKey(path, file_size);
+    std::shared_ptr<const std::vector<uint8_t>> cached;
+    {
+        std::lock_guard<std::mutex> lock(rom_cache_mutex);
+        auto it = rom_cache.find(cache_key);
+        if (it != rom_cache.end()) cached = it->second.lock();
     }
     
-    // 5. Read entire file into ROM vector
-    rom.resize(file_size);
-    file.read(reinterpret_cast<char*>(rom.data()), file_size);
-    
-    if (!file) {
-        std::cerr << "Error: Failed to read ROM data\n";
-        rom.clear();
-        return false;
+    if (cached) {
+        memory.rom = std::move(cached);
+        ParseHeader();
+    } else {
+        // 5. Open and read entire file into a new image
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "Error: Failed to open ROM file\n";
+            return false;
+        }
+        
+        auto image = std::make_shared<std::vector<uint8_t>>(file_size);
+        file.read(reinterpret_cast<char*>(image->data()), file_size);
+        
+        if (!file) {
+            std::cerr << "Error: Failed to read ROM data\n";
+            return false;
+        }
+        
+        file.close();
+        
+        // 6. Parse header
+        memory.rom = image;
+        ParseHeader();
+        
+        // 7. Validate ROM size matches header (before the image is shared)
+        size_t expected_size = GetROMSize(rom_size_code);
+        if (image->size() < expected_size) {
+            std::cerr << "Warning: ROM smaller than header indicates ("
+                      << image->size() << " < " << expected_size << ")\n";
+            // Pad with 0xFF
+            image->resize(expected_size, 0xFF);
+        } else if (image->size() > expected_size) {
+            std::cerr << "Warning: ROM larger than header indicates ("
+                      << image->size() << " > " << expected_size << ")\n";
+        }
+        
+        std::lock_guard<std::mutex> lock(rom_cache_mutex);
+        for (auto it = rom_cache.begin(); it != rom_cache.end();) {
+            it = it->second.expired() ? rom_cache.erase(it) : std::next(it);
+        }
+        rom_cache[cache_key] = memory.rom;
+    }
+    
+    const std::vector<uint8_t>& rom = *memory.rom;
+    memory.rom_banks = GetROMBankCount(rom_size_code);
+    
+    // MMM01 carts boot into a menu stored in the last 32 KB, whose header
+    // (not the one at $0100) identifies the mapper
+    if (rom.size() >= 0x10000) {
+        size_t menu_base = rom.size() - 0x8000;
+        uint8_t menu_type = rom[menu_base + 0x147];
+        if (menu_type >= 0x0B && menu_type <= 0x0D &&
+            memcmp(&rom[menu_base + 0x104], NINTENDO_LOGO, sizeof(NINTENDO_LOGO)) == 0) {
+            cartridge_type = menu_type;
+            ram_size_code = rom[menu_base + 0x149];
+            has_battery = (menu_type == 0x0D);
+            memory.rom_banks = static_cast<uint16_t>(rom.size() / 0x4000);
+        }
     }
     
-    file.close();
+    // 8. Select the MBC FIRST (needed for correct RAM size detection)
+    mapper = CreateMapper();
     
-    // 6. Parse header
-    ParseHeader();
-    
-    // 7. Validate ROM size matches header
-    size_t expected_size = GetROMSize(rom_size_code);
-    if (rom.size() < expected_size) {
-        std::cerr << "Warning: ROM smaller than header indicates ("
-                  << rom.size() << " < " << expected_size << ")\n";
-        // Pad with 0xFF
-        rom.resize(expected_size, 0xFF);
-    } else if (rom.size() > expected_size) {
-        std::cerr << "Warning: ROM larger than header indicates ("
-                  << rom.size() << " > " << expected_size << ")\n";
-    }
-    
-    // 8. Set MBC type FIRST (needed for correct RAM size detection)
-    switch (cartridge_type) {
-        case 0x00: mbc_type = 0; break;  // ROM ONLY
-        case 0x01: case 0x02: case 0x03: mbc_type = 1; break;  // MBC1
-        case 0x05: case 0x06: mbc_type = 2; break;  // MBC2
-        case 0x0F: case 0x10: case 0x11: case 0x12: case 0x13: mbc_type = 3; break;  // MBC3
-        case 0x19: case 0x1A: case 0x1B: case 0x1C: case 0x1D: case 0x1E: mbc_type = 5; break;  // MBC5
-        default: mbc_type = 0; break;  // Treat unknown as ROM ONLY
-    }
+    // 9. Initialize RAM (mapper may override the header, e.g. MBC2 512-byte RAM)
+    memory.ram.assign(GetRAMSize(), 0x00);
+    memory.ram_dirty = false;
     
-    // 9. Initialize RAM (now mbc_type is set, so MBC2 512-byte RAM works correctly)
-    size_t ram_size = GetRAMSize();
-    if (ram_size > 0) {
-        ram.resize(ram_size, 0x00);
-    }
+    // 10. Initialize bank registers and windows
+    mapper->Reset();
     
-    // 10. Initialize bank registers
-    rom_bank = 1;
-    ram_bank = 0;
-    ram_enabled = false;
-    ram_bank_mode = false;
-    mbc1_multicart = false;
+    rom_loaded = true;
+    return true;
+}
+
+std::unique_ptr<Mapper> Cartridge::CreateMapper() {
+    const std::vector<uint8_t>& rom = ROMImage(memory);
     
-    // 11. Detect MBC1M (multicart) by checking for Nintendo logo at bank $10
-    // MBC1M carts are 1MB MBC1 carts with alternate wiring where BANK2 is connected
-    // to bits 4-5 instead of 5-6. They can be identified by having a valid Nintendo
-    // logo at offset $40104 (bank $10's header area).
-    // See: https://gbdev.io/pandocs/MBC1.html#mbc1m-1-mib-multi-game-compilation-carts
-    if (mbc_type == 1 && rom.size() >= 0x41000) {  // At least 1MB+ ROM
-        // Check for Nintendo logo at bank $10 (offset 0x40000 + 0x104 = 0x40104)
-        const uint32_t logo_offset = 0x40104;
-        if (rom.size() > logo_offset + sizeof(NINTENDO_LOGO)) {
-            if (memcmp(&rom[logo_offset], NINTENDO_LOGO, sizeof(NINTENDO_LOGO)) == 0) {
-                mbc1_multicart = true;
+    switch (cartridge_type) {
+        case 0x00: case 0x08: case 0x09:
+            return std::make_unique<MapperROMOnly>(memory);
+            
+        case 0x01: case 0x02: case 0x03: {
+            // Detect MBC1M (multicart) by checking for Nintendo logo at bank $10
+            // MBC1M carts are 1MB MBC1 carts that can be identified by having a valid
+            // Nintendo logo at offset $40104 (bank $10's header area).
+            const uint32_t logo_offset = 0x40104;
+            if (rom.size() > logo_offset + sizeof(NINTENDO_LOGO) &&
+                memcmp(&rom[logo_offset], NINTENDO_LOGO, sizeof(NINTENDO_LOGO)) == 0) {
+                return std::make_unique<MapperMBC1M>(memory);
             }
+            return std::make_unique<MapperMBC1>(memory);
         }
+        
+        case 0x05: case 0x06:
+            return std::make_unique<MapperMBC2>(memory);
+            
+        case 0x0B: case 0x0C: case 0x0D:
+            return std::make_unique<MapperMMM01>(memory);
+            
+        case 0x0F: case 0x10: case 0x11: case 0x12: case 0x13:
+            return std::make_unique<MapperMBC3>(memory, has_timer);
+            
+        case 0x19: case 0x1A: case 0x1B: case 0x1C: case 0x1D: case 0x1E:
+            return std::make_unique<MapperMBC5>(memory);
+            
+        case 0x20:
+            return std::make_unique<MapperMBC6>(memory);
+            
+        case 0x22:
+            return std::make_unique<MapperMBC7>(memory);
+            
+        case 0xFE:
+            return std::make_unique<MapperHuC3>(memory);
+            
+        case 0xFF:
+            return std::make_unique<MapperHuC1>(memory);
+            
+        default:
+            std::cerr << "Warning: Unsupported cartridge type 0x" << std::hex << std::uppercase
+                      << static_cast<int>(cartridge_type) << std::dec << " ("
+                      << GetCartridgeTypeName(cartridge_type) << "), running as ROM only\n";
+            return std::make_unique<MapperROMOnly>(memory);
     }
-    
-    rom_loaded = true;
-    return true;
 }
 
 void Cartridge::ParseHeader() {
+    const std::vector<uint8_t>& rom = ROMImage(memory);
+    
     // Title: $0134-$0143 (16 bytes, may include manufacturer code in CGB)
     title.clear();
     for (int i = 0x134; i <= 0x143 && rom[i] != 0; ++i) {
@@ -463,10 +540,13 @@ void Cartridge::ParseHeader() {
                    cartridge_type == 0x09 || cartridge_type == 0x0D ||
                    cartridge_type == 0x0F || cartridge_type == 0x10 ||
                    cartridge_type == 0x13 || cartridge_type == 0x1B ||
-                   cartridge_type == 0x1E || cartridge_type == 0xFF);
+                   cartridge_type == 0x1E || cartridge_type == 0x20 ||
+                   cartridge_type == 0x22 || cartridge_type == 0xFE ||
+                   cartridge_type == 0xFF);
     
     // Check for timer (RTC)
-    has_timer = (cartridge_type == 0x0F || cartridge_type == 0x10);
+    has_timer = (cartridge_type == 0x0F || cartridge_type == 0x10 ||
+                 cartridge_type == 0xFE);
     
     // ROM size: $0148
     rom_size_code = rom[0x148];
@@ -476,11 +556,8 @@ void Cartridge::ParseHeader() {
 }
 
 size_t Cartridge::GetRAMSize() const {
-    // MBC2 has 512×4 bits of RAM regardless of header
-    if (mbc_type == 2) {
-        return 512;  // 512 bytes (4-bit values)
-    }
-    return GetRAMSizeFromCode(ram_size_code);
+    // Some MBCs ignore the header (MBC2 512×4 bits, MBC7 EEPROM, ...)
+    return mapper->GetRAMSize(GetRAMSizeFromCode(ram_size_code));
 }
 
 // === Cartridge Header Info for Display ===
@@ -490,6 +567,7 @@ std::string Cartridge::GetDetailedInfo() const {
         return "No ROM loaded";
     }
     
+    const std::vector<uint8_t>& rom = ROMImage(memory);
     std::stringstream ss;
     
     ss << "╔══════════════════════════════════════════════════════════╗\n";
@@ -503,9 +581,7 @@ std::string Cartridge::GetDetailedInfo() const {
     ss << "║ Type:          " << std::setw(42) << GetCartridgeTypeName(cartridge_type) << "║\n";
     
     // MBC
-    std::string mbc_str = "MBC" + std::to_string(mbc_type);
-    if (mbc_type == 0) mbc_str = "No MBC";
-    ss << "║ MBC:           " << std::setw(42) << mbc_str << "║\n";
+    ss << "║ MBC:           " << std::setw(42) << mapper->GetName() << "║\n";
     
     // ROM size
     size_t rom_size = GetROMSize(rom_size_code);
@@ -583,357 +659,8 @@ std::string Cartridge::GetDetailedInfo() const {
     return ss.str();
 }
 
-// === Memory Access ===
-
-uint8_t Cartridge::Read(uint16_t addr) const {
-    if (addr < 0x8000) {
-        return ReadROM(addr);
-    } else if (addr >= 0xA000 && addr < 0xC000) {
-        return ReadRAM(addr);
-    }
-    return 0xFF;
-}
-
-void Cartridge::Write(uint16_t addr, uint8_t value) {
-    if (addr < 0x8000) {
-        WriteROM(addr, value);
-    } else if (addr >= 0xA000 && addr < 0xC000) {
-        WriteRAM(addr, value);
-    }
-}
-
-uint8_t Cartridge::ReadROM(uint16_t addr) const {
-    uint32_t offset = GetROMOffset(addr);
-    if (offset < rom.size()) {
-        return rom[offset];
-    }
-    return 0xFF;
-}
-
-void Cartridge::WriteROM(uint16_t addr, uint8_t value) {
-    // ROM writes are MBC register writes
-    switch (mbc_type) {
-        case 0:  // No MBC - writes ignored
-            break;
-            
-        case 1:  // MBC1
-            // See: https://gbdev.io/pandocs/MBC1.html
-            if (addr < 0x2000) {
-                // $0000-$1FFF: RAM Enable
-                // Any value with $A in lower 4 bits enables RAM
-                ram_enabled = ((value & 0x0F) == 0x0A);
-            } else if (addr < 0x4000) {
-                // $2000-$3FFF: ROM Bank Number (BANK1 register)
-                // 5-bit register, but 00→01 translation is handled during address calculation
-                // We store the raw 5-bit value here
-                rom_bank = value & 0x1F;
-            } else if (addr < 0x6000) {
-                // $4000-$5FFF: RAM Bank Number / Upper ROM Bank bits (BANK2 register)
-                // This 2-bit register is ALWAYS written to - mode only affects how it's USED
-                // during address translation, not how it's stored
-                ram_bank = value & 0x03;
-            } else {
-                // $6000-$7FFF: Banking Mode Select
-                // 0 = Simple mode (default): 0000-3FFF locked to bank 0, A000-BFFF locked to RAM bank 0
-                // 1 = Advanced mode: 0000-3FFF and A000-BFFF can be switched via BANK2
-                ram_bank_mode = (value & 0x01) != 0;
-            }
-            break;
-            
-        case 2:  // MBC2
-            if (addr < 0x4000) {
-                if (addr & 0x0100) {
-                    // ROM Bank (bit 8 of address set)
-                    rom_bank = value & 0x0F;
-                    if (rom_bank == 0) rom_bank = 1;
-                } else {
-                    // RAM Enable (bit 8 of address clear)
-                    ram_enabled = ((value & 0x0F) == 0x0A);
-                }
-            }
-            break;
-            
-        case 3:  // MBC3
-            if (addr < 0x2000) {
-                // RAM/RTC Enable
-                ram_enabled = ((value & 0x0F) == 0x0A);
-            } else if (addr < 0x4000) {
-                // ROM Bank
-                rom_bank = value & 0x7F;
-                if (rom_bank == 0) rom_bank = 1;
-            } else if (addr < 0x6000) {
-                // RAM Bank / RTC Register Select
-                ram_bank = value;
-            } else {
-                // Latch Clock Data - writing 0 then 1 latches current RTC values
-                if (rtc_latch_register == 0 && value == 1) {
-                    // Update RTC from system time before latching
-                    UpdateRTC();
-                    // Copy real values to latched values
-                    rtc_latched = rtc_real;
-                }
-                rtc_latch_register = value;
-            }
-            break;
-            
-        case 5:  // MBC5
-            if (addr < 0x2000) {
-                // RAM Enable
-                ram_enabled = ((value & 0x0F) == 0x0A);
-            } else if (addr < 0x3000) {
-                // ROM Bank Low 8 bits
-                rom_bank = (rom_bank & 0x100) | value;
-            } else if (addr < 0x4000) {
-                // ROM Bank High bit
-                rom_bank = (rom_bank & 0xFF) | ((value & 0x01) << 8);
-            } else if (addr < 0x6000) {
-                // RAM Bank
-                ram_bank = value & 0x0F;
-            }
-            break;
-    }
-}
-
-uint8_t Cartridge::ReadRAM(uint16_t addr) const {
-    if (!ram_enabled || ram.empty()) {
-        return 0xFF;
-    }
-    
-    // MBC3 RTC registers - read from LATCHED values (per hardware)
-    // Games latch the RTC, then read the frozen snapshot
-    if (mbc_type == 3 && ram_bank >= 0x08 && ram_bank <= 0x0C) {
-        switch (ram_bank) {
-            case 0x08: return rtc_latched.seconds;
-            case 0x09: return rtc_latched.minutes;
-            case 0x0A: return rtc_latched.hours;
-            case 0x0B: return rtc_latched.days_low;
-            case 0x0C: return rtc_latched.days_high;
-        }
-        return 0xFF;
-    }
-    
-    uint32_t offset = GetRAMOffset(addr);
-    if (offset < ram.size()) {
-        if (mbc_type == 2) {
-            // MBC2: 4-bit RAM
-            return ram[offset] | 0xF0;
-        }
-        return ram[offset];
-    }
-    return 0xFF;
-}
-
-void Cartridge::WriteRAM(uint16_t addr, uint8_t value) {
-    if (!ram_enabled || ram.empty()) {
-        return;
-    }
-    
-    // MBC3 RTC registers - write to REAL values
-    // When game sets the clock, we update rtc_real and reset our time tracking
-    if (mbc_type == 3 && ram_bank >= 0x08 && ram_bank <= 0x0C) {
-        switch (ram_bank) {
-            case 0x08: rtc_real.seconds = value & 0x3F; break;  // 0-59
-            case 0x09: rtc_real.minutes = value & 0x3F; break;  // 0-59
-            case 0x0A: rtc_real.hours = value & 0x1F; break;    // 0-23
-            case 0x0B: rtc_real.days_low = value; break;
-            case 0x0C: rtc_real.days_high = value & 0xC1; break; // Only bits 0, 6, 7
-        }
-        // When clock is written, reset our time tracking
-        last_rtc_second = std::time(nullptr);
-        ram_dirty = true;  // RTC was modified
-        return;
-    }
-    
-    uint32_t offset = GetRAMOffset(addr);
-    if (offset < ram.size()) {
-        if (mbc_type == 2) {
-            // MBC2: 4-bit RAM
-            ram[offset] = value & 0x0F;
-        } else {
-            ram[offset] = value;
-        }
-        ram_dirty = true;  // Track modification for efficient save
-    }
-}
-
-uint32_t Cartridge::GetROMOffset(uint16_t addr) const {
-    // Calculate the bank mask for hardware-accurate AND gate emulation
-    // Real MBC hardware uses AND gates to mask bank numbers, not modulo
-    // For power-of-2 bank counts, mask = num_banks - 1
-    uint16_t num_banks = GetROMBankCount(rom_size_code);
-    uint16_t bank_mask = num_banks - 1;  // Hardware AND gate mask
-    
-    if (addr < 0x4000) {
-        // $0000-$3FFF: ROM Bank X0
-        if (mbc_type == 1 && ram_bank_mode) {
-            // Mode 1: BANK2 applies to this region too
-            uint32_t bank;
-            if (mbc1_multicart) {
-                // MBC1M: BANK2 applies to bits 4-5
-                bank = (ram_bank << 4);
-            } else {
-                // Normal MBC1: BANK2 applies to bits 5-6
-                bank = (ram_bank << 5);
-            }
-            // Hardware AND gate masking
-            bank = bank & bank_mask;
-            return (bank * 0x4000) + addr;
-        }
-        // Mode 0: Always bank 0
-        return addr;
-    } else {
-        // $4000-$7FFF: Switchable ROM bank
-        uint32_t bank = rom_bank;  // 5-bit BANK1 register
-        
-        if (mbc_type == 1) {
-            // MBC1 specific handling
-            if (mbc1_multicart) {
-                // MBC1M (multicart) mode:
-                // - Only lower 4 bits of BANK1 used for banking
-                // - But full 5 bits still used for 00→01 translation
-                // - BANK2 applies to bits 4-5 (not 5-6)
-                if (bank == 0) {
-                    bank = 1;
-                }
-                // Use only lower 4 bits for actual banking
-                uint32_t bank_low = bank & 0x0F;
-                // Apply BANK2 to bits 4-5
-                bank = bank_low | (ram_bank << 4);
-            } else {
-                // Normal MBC1:
-                // Combine BANK1 (5-bit) with BANK2 (2-bit) for upper bits
-                // The 00→01 translation only looks at BANK1 (the 5-bit register)
-                if (bank == 0) {
-                    bank = 1;
-                }
-                // Always apply BANK2 as upper bits (bits 5-6) for $4000-$7FFF
-                bank = bank | (ram_bank << 5);
-            }
-            // Hardware AND gate masking
-            bank = bank & bank_mask;
-        } else if (mbc_type == 5) {
-            // MBC5: 9-bit bank number, bank 0 IS accessible
-            // Hardware AND gate masking
-            bank = bank & bank_mask;
-        } else if (mbc_type == 3) {
-            // MBC3: 7-bit bank number, 00→01 translation
-            if (bank == 0) bank = 1;
-            // Hardware AND gate masking
-            bank = bank & bank_mask;
-        } else if (mbc_type == 2) {
-            // MBC2: 4-bit bank number, 00→01 translation
-            if (bank == 0) bank = 1;
-            // Hardware AND gate masking
-            bank = bank & bank_mask;
-        } else if (num_banks > 1) {
-            // No MBC but multi-bank: mask to size
-            bank = bank & bank_mask;
-        }
-        
-        return (bank * 0x4000) + (addr - 0x4000);
-    }
-}
-
-uint32_t Cartridge::GetRAMOffset(uint16_t addr) const {
-    if (mbc_type == 2) {
-        // MBC2: 512 bytes, mirrored via hardware AND gate
-        return (addr - 0xA000) & 0x1FF;
-    }
-    
-    // Calculate RAM bank mask for hardware-accurate AND gate emulation
-    size_t ram_size = ram.size();
-    uint32_t num_ram_banks = (ram_size > 0) ? ((ram_size + 0x1FFF) / 0x2000) : 0;
-    uint32_t ram_bank_mask = (num_ram_banks > 0) ? (num_ram_banks - 1) : 0;
-    
-    // Apply RAM bank using hardware AND gate masking
-    uint32_t bank = 0;
-    if (mbc_type == 1 && ram_bank_mode && num_ram_banks > 1) {
-        // MBC1 mode 1: BANK2 applies to RAM
-        // Hardware AND gate masking
-        bank = ram_bank & ram_bank_mask;
-    } else if ((mbc_type == 3 || mbc_type == 5) && num_ram_banks > 1) {
-        // Hardware AND gate masking
-        bank = ram_bank & ram_bank_mask;
-    }
-    
-    return (bank * 0x2000) + (addr - 0xA000);
-}
-
-// === RTC Time Sync ===
-// Updates RTC registers from system time elapsed since last sync
-void Cartridge::UpdateRTC() const {
-    if (!has_timer) return;
-    
-    // Check if RTC is halted (bit 6 of days_high)
-    if (rtc_real.days_high & 0x40) return;
-    
-    int64_t now = std::time(nullptr);
-    if (last_rtc_second == 0) {
-        // First time - just record current time
-        last_rtc_second = now;
-        return;
-    }
-    
-    int64_t elapsed = now - last_rtc_second;
-    if (elapsed <= 0) return;
-    
-    last_rtc_second = now;
-    
-    // Add elapsed seconds to RTC
-    int64_t seconds = rtc_real.seconds + elapsed;
-    rtc_real.seconds = seconds % 60;
-    
-    int64_t minutes = rtc_real.minutes + (seconds / 60);
-    rtc_real.minutes = minutes % 60;
-    
-    int64_t hours = rtc_real.hours + (minutes / 60);
-    rtc_real.hours = hours % 24;
-    
-    int64_t days = ((rtc_real.days_high & 0x01) << 8) | rtc_real.days_low;
-    days += hours / 24;
-    
-    rtc_real.days_low = days & 0xFF;
-    rtc_real.days_high = (rtc_real.days_high & 0xC0) | ((days >> 8) & 0x01);
-    
-    // Day counter overflow (> 511 days)
-    if (days > 511) {
-        rtc_real.days_high |= 0x80;  // Set carry flag
-        rtc_real.days_low = 0;
-        rtc_real.days_high &= ~0x01; // Clear day MSB
-    }
-}
-
 // === Save/Load ===
 
-// RTC save structure (VBA-compatible 64-bit timestamp format)
-#pragma pack(push, 1)
-struct RTCSaveData {
-    uint8_t seconds;
-    uint8_t padding1[3];
-    uint8_t minutes;
-    uint8_t padding2[3];
-    uint8_t hours;
-    uint8_t padding3[3];
-    uint8_t days;
-    uint8_t padding4[3];
-    uint8_t high;
-    uint8_t padding5[3];
-    // Latched values
-    uint8_t latched_seconds;
-    uint8_t lpadding1[3];
-    uint8_t latched_minutes;
-    uint8_t lpadding2[3];
-    uint8_t latched_hours;
-    uint8_t lpadding3[3];
-    uint8_t latched_days;
-    uint8_t lpadding4[3];
-    uint8_t latched_high;
-    uint8_t lpadding5[3];
-    // Timestamp
-    int64_t last_rtc_second;
-};
-#pragma pack(pop)
-
 bool Cartridge::LoadSave(const std::string& path) {
     if (!has_battery) {
         return false;
@@ -950,36 +677,17 @@ bool Cartridge::LoadSave(const std::string& path) {
     file.seekg(0, std::ios::beg);
     
     // Load RAM
+    std::vector<uint8_t>& ram = memory.ram;
     if (!ram.empty()) {
         file.read(reinterpret_cast<char*>(ram.data()), std::min(ram.size(), file_size));
     }
     
-    // Load RTC if present (MBC3 with timer)
+    // Load mapper extras if present (RTC)
     if (has_timer && file_size > ram.size()) {
-        RTCSaveData rtc_save = {};
-        file.read(reinterpret_cast<char*>(&rtc_save), sizeof(rtc_save));
-        
-        rtc_real.seconds = rtc_save.seconds;
-        rtc_real.minutes = rtc_save.minutes;
-        rtc_real.hours = rtc_save.hours;
-        rtc_real.days_low = rtc_save.days;
-        rtc_real.days_high = rtc_save.high;
-        
-        rtc_latched.seconds = rtc_save.latched_seconds;
-        rtc_latched.minutes = rtc_save.latched_minutes;
-        rtc_latched.hours = rtc_save.latched_hours;
-        rtc_latched.days_low = rtc_save.latched_days;
-        rtc_latched.days_high = rtc_save.latched_high;
-        
-        last_rtc_second = rtc_save.last_rtc_second;
-        
-        // Update RTC to current time if save is from the past
-        if (last_rtc_second > 0 && last_rtc_second < std::time(nullptr)) {
-            UpdateRTC();
-        }
+        mapper->LoadExtra(file);
     }
     
-    ram_dirty = false;  // Just loaded, not dirty
+    memory.ram_dirty = false;  // Just loaded, not dirty
     return file.good() || file.eof();  // EOF is OK if we read exactly the right amount
 }
 
@@ -989,7 +697,7 @@ bool Cartridge::SaveRAM(const std::string& path) const {
     }
     
     // Optimization: Only save if dirty
-    if (!ram_dirty) {
+    if (!memory.ram_dirty) {
         return true;  // Nothing to save, but not an error
     }
     
@@ -999,35 +707,46 @@ bool Cartridge::SaveRAM(const std::string& path) const {
     }
     
     // Save RAM
+    const std::vector<uint8_t>& ram = memory.ram;
     if (!ram.empty()) {
         file.write(reinterpret_cast<const char*>(ram.data()), ram.size());
     }
     
-    // Save RTC if present (MBC3 with timer)
+    // Save mapper extras if present (RTC)
     if (has_timer) {
-        // Sync RTC before saving
-        UpdateRTC();
-        
-        RTCSaveData rtc_save = {};
-        rtc_save.seconds = rtc_real.seconds;
-        rtc_save.minutes = rtc_real.minutes;
-        rtc_save.hours = rtc_real.hours;
-        rtc_save.days = rtc_real.days_low;
-        rtc_save.high = rtc_real.days_high;
-        
-        rtc_save.latched_seconds = rtc_latched.seconds;
-        rtc_save.latched_minutes = rtc_latched.minutes;
-        rtc_save.latched_hours = rtc_latched.hours;
-        rtc_save.latched_days = rtc_latched.days_low;
-        rtc_save.latched_high = rtc_latched.days_high;
-        
-        rtc_save.last_rtc_second = last_rtc_second;
-        
-        file.write(reinterpret_cast<const char*>(&rtc_save), sizeof(rtc_save));
+        mapper->SaveExtra(file);
     }
     
     if (file.good()) {
-        ram_dirty = false;  // Successfully saved
+        memory.ram_dirty = false;  // Successfully saved
     }
     return file.good();
 }
+
+// === Save State ===
+
+static uint16_t GetGlobalChecksum(const std::vector<uint8_t>& rom) {
+    return rom.size() >= 0x150 ? static_cast<uint16_t>((rom[0x14E] << 8) | rom[0x14F]) : 0;
+}
+
+void Cartridge::SaveState(StateWriter& state) const {
+    // Identify the ROM so a state is never applied to a different game
+    uint32_t rom_size = static_cast<uint32_t>(ROMImage(memory).size());
+    uint16_t global_checksum = GetGlobalChecksum(ROMImage(memory));
+    state(rom_size, global_checksum);
+    state.Bytes(memory.ram);
+    mapper->SaveState(state);
+}
+
+void Cartridge::LoadState(StateReader& state) {
+    uint32_t rom_size = 0;
+    uint16_t global_checksum = 0;
+    state(rom_size, global_checksum);
+    if (rom_size != ROMImage(memory).size() || global_checksum != GetGlobalChecksum(ROMImage(memory))) {
+        state.Fail();
+        return;
+    }
+    state.Bytes(memory.ram);
+    mapper->LoadState(state);
+    memory.ram_dirty = true;  // RAM no longer matches the .sav file
+}
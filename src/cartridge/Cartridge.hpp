@@ -4,6 +4,11 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include "Mapper.hpp"
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
 
 /**
  * Cartridge - Game Cartridge Interface
@@ -17,12 +22,16 @@
  * The cartridge is a separate PCB that plugs into the console.
  * It contains its own chips (ROM, RAM, MBC controller).
  * 
+ * The MBC is selected once in LoadROM (see Mapper.hpp). Reads go straight
+ * through the bank windows it maintains; only register writes and special
+ * RAM-area accesses (RTC, sensors, 4-bit RAM) reach the mapper.
+ * 
  * Interface:
  * - Address input (directly exposed A0-A15)
  * - Data output (directly exposed D0-D7)
  * - Read/Write control
  */
-class Cartridge {
+class Cartridge : public ArenaAllocated {
 public:
     Cartridge();
     ~Cartridge();
@@ -34,9 +43,36 @@ public:
     bool LoadSave(const std::string& path);
     bool SaveRAM(const std::string& path) const;
     
+    // === Save State (RAM + mapper registers; the ROM is identified, not stored) ===
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+    
     // === Cartridge Pins (directly exposed address/data interface) ===
-    uint8_t Read(uint16_t addr) const;
-    void Write(uint16_t addr, uint8_t value);
+    uint8_t Read(uint16_t addr) const {
+        if (addr < 0x8000) {
+            return memory.rom_map[addr >> 13][addr & 0x1FFF];
+        }
+        if (addr >= 0xA000 && addr < 0xC000) {
+            const uint8_t* window = memory.ram_map[(addr >> 12) & 1];
+            if (window) return window[addr & 0x0FFF];
+            return mapper->ReadRAM(addr);
+        }
+        return 0xFF;
+    }
+    
+    void Write(uint16_t addr, uint8_t value) {
+        if (addr < 0x8000) {
+            mapper->WriteROM(addr, value);  // MBC register write
+        } else if (addr >= 0xA000 && addr < 0xC000) {
+            uint8_t* window = memory.ram_map[(addr >> 12) & 1];
+            if (window) {
+                window[addr & 0x0FFF] = value;
+                memory.ram_dirty = true;  // Track modification for efficient save
+            } else {
+                mapper->WriteRAM(addr, value);
+            }
+        }
+    }
     
     // === Cartridge Info (directly exposed from ROM header) ===
     std::string GetTitle() const { return title; }
@@ -46,44 +82,22 @@ public:
     bool HasBattery() const { return has_battery; }
     bool HasTimer() const { return has_timer; }
     bool IsLoaded() const { return rom_loaded; }
-    bool IsDirty() const { return ram_dirty; }  // RAM modified since last save
-    void ClearDirty() { ram_dirty = false; }    // Call after successful save
+    bool IsDirty() const { return memory.ram_dirty; }  // RAM modified since last save
+    void ClearDirty() { memory.ram_dirty = false; }    // Call after successful save
     
     // Get detailed ROM information for display
     std::string GetDetailedInfo() const;
     
-private:
-    // === ROM Storage (directly exposed internal storage) ===
-    std::vector<uint8_t> rom;
+    // === Footprint (bytes, see Emulator::GetFootprint) ===
+    size_t GetRAMFootprint() const { return memory.ram.capacity() + mapper->GetStorageFootprint(); }
+    size_t GetROMFootprint() const { return memory.rom ? memory.rom->capacity() : 0; }
     
-    // === External RAM (directly exposed, battery-backed) ===
-    mutable std::vector<uint8_t> ram;  // mutable for const Read with banking
-    bool ram_enabled;
-    mutable bool ram_dirty;  // Track if RAM was modified since last save
-    
-    // === MBC State (directly exposed internal MBC registers) ===
-    uint8_t mbc_type;           // MBC variant (0 = none, 1, 2, 3, 5)
-    uint16_t rom_bank;          // Current ROM bank (directly exposed)
-    uint8_t ram_bank;           // Current RAM bank (directly exposed)
-    bool ram_bank_mode;         // MBC1: RAM banking mode (directly exposed)
-    bool mbc1_multicart;        // MBC1M: Multicart mode (different BANK2 wiring)
-    
-    // MBC3 RTC (directly exposed)
-    // Per hardware: RTC runs from real system time, latched values frozen when latch triggered
-    struct RTCRegisters {
-        uint8_t seconds;    // 0-59
-        uint8_t minutes;    // 0-59
-        uint8_t hours;      // 0-23
-        uint8_t days_low;   // Lower 8 bits of day counter
-        uint8_t days_high;  // Bit 0: Day counter MSB, Bit 6: Halt, Bit 7: Day carry
-    };
-    mutable RTCRegisters rtc_real;      // Current RTC values (synced with system time)
-    mutable RTCRegisters rtc_latched;   // Latched values (frozen on latch)
-    mutable int64_t last_rtc_second;    // Unix timestamp when RTC was last synced
-    uint8_t rtc_latch_register;         // For detecting 0->1 latch transition
+private:
+    // === ROM/RAM Chips and Bank Windows (directly exposed internal storage) ===
+    mutable CartridgeMemory memory;  // mutable: SaveRAM clears the dirty flag
     
-    // Update RTC from system time
-    void UpdateRTC() const;
+    // === MBC (directly exposed, selected once per ROM) ===
+    std::unique_ptr<Mapper> mapper;
     
     // === ROM Header Info (directly exposed, parsed on load) ===
     std::string title;
@@ -94,15 +108,8 @@ private:
     bool has_timer;
     bool rom_loaded;
     
-    // === MBC Operations (directly expose banking logic) ===
-    uint8_t ReadROM(uint16_t addr) const;
-    void WriteROM(uint16_t addr, uint8_t value);
-    uint8_t ReadRAM(uint16_t addr) const;
-    void WriteRAM(uint16_t addr, uint8_t value);
-    
-    // Bank number calculations (directly exposed)
-    uint32_t GetROMOffset(uint16_t addr) const;
-    uint32_t GetRAMOffset(uint16_t addr) const;
+    // === MBC Selection ===
+    std::unique_ptr<Mapper> CreateMapper();
     
     void ParseHeader();
     size_t GetRAMSize() const;
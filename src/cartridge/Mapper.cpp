@@ -0,0 +1,1137 @@
+#include "Mapper.hpp"
+#include "../state/StateBuffer.hpp"
+
+#include <istream>
+#include <ostream>
+#include <ctime>
+
+// Unconnected ROM lines (and erased MBC6 flash) read as open bus
+static const std::array<uint8_t, 0x2000> OPEN_BUS_PAGE = [] {
+    std::array<uint8_t, 0x2000> page;
+    page.fill(0xFF);
+    return page;
+}();
+
+// =============================================================================
+// Mapper base
+// =============================================================================
+
+Mapper::Mapper(CartridgeMemory& memory)
+    : mem(memory)
+    , rom_bank_mask(1)
+    , ram_bank_mask(0)
+    , ram_window_offset{0, 0}
+    , ram_mapped(false)
+{
+}
+
+void Mapper::Reset() {
+    // Real MBC hardware uses AND gates to mask bank numbers, not modulo
+    // For power-of-2 bank counts, mask = num_banks - 1
+    rom_bank_mask = mem.rom_banks > 0 ? mem.rom_banks - 1 : 0;
+
+    size_t ram_size = mem.ram.size();
+    uint32_t num_ram_banks = (ram_size > 0) ? ((ram_size + 0x1FFF) / 0x2000) : 0;
+    ram_bank_mask = (num_ram_banks > 0) ? (num_ram_banks - 1) : 0;
+
+    ResetRegisters();
+}
+
+void Mapper::MapROM(uint8_t slot, uint32_t bank) {
+    MapROM8K(slot * 2, bank * 2);
+    MapROM8K(slot * 2 + 1, bank * 2 + 1);
+}
+
+void Mapper::MapROM8K(uint8_t window, uint32_t bank) {
+    size_t offset = static_cast<size_t>(bank) * 0x2000;
+    if (mem.rom && offset + 0x2000 <= mem.rom->size()) {
+        mem.rom_map[window] = mem.rom->data() + offset;
+    } else {
+        mem.rom_map[window] = OPEN_BUS_PAGE.data();
+    }
+}
+
+void Mapper::MapRAM(uint32_t bank) {
+    MapRAM4K(0, bank * 2);
+    MapRAM4K(1, bank * 2 + 1);
+}
+
+void Mapper::MapRAM4K(uint8_t window, uint32_t bank) {
+    uint32_t offset = bank * 0x1000;
+    ram_window_offset[window] = offset;
+    ram_mapped = true;
+    // Only fully backed windows are served directly; partial ones (2 KB RAM)
+    // fall back to the bounds-checked slow path
+    if (offset + 0x1000 <= mem.ram.size()) {
+        mem.ram_map[window] = &mem.ram[offset];
+    } else {
+        mem.ram_map[window] = nullptr;
+    }
+}
+
+void Mapper::UnmapRAM() {
+    ram_mapped = false;
+    mem.ram_map = {nullptr, nullptr};
+}
+
+void Mapper::RouteRAMToMapper() {
+    mem.ram_map = {nullptr, nullptr};
+}
+
+uint8_t Mapper::ReadRAM(uint16_t addr) {
+    if (!ram_mapped) {
+        return 0xFF;
+    }
+    uint32_t offset = ram_window_offset[(addr >> 12) & 1] + (addr & 0x0FFF);
+    if (offset < mem.ram.size()) {
+        return mem.ram[offset];
+    }
+    return 0xFF;
+}
+
+void Mapper::WriteRAM(uint16_t addr, uint8_t value) {
+    if (!ram_mapped) {
+        return;
+    }
+    uint32_t offset = ram_window_offset[(addr >> 12) & 1] + (addr & 0x0FFF);
+    if (offset < mem.ram.size()) {
+        mem.ram[offset] = value;
+        mem.ram_dirty = true;  // Track modification for efficient save
+    }
+}
+
+// =============================================================================
+// ROM Only
+// =============================================================================
+
+void MapperROMOnly::ResetRegisters() {
+    MapROM(0, 0);
+    MapROM(1, 1 & rom_bank_mask);
+    // ROM+RAM carts have the RAM chip wired directly to $A000-$BFFF
+    if (!mem.ram.empty()) {
+        MapRAM(0);
+    } else {
+        UnmapRAM();
+    }
+}
+
+// =============================================================================
+// MBC1
+// See: https://gbdev.io/pandocs/MBC1.html
+// =============================================================================
+
+void MapperMBC1::ResetRegisters() {
+    ram_enabled = false;
+    bank1 = 1;
+    bank2 = 0;
+    mode = false;
+    UpdateMapping();
+}
+
+void MapperMBC1::WriteROM(uint16_t addr, uint8_t value) {
+    if (addr < 0x2000) {
+        // $0000-$1FFF: RAM Enable
+        // Any value with $A in lower 4 bits enables RAM
+        ram_enabled = ((value & 0x0F) == 0x0A);
+    } else if (addr < 0x4000) {
+        // $2000-$3FFF: ROM Bank Number (BANK1 register)
+        // 5-bit register, but 00→01 translation is handled during address calculation
+        bank1 = value & 0x1F;
+    } else if (addr < 0x6000) {
+        // $4000-$5FFF: RAM Bank Number / Upper ROM Bank bits (BANK2 register)
+        // This 2-bit register is ALWAYS written to - mode only affects how it's USED
+        bank2 = value & 0x03;
+    } else {
+        // $6000-$7FFF: Banking Mode Select
+        // 0 = Simple mode (default): 0000-3FFF locked to bank 0, A000-BFFF locked to RAM bank 0
+        // 1 = Advanced mode: 0000-3FFF and A000-BFFF can be switched via BANK2
+        mode = (value & 0x01) != 0;
+    }
+    UpdateMapping();
+}
+
+void MapperMBC1::UpdateMapping() {
+    // Mode 1: BANK2 applies to bits 5-6 of the $0000-$3FFF bank too
+    MapROM(0, mode ? ((bank2 << 5) & rom_bank_mask) : 0);
+
+    // The 00→01 translation only looks at BANK1 (the 5-bit register)
+    uint32_t bank = (bank1 == 0) ? 1 : bank1;
+    MapROM(1, (bank | (bank2 << 5)) & rom_bank_mask);
+
+    if (ram_enabled && !mem.ram.empty()) {
+        // Mode 1: BANK2 selects the RAM bank
+        MapRAM(mode ? (bank2 & ram_bank_mask) : 0);
+    } else {
+        UnmapRAM();
+    }
+}
+
+void MapperMBC1::SaveState(StateWriter& state) const {
+    state(ram_enabled, bank1, bank2, mode);
+}
+
+void MapperMBC1::LoadState(StateReader& state) {
+    state(ram_enabled, bank1, bank2, mode);
+    UpdateMapping();
+}
+
+// =============================================================================
+// MBC1M
+// MBC1M carts are 1MB MBC1 carts with alternate wiring where BANK2 is connected
+// to bits 4-5 instead of 5-6.
+// See: https://gbdev.io/pandocs/MBC1.html#mbc1m-1-mib-multi-game-compilation-carts
+// =============================================================================
+
+void MapperMBC1M::UpdateMapping() {
+    MapROM(0, mode ? ((bank2 << 4) & rom_bank_mask) : 0);
+
+    // Full 5 bits used for 00→01 translation, but only the lower 4 bits bank
+    uint32_t bank = (bank1 == 0) ? 1 : bank1;
+    MapROM(1, ((bank & 0x0F) | (bank2 << 4)) & rom_bank_mask);
+
+    if (ram_enabled && !mem.ram.empty()) {
+        MapRAM(mode ? (bank2 & ram_bank_mask) : 0);
+    } else {
+        UnmapRAM();
+    }
+}
+
+// =============================================================================
+// MBC2
+// =============================================================================
+
+void MapperMBC2::ResetRegisters() {
+    ram_enabled = false;
+    rom_bank = 1;
+    MapROM(0, 0);
+    MapROM(1, rom_bank & rom_bank_mask);
+    UnmapRAM();  // 4-bit RAM always goes through ReadRAM/WriteRAM
+}
+
+void MapperMBC2::WriteROM(uint16_t addr, uint8_t value) {
+    if (addr >= 0x4000) {
+        return;
+    }
+    if (addr & 0x0100) {
+        // ROM Bank (bit 8 of address set): 4-bit, 00→01 translation
+        rom_bank = value & 0x0F;
+        if (rom_bank == 0) rom_bank = 1;
+        MapROM(1, rom_bank & rom_bank_mask);
+    } else {
+        // RAM Enable (bit 8 of address clear)
+        ram_enabled = ((value & 0x0F) == 0x0A);
+    }
+}
+
+uint8_t MapperMBC2::ReadRAM(uint16_t addr) {
+    if (!ram_enabled || mem.ram.empty()) {
+        return 0xFF;
+    }
+    // 512 bytes, mirrored via hardware AND gate; upper nibble is open bus
+    return mem.ram[(addr - 0xA000) & 0x1FF] | 0xF0;
+}
+
+void MapperMBC2::WriteRAM(uint16_t addr, uint8_t value) {
+    if (!ram_enabled || mem.ram.empty()) {
+        return;
+    }
+    mem.ram[(addr - 0xA000) & 0x1FF] = value & 0x0F;
+    mem.ram_dirty = true;
+}
+
+void MapperMBC2::SaveState(StateWriter& state) const {
+    state(ram_enabled, rom_bank);
+}
+
+void MapperMBC2::LoadState(StateReader& state) {
+    state(ram_enabled, rom_bank);
+    MapROM(1, rom_bank & rom_bank_mask);
+}
+
+// =============================================================================
+// MBC3 (+RTC)
+// =============================================================================
+
+MapperMBC3::MapperMBC3(CartridgeMemory& memory, bool has_rtc)
+    : Mapper(memory)
+    , has_rtc(has_rtc)
+{
+}
+
+void MapperMBC3::ResetRegisters() {
+    ram_enabled = false;
+    rom_bank = 1;
+    ram_bank = 0;
+    rtc_latch_register = 0;
+    UpdateMapping();
+}
+
+void MapperMBC3::WriteROM(uint16_t addr, uint8_t value) {
+    if (addr < 0x2000) {
+        // RAM/RTC Enable
+        ram_enabled = ((value & 0x0F) == 0x0A);
+    } else if (addr < 0x4000) {
+        // ROM Bank: 7-bit, 00→01 translation
+        rom_bank = value & 0x7F;
+        if (rom_bank == 0) rom_bank = 1;
+    } else if (addr < 0x6000) {
+        // RAM Bank / RTC Register Select
+        ram_bank = value;
+    } else {
+        // Latch Clock Data - writing 0 then 1 latches current RTC values
+        if (rtc_latch_register == 0 && value == 1) {
+            // Update RTC from system time before latching
+            UpdateRTC();
+            rtc_latched = rtc_real;
+        }
+        rtc_latch_register = value;
+        return;
+    }
+    UpdateMapping();
+}
+
+void MapperMBC3::UpdateMapping() {
+    MapROM(0, 0);
+    MapROM(1, rom_bank & rom_bank_mask);
+
+    // Selects $08-$0C go through ReadRAM/WriteRAM (RTC, or open bus without one)
+    bool rtc_selected = (ram_bank >= 0x08 && ram_bank <= 0x0C);
+    if (ram_enabled && !rtc_selected && !mem.ram.empty()) {
+        MapRAM(ram_bank & ram_bank_mask);
+    } else {
+        UnmapRAM();
+    }
+}
+
+uint8_t MapperMBC3::ReadRAM(uint16_t addr) {
+    // RTC registers stay reachable on RTC carts without RAM (type $0F)
+    if (!ram_enabled || (!has_rtc && mem.ram.empty())) {
+        return 0xFF;
+    }
+
+    if (!has_rtc && ram_bank >= 0x08 && ram_bank <= 0x0C) {
+        return 0xFF;  // No clock chip on this cart: RTC selects read open bus
+    }
+
+    // MBC3 RTC registers - read from LATCHED values (per hardware)
+    // Games latch the RTC, then read the frozen snapshot
+    switch (ram_bank) {
+        case 0x08: return rtc_latched.seconds;
+        case 0x09: return rtc_latched.minutes;
+        case 0x0A: return rtc_latched.hours;
+        case 0x0B: return rtc_latched.days_low;
+        case 0x0C: return rtc_latched.days_high;
+    }
+    return Mapper::ReadRAM(addr);
+}
+
+void MapperMBC3::WriteRAM(uint16_t addr, uint8_t value) {
+    if (!ram_enabled || (!has_rtc && mem.ram.empty())) {
+        return;
+    }
+
+    // MBC3 RTC registers - write to REAL values
+    // When game sets the clock, we update rtc_real and reset our time tracking
+    if (ram_bank >= 0x08 && ram_bank <= 0x0C) {
+        if (!has_rtc) return;
+        switch (ram_bank) {
+            case 0x08: rtc_real.seconds = value & 0x3F; break;  // 0-59
+            case 0x09: rtc_real.minutes = value & 0x3F; break;  // 0-59
+            case 0x0A: rtc_real.hours = value & 0x1F; break;    // 0-23
+            case 0x0B: rtc_real.days_low = value; break;
+            case 0x0C: rtc_real.days_high = value & 0xC1; break; // Only bits 0, 6, 7
+        }
+        last_rtc_second = std::time(nullptr);
+        mem.ram_dirty = true;  // RTC was modified
+        return;
+    }
+    Mapper::WriteRAM(addr, value);
+}
+
+// === RTC Time Sync ===
+// Updates RTC registers from system time elapsed since last sync
+void MapperMBC3::UpdateRTC() {
+    if (!has_rtc) return;
+
+    // Check if RTC is halted (bit 6 of days_high)
+    if (rtc_real.days_high & 0x40) return;
+
+    int64_t now = std::time(nullptr);
+    if (last_rtc_second == 0) {
+        // First time - just record current time
+        last_rtc_second = now;
+        return;
+    }
+
+    int64_t elapsed = now - last_rtc_second;
+    if (elapsed <= 0) return;
+
+    last_rtc_second = now;
+
+    // Add elapsed seconds to RTC
+    int64_t seconds = rtc_real.seconds + elapsed;
+    rtc_real.seconds = seconds % 60;
+
+    int64_t minutes = rtc_real.minutes + (seconds / 60);
+    rtc_real.minutes = minutes % 60;
+
+    int64_t hours = rtc_real.hours + (minutes / 60);
+    rtc_real.hours = hours % 24;
+
+    int64_t days = ((rtc_real.days_high & 0x01) << 8) | rtc_real.days_low;
+    days += hours / 24;
+
+    rtc_real.days_low = days & 0xFF;
+    rtc_real.days_high = (rtc_real.days_high & 0xC0) | ((days >> 8) & 0x01);
+
+    // Day counter overflow (> 511 days)
+    if (days > 511) {
+        rtc_real.days_high |= 0x80;  // Set carry flag
+        rtc_real.days_low = 0;
+        rtc_real.days_high &= ~0x01; // Clear day MSB
+    }
+}
+
+// RTC save structure (VBA-compatible 64-bit timestamp format)
+#pragma pack(push, 1)
+struct RTCSaveData {
+    uint8_t seconds;
+    uint8_t padding1[3];
+    uint8_t minutes;
+    uint8_t padding2[3];
+    uint8_t hours;
+    uint8_t padding3[3];
+    uint8_t days;
+    uint8_t padding4[3];
+    uint8_t high;
+    uint8_t padding5[3];
+    // Latched values
+    uint8_t latched_seconds;
+    uint8_t lpadding1[3];
+    uint8_t latched_minutes;
+    uint8_t lpadding2[3];
+    uint8_t latched_hours;
+    uint8_t lpadding3[3];
+    uint8_t latched_days;
+    uint8_t lpadding4[3];
+    uint8_t latched_high;
+    uint8_t lpadding5[3];
+    // Timestamp
+    int64_t last_rtc_second;
+};
+#pragma pack(pop)
+
+void MapperMBC3::LoadExtra(std::istream& in) {
+    if (!has_rtc) return;
+
+    RTCSaveData rtc_save = {};
+    in.read(reinterpret_cast<char*>(&rtc_save), sizeof(rtc_save));
+
+    rtc_real.seconds = rtc_save.seconds;
+    rtc_real.minutes = rtc_save.minutes;
+    rtc_real.hours = rtc_save.hours;
+    rtc_real.days_low = rtc_save.days;
+    rtc_real.days_high = rtc_save.high;
+
+    rtc_latched.seconds = rtc_save.latched_seconds;
+    rtc_latched.minutes = rtc_save.latched_minutes;
+    rtc_latched.hours = rtc_save.latched_hours;
+    rtc_latched.days_low = rtc_save.latched_days;
+    rtc_latched.days_high = rtc_save.latched_high;
+
+    last_rtc_second = rtc_save.last_rtc_second;
+
+    // Update RTC to current time if save is from the past
+    if (last_rtc_second > 0 && last_rtc_second < std::time(nullptr)) {
+        UpdateRTC();
+    }
+}
+
+void MapperMBC3::SaveExtra(std::ostream& out) {
+    if (!has_rtc) return;
+
+    // Sync RTC before saving
+    UpdateRTC();
+
+    RTCSaveData rtc_save = {};
+    rtc_save.seconds = rtc_real.seconds;
+    rtc_save.minutes = rtc_real.minutes;
+    rtc_save.hours = rtc_real.hours;
+    rtc_save.days = rtc_real.days_low;
+    rtc_save.high = rtc_real.days_high;
+
+    rtc_save.latched_seconds = rtc_latched.seconds;
+    rtc_save.latched_minutes = rtc_latched.minutes;
+    rtc_save.latched_hours = rtc_latched.hours;
+    rtc_save.latched_days = rtc_latched.days_low;
+    rtc_save.latched_high = rtc_latched.days_high;
+
+    rtc_save.last_rtc_second = last_rtc_second;
+
+    out.write(reinterpret_cast<const char*>(&rtc_save), sizeof(rtc_save));
+}
+
+void MapperMBC3::SaveState(StateWriter& state) const {
+    state(ram_enabled, rom_bank, ram_bank, rtc_latch_register);
+    state(rtc_real, rtc_latched, last_rtc_second);
+}
+
+void MapperMBC3::LoadState(StateReader& state) {
+    state(ram_enabled, rom_bank, ram_bank, rtc_latch_register);
+    state(rtc_real, rtc_latched, last_rtc_second);
+    UpdateMapping();
+}
+
+// =============================================================================
+// MBC5
+// =============================================================================
+
+void MapperMBC5::ResetRegisters() {
+    ram_enabled = false;
+    rom_bank = 1;
+    ram_bank = 0;
+    UpdateMapping();
+}
+
+void MapperMBC5::WriteROM(uint16_t addr, uint8_t value) {
+    if (addr < 0x2000) {
+        // RAM Enable
+        ram_enabled = ((value & 0x0F) == 0x0A);
+    } else if (addr < 0x3000) {
+        // ROM Bank Low 8 bits
+        rom_bank = (rom_bank & 0x100) | value;
+    } else if (addr < 0x4000) {
+        // ROM Bank High bit
+        rom_bank = (rom_bank & 0xFF) | ((value & 0x01) << 8);
+    } else if (addr < 0x6000) {
+        // RAM Bank (bit 3 drives the rumble motor on rumble carts)
+        ram_bank = value & 0x0F;
+    } else {
+        return;
+    }
+    UpdateMapping();
+}
+
+void MapperMBC5::UpdateMapping() {
+    MapROM(0, 0);
+    MapROM(1, rom_bank & rom_bank_mask);
+
+    if (ram_enabled && !mem.ram.empty()) {
+        MapRAM(ram_bank & ram_bank_mask);
+    } else {
+        UnmapRAM();
+    }
+}
+
+void MapperMBC5::SaveState(StateWriter& state) const {
+    state(ram_enabled, rom_bank, ram_bank);
+}
+
+void MapperMBC5::LoadState(StateReader& state) {
+    state(ram_enabled, rom_bank, ram_bank);
+    UpdateMapping();
+}
+
+// =============================================================================
+// MMM01
+// Per Pan Docs: powers up "unmapped" with the last 32 KB (the menu) visible.
+// The menu programs the outer bank bits and masks, then sets the map-enable
+// bit, after which those bits are locked and the cart behaves like an MBC1
+// confined to the selected game.
+// =============================================================================
+
+void MapperMMM01::ResetRegisters() {
+    mapped = false;
+    ram_enabled = false;
+    rom_bank_low = 0;
+    rom_bank_mid = 0;
+    rom_bank_high = 0;
+    rom_bank_protect = 0;
+    ram_bank_low = 0;
+    ram_bank_high = 0;
+    ram_bank_protect = 0;
+    mode = false;
+    mode_locked = false;
+    multiplex = false;
+    UpdateMapping();
+}
+
+void MapperMMM01::WriteROM(uint16_t addr, uint8_t value) {
+    if (addr < 0x2000) {
+        // RAM enable; while unmapped also RAM bank protect (bits 4-5) and map enable (bit 6)
+        ram_enabled = ((value & 0x0F) == 0x0A);
+        if (!mapped) {
+            ram_bank_protect = (value >> 4) & 0x03;
+            mapped = (value & 0x40) != 0;
+        }
+    } else if (addr < 0x4000) {
+        // RB0-4, with protected bits frozen once mapped; RB5-6 only while unmapped
+        uint8_t locked = mapped ? (rom_bank_protect << 1) : 0;
+        rom_bank_low = (rom_bank_low & locked) | (value & 0x1F & ~locked);
+        if (!mapped) {
+            rom_bank_mid = (value >> 5) & 0x03;
+        }
+    } else if (addr < 0x6000) {
+        // RAM bank bits 0-1; while unmapped also RAM bits 2-3, RB7-8 and mode lock
+        uint8_t locked = mapped ? ram_bank_protect : 0;
+        ram_bank_low = (ram_bank_low & locked) | (value & 0x03 & ~locked);
+        if (!mapped) {
+            ram_bank_high = (value >> 2) & 0x03;
+            rom_bank_high = (value >> 4) & 0x03;
+            mode_locked = (value & 0x40) != 0;
+        }
+    } else {
+        // Banking mode; while unmapped also RB1-4 protect mask and multiplex
+        if (!mode_locked) {
+            mode = (value & 0x01) != 0;
+        }
+        if (!mapped) {
+            rom_bank_protect = (value >> 2) & 0x0F;
+            multiplex = (value & 0x40) != 0;
+        }
+    }
+    UpdateMapping();
+}
+
+void MapperMMM01::UpdateMapping() {
+    if (!mapped) {
+        // Menu mode: all outer bank lines high, last 32 KB visible
+        MapROM(0, 0x1FE & rom_bank_mask);
+        MapROM(1, 0x1FF & rom_bank_mask);
+        UnmapRAM();
+        return;
+    }
+
+    // Multiplex swaps which register drives RB5-6 and RAM bank bits 0-1
+    uint8_t rom_mid = multiplex ? ram_bank_low : rom_bank_mid;
+    uint8_t ram_low = multiplex ? rom_bank_mid : ram_bank_low;
+    uint32_t outer = (rom_mid << 5) | (rom_bank_high << 7);
+
+    // $0000-$3FFF: only the frozen bits of RB1-4 (game base) are kept
+    uint8_t locked = rom_bank_protect << 1;
+    MapROM(0, ((rom_bank_low & locked) | outer) & rom_bank_mask);
+
+    // $4000-$7FFF: 00→01 translation applies to the writable bits only
+    uint32_t low = rom_bank_low;
+    if ((low & ~locked & 0x1F) == 0) low |= 1;
+    MapROM(1, (low | outer) & rom_bank_mask);
+
+    if (ram_enabled && !mem.ram.empty()) {
+        MapRAM(((ram_bank_high << 2) | (mode ? ram_low : 0)) & ram_bank_mask);
+    } else {
+        UnmapRAM();
+    }
+}
+
+void MapperMMM01::SaveState(StateWriter& state) const {
+    state(mapped, ram_enabled, rom_bank_low, rom_bank_mid, rom_bank_high, rom_bank_protect);
+    state(ram_bank_low, ram_bank_high, ram_bank_protect, mode, mode_locked, multiplex);
+}
+
+void MapperMMM01::LoadState(StateReader& state) {
+    state(mapped, ram_enabled, rom_bank_low, rom_bank_mid, rom_bank_high, rom_bank_protect);
+    state(ram_bank_low, ram_bank_high, ram_bank_protect, mode, mode_locked, multiplex);
+    UpdateMapping();
+}
+
+// =============================================================================
+// HuC1
+// Like a simplified MBC1 (no RAM enable); $0E in $0000-$1FFF switches the
+// RAM area to the infrared port.
+// =============================================================================
+
+void MapperHuC1::ResetRegisters() {
+    ir_mode = false;
+    rom_bank = 1;
+    ram_bank = 0;
+    UpdateMapping();
+}
+
+void MapperHuC1::WriteROM(uint16_t addr, uint8_t value) {
+    if (addr < 0x2000) {
+        ir_mode = ((value & 0x0F) == 0x0E);
+    } else if (addr < 0x4000) {
+        rom_bank = value & 0x3F;  // 6-bit, no 00→01 translation
+    } else if (addr < 0x6000) {
+        ram_bank = value & 0x03;
+    } else {
+        return;
+    }
+    UpdateMapping();
+}
+
+void MapperHuC1::UpdateMapping() {
+    MapROM(0, 0);
+    MapROM(1, rom_bank & rom_bank_mask);
+
+    if (!ir_mode && !mem.ram.empty()) {
+        MapRAM(ram_bank & ram_bank_mask);
+    } else {
+        UnmapRAM();
+    }
+}
+
+uint8_t MapperHuC1::ReadRAM(uint16_t addr) {
+    if (ir_mode) {
+        return 0xC0;  // IR receiver: no light detected
+    }
+    return Mapper::ReadRAM(addr);
+}
+
+void MapperHuC1::WriteRAM(uint16_t addr, uint8_t value) {
+    if (ir_mode) {
+        return;  // IR LED (no link partner)
+    }
+    Mapper::WriteRAM(addr, value);
+}
+
+void MapperHuC1::SaveState(StateWriter& state) const {
+    state(ir_mode, rom_bank, ram_bank);
+}
+
+void MapperHuC1::LoadState(StateReader& state) {
+    state(ir_mode, rom_bank, ram_bank);
+    UpdateMapping();
+}
+
+// =============================================================================
+// HuC3
+// $0000-$1FFF selects what $A000-$BFFF talks to. The RTC is driven through a
+// nibble-wide command port: commands read/write a 256-nibble register file at
+// access_index, and extended commands copy the clock in or out of it
+// (nibbles 0-2: minute of day, 3-5: day counter).
+// =============================================================================
+
+void MapperHuC3::ResetRegisters() {
+    mode = 0;
+    rom_bank = 1;
+    ram_bank = 0;
+    access_index = 0;
+    result = 0;
+    UpdateMapping();
+}
+
+void MapperHuC3::WriteROM(uint16_t addr, uint8_t value) {
+    if (addr < 0x2000) {
+        mode = value & 0x0F;
+    } else if (addr < 0x4000) {
+        rom_bank = value & 0x7F;
+    } else if (addr < 0x6000) {
+        ram_bank = value & 0x0F;
+    } else {
+        return;
+    }
+    UpdateMapping();
+}
+
+void MapperHuC3::UpdateMapping() {
+    MapROM(0, 0);
+    MapROM(1, rom_bank & rom_bank_mask);
+
+    if ((mode == 0x0 || mode == 0x0A) && !mem.ram.empty()) {
+        MapRAM(ram_bank & ram_bank_mask);
+        if (mode == 0x0) {
+            RouteRAMToMapper();  // Mode 0 is read-only RAM
+        }
+    } else {
+        UnmapRAM();
+    }
+}
+
+uint8_t MapperHuC3::ReadRAM(uint16_t addr) {
+    switch (mode) {
+        case 0x0:
+        case 0xA: return Mapper::ReadRAM(addr);
+        case 0xC: return result;
+        case 0xD: return 0x01;  // Semaphore: command finished
+        case 0xE: return 0xC0;  // IR receiver: no light detected
+        default:  return 0xFF;
+    }
+}
+
+void MapperHuC3::WriteRAM(uint16_t addr, uint8_t value) {
+    switch (mode) {
+        case 0xA: Mapper::WriteRAM(addr, value); break;
+        case 0xB: ExecuteCommand(value); break;
+        default:  break;  // Read-only RAM, semaphore release, IR LED
+    }
+}
+
+void MapperHuC3::ExecuteCommand(uint8_t value) {
+    uint8_t arg = value & 0x0F;
+    result = value & 0xF0;
+
+    switch (value >> 4) {
+        case 0x1:  // Read nibble, post-increment
+            result |= nibbles[access_index++] & 0x0F;
+            break;
+        case 0x3:  // Write nibble, post-increment
+            nibbles[access_index++] = arg;
+            mem.ram_dirty = true;
+            break;
+        case 0x4:  // Set access index low nibble
+            access_index = (access_index & 0xF0) | arg;
+            break;
+        case 0x5:  // Set access index high nibble
+            access_index = (access_index & 0x0F) | (arg << 4);
+            break;
+        case 0x6:  // Extended command
+            if (arg == 0x0) {
+                // Copy clock to register file
+                UpdateRTC();
+                for (int i = 0; i < 3; i++) {
+                    nibbles[i] = (minutes >> (i * 4)) & 0x0F;
+                    nibbles[3 + i] = (days >> (i * 4)) & 0x0F;
+                }
+            } else if (arg == 0x1) {
+                // Copy register file to clock
+                minutes = 0;
+                days = 0;
+                for (int i = 0; i < 3; i++) {
+                    minutes |= (nibbles[i] & 0x0F) << (i * 4);
+                    days |= (nibbles[3 + i] & 0x0F) << (i * 4);
+                }
+                minutes %= 1440;
+                last_rtc_second = std::time(nullptr);
+                mem.ram_dirty = true;
+            } else if (arg == 0x2) {
+                result |= 0x01;  // Status: clock running
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void MapperHuC3::UpdateRTC() {
+    int64_t now = std::time(nullptr);
+    if (last_rtc_second == 0) {
+        last_rtc_second = now;
+        return;
+    }
+
+    int64_t elapsed_minutes = (now - last_rtc_second) / 60;
+    if (elapsed_minutes <= 0) return;
+
+    // Keep the sub-minute remainder for the next sync
+    last_rtc_second += elapsed_minutes * 60;
+
+    int64_t total = minutes + elapsed_minutes;
+    minutes = total % 1440;
+    days = (days + total / 1440) & 0x0FFF;
+}
+
+// HuC3 clock save: minute of day, day counter, sync timestamp
+#pragma pack(push, 1)
+struct HuC3SaveData {
+    uint16_t minutes;
+    uint16_t days;
+    int64_t last_rtc_second;
+};
+#pragma pack(pop)
+
+void MapperHuC3::LoadExtra(std::istream& in) {
+    HuC3SaveData save = {};
+    in.read(reinterpret_cast<char*>(&save), sizeof(save));
+    minutes = save.minutes % 1440;
+    days = save.days & 0x0FFF;
+    last_rtc_second = save.last_rtc_second;
+    UpdateRTC();
+}
+
+void MapperHuC3::SaveExtra(std::ostream& out) {
+    UpdateRTC();
+    HuC3SaveData save = {};
+    save.minutes = minutes;
+    save.days = days;
+    save.last_rtc_second = last_rtc_second;
+    out.write(reinterpret_cast<const char*>(&save), sizeof(save));
+}
+
+void MapperHuC3::SaveState(StateWriter& state) const {
+    state(mode, rom_bank, ram_bank, access_index, result);
+    state(minutes, days, last_rtc_second, nibbles);
+}
+
+void MapperHuC3::LoadState(StateReader& state) {
+    state(mode, rom_bank, ram_bank, access_index, result);
+    state(minutes, days, last_rtc_second, nibbles);
+    UpdateMapping();
+}
+
+// =============================================================================
+// MBC6
+// Two independently banked 8 KB ROM windows ($4000/$6000), each of which can
+// map the 1 MB flash chip instead, and two 4 KB RAM windows ($A000/$B000).
+// Flash is modelled read-only in its erased state (no program/erase commands),
+// so every flash bank is the shared open bus page: nothing per instance to
+// hold or put in save states.
+// =============================================================================
+
+void MapperMBC6::ResetRegisters() {
+    ram_enabled = false;
+    rom_bank[0] = 2;
+    rom_bank[1] = 3;
+    flash_select[0] = flash_select[1] = false;
+    ram_bank[0] = 0;
+    ram_bank[1] = 1;
+    UpdateMapping();
+}
+
+void MapperMBC6::WriteROM(uint16_t addr, uint8_t value) {
+    if (addr < 0x0400) {
+        ram_enabled = ((value & 0x0F) == 0x0A);
+    } else if (addr < 0x0800) {
+        ram_bank[0] = value;
+    } else if (addr < 0x0C00) {
+        ram_bank[1] = value;
+    } else if (addr < 0x2000) {
+        return;  // Flash enable / write enable (flash is read-only here)
+    } else if (addr < 0x2800) {
+        rom_bank[0] = value;
+    } else if (addr < 0x3000) {
+        flash_select[0] = (value == 0x08);
+    } else if (addr < 0x3800) {
+        rom_bank[1] = value;
+    } else if (addr < 0x4000) {
+        flash_select[1] = (value == 0x08);
+    } else {
+        return;
+    }
+    UpdateMapping();
+}
+
+void MapperMBC6::UpdateMapping() {
+    MapROM(0, 0);
+
+    uint32_t rom_8k_mask = rom_bank_mask * 2 + 1;
+    for (uint8_t w = 0; w < 2; w++) {
+        if (flash_select[w]) {
+            mem.rom_map[2 + w] = OPEN_BUS_PAGE.data();
+        } else {
+            MapROM8K(2 + w, rom_bank[w] & rom_8k_mask);
+        }
+    }
+
+    if (ram_enabled && !mem.ram.empty()) {
+        uint32_t ram_4k_mask = static_cast<uint32_t>(mem.ram.size() / 0x1000) - 1;
+        MapRAM4K(0, ram_bank[0] & ram_4k_mask);
+        MapRAM4K(1, ram_bank[1] & ram_4k_mask);
+    } else {
+        UnmapRAM();
+    }
+}
+
+void MapperMBC6::SaveState(StateWriter& state) const {
+    state(ram_enabled, rom_bank, flash_select, ram_bank);
+}
+
+void MapperMBC6::LoadState(StateReader& state) {
+    state(ram_enabled, rom_bank, flash_select, ram_bank);
+    UpdateMapping();
+}
+
+// =============================================================================
+// MBC7
+// $A000-$AFFF exposes the accelerometer latch and the 93LC56 EEPROM pins
+// (bit 7 CS, bit 6 CLK, bit 1 DI, bit 0 DO). The EEPROM (128 x 16-bit) is
+// stored in mem.ram so it is saved like battery RAM.
+// See: https://gbdev.io/pandocs/MBC7.html
+// =============================================================================
+
+static constexpr uint16_t MBC7_ACCEL_CENTER = 0x81D0;
+static constexpr uint16_t MBC7_ACCEL_ERASED = 0x8000;
+
+void MapperMBC7::ResetRegisters() {
+    ram_enabled_1 = false;
+    ram_enabled_2 = false;
+    rom_bank = 1;
+
+    accel_x = accel_y = MBC7_ACCEL_ERASED;
+    accel_erased = false;
+
+    eeprom_cs = eeprom_clk = eeprom_di = false;
+    eeprom_do = true;
+    eeprom_write_enabled = false;
+    eeprom_command = 0;
+    eeprom_command_bits = 0;
+    eeprom_data = 0;
+    eeprom_data_bits = 0;
+    eeprom_reading = false;
+
+    UpdateMapping();
+}
+
+void MapperMBC7::WriteROM(uint16_t addr, uint8_t value) {
+    if (addr < 0x2000) {
+        ram_enabled_1 = ((value & 0x0F) == 0x0A);
+    } else if (addr < 0x4000) {
+        rom_bank = value & 0x7F;
+        UpdateMapping();
+    } else if (addr < 0x6000) {
+        ram_enabled_2 = (value == 0x40);
+    }
+}
+
+void MapperMBC7::UpdateMapping() {
+    MapROM(0, 0);
+    MapROM(1, rom_bank & rom_bank_mask);
+    UnmapRAM();  // Sensor/EEPROM registers always go through ReadRAM/WriteRAM
+}
+
+uint8_t MapperMBC7::ReadRAM(uint16_t addr) {
+    if (!ram_enabled_1 || !ram_enabled_2 || addr >= 0xB000) {
+        return 0xFF;
+    }
+    switch ((addr >> 4) & 0x0F) {
+        case 0x2: return accel_x & 0xFF;
+        case 0x3: return accel_x >> 8;
+        case 0x4: return accel_y & 0xFF;
+        case 0x5: return accel_y >> 8;
+        case 0x6: return 0x00;
+        case 0x8:
+            return (eeprom_cs ? 0x80 : 0) | (eeprom_clk ? 0x40 : 0) |
+                   (eeprom_di ? 0x02 : 0) | (eeprom_do ? 0x01 : 0);
+        default:  return 0xFF;
+    }
+}
+
+void MapperMBC7::WriteRAM(uint16_t addr, uint8_t value) {
+    if (!ram_enabled_1 || !ram_enabled_2 || addr >= 0xB000) {
+        return;
+    }
+    switch ((addr >> 4) & 0x0F) {
+        case 0x0:
+            // Erase latched accelerometer values
+            if (value == 0x55) {
+                accel_x = accel_y = MBC7_ACCEL_ERASED;
+                accel_erased = true;
+            }
+            break;
+        case 0x1:
+            // Latch accelerometer (no tilt input: resting position)
+            if (value == 0xAA && accel_erased) {
+                accel_x = accel_y = MBC7_ACCEL_CENTER;
+                accel_erased = false;
+            }
+            break;
+        case 0x8: {
+            bool clk = (value & 0x40) != 0;
+            eeprom_cs = (value & 0x80) != 0;
+            eeprom_di = (value & 0x02) != 0;
+            if (!eeprom_cs) {
+                // Deselect aborts any command in progress
+                eeprom_command = 0;
+                eeprom_command_bits = 0;
+                eeprom_data_bits = 0;
+                eeprom_reading = false;
+            } else if (clk && !eeprom_clk) {
+                ClockEEPROM();  // Rising edge
+            }
+            eeprom_clk = clk;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void MapperMBC7::WriteEEPROMWord(uint8_t word, uint16_t value) {
+    mem.ram[word * 2] = value & 0xFF;
+    mem.ram[word * 2 + 1] = value >> 8;
+    mem.ram_dirty = true;
+}
+
+void MapperMBC7::ClockEEPROM() {
+    // Shifting data out (READ): MSB first, one bit per rising edge
+    if (eeprom_reading) {
+        eeprom_do = (eeprom_data & 0x8000) != 0;
+        eeprom_data <<= 1;
+        if (--eeprom_data_bits == 0) {
+            eeprom_reading = false;
+        }
+        return;
+    }
+
+    // Shifting data in (WRITE / WRAL)
+    if (eeprom_data_bits > 0) {
+        eeprom_data = (eeprom_data << 1) | (eeprom_di ? 1 : 0);
+        if (--eeprom_data_bits == 0) {
+            if (eeprom_write_enabled) {
+                if ((eeprom_command >> 8) & 0x03) {
+                    WriteEEPROMWord(eeprom_command & 0x7F, eeprom_data);       // WRITE
+                } else {
+                    for (uint8_t i = 0; i < 128; i++) WriteEEPROMWord(i, eeprom_data);  // WRAL
+                }
+            }
+            eeprom_do = true;  // Ready
+            eeprom_command = 0;
+            eeprom_command_bits = 0;
+        }
+        return;
+    }
+
+    // Command: start bit (1), 2-bit opcode, 8-bit address (A7 ignored)
+    if (eeprom_command_bits == 0 && !eeprom_di) {
+        return;  // Waiting for start bit
+    }
+    eeprom_command = (eeprom_command << 1) | (eeprom_di ? 1 : 0);
+    if (++eeprom_command_bits < 11) {
+        return;
+    }
+
+    uint8_t word = eeprom_command & 0x7F;
+    bool done = true;
+    switch ((eeprom_command >> 8) & 0x03) {
+        case 0x2:  // READ: dummy 0 bit, then 16 data bits
+            eeprom_data = mem.ram[word * 2] | (mem.ram[word * 2 + 1] << 8);
+            eeprom_data_bits = 16;
+            eeprom_reading = true;
+            eeprom_do = false;
+            break;
+        case 0x1:  // WRITE: 16 data bits follow
+            eeprom_data = 0;
+            eeprom_data_bits = 16;
+            done = false;
+            break;
+        case 0x3:  // ERASE
+            if (eeprom_write_enabled) WriteEEPROMWord(word, 0xFFFF);
+            eeprom_do = true;
+            break;
+        case 0x0:
+            switch ((eeprom_command >> 6) & 0x03) {
+                case 0x0: eeprom_write_enabled = false; break;  // EWDS
+                case 0x1:                                       // WRAL
+                    eeprom_data = 0;
+                    eeprom_data_bits = 16;
+                    done = false;
+                    break;
+                case 0x2:                                       // ERAL
+                    if (eeprom_write_enabled) {
+                        for (uint8_t i = 0; i < 128; i++) WriteEEPROMWord(i, 0xFFFF);
+                    }
+                    eeprom_do = true;
+                    break;
+                case 0x3: eeprom_write_enabled = true; break;   // EWEN
+            }
+            break;
+    }
+    if (done) {
+        eeprom_command = 0;
+        eeprom_command_bits = 0;
+    }
+}
+
+void MapperMBC7::SaveState(StateWriter& state) const {
+    state(ram_enabled_1, ram_enabled_2, rom_bank, accel_x, accel_y, accel_erased);
+    state(eeprom_cs, eeprom_clk, eeprom_di, eeprom_do, eeprom_write_enabled);
+    state(eeprom_command, eeprom_command_bits, eeprom_data, eeprom_data_bits, eeprom_reading);
+}
+
+void MapperMBC7::LoadState(StateReader& state) {
+    state(ram_enabled_1, ram_enabled_2, rom_bank, accel_x, accel_y, accel_erased);
+    state(eeprom_cs, eeprom_clk, eeprom_di, eeprom_do, eeprom_write_enabled);
+    state(eeprom_command, eeprom_command_bits, eeprom_data, eeprom_data_bits, eeprom_reading);
+    UpdateMapping();
+}
+
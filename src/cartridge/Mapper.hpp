@@ -0,0 +1,348 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <iosfwd>
+#include <memory>
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
+
+/**
+ * CartridgeMemory - ROM/RAM Chips and the Address Windows the MBC Drives
+ *
+ * Hardware Behavior:
+ * - The MBC only decodes the upper address lines and drives the bank lines
+ *   of the ROM/RAM chips; the lower lines go straight through
+ * - Modelled as a set of window pointers: the mapper recomputes them when a
+ *   bank register is written, and reads go straight through the window
+ *
+ * Windows:
+ * - rom_map: 4 x 8 KB windows covering $0000-$7FFF (always valid)
+ * - ram_map: 2 x 4 KB windows covering $A000-$BFFF
+ *   (nullptr = access goes through the mapper: disabled RAM, RTC, sensors...)
+ */
+struct CartridgeMemory {
+    std::shared_ptr<const std::vector<uint8_t>> rom;   // Read-only, shared by instances of one file
+    std::vector<uint8_t> ram;
+    std::array<const uint8_t*, 4> rom_map = {};
+    std::array<uint8_t*, 2> ram_map = {};
+    uint16_t rom_banks = 2;   // 16 KB bank count (source of the bank AND mask)
+    bool ram_dirty = false;   // RAM modified since last save
+};
+
+/**
+ * Mapper - Memory Bank Controller Base
+ *
+ * Hardware Behavior:
+ * - Writes to $0000-$7FFF hit the MBC's registers (ROM is read-only)
+ * - Register writes update bank lines; the windows are rebuilt only then
+ * - RAM area accesses that are not plain banked RAM (RTC registers, MBC2's
+ *   4-bit RAM, sensors, EEPROM) are handled by the concrete mapper
+ *
+ * Interface:
+ * - Reset() - recompute bank masks, then power-on register state
+ * - WriteROM() - MBC register writes ($0000-$7FFF)
+ * - ReadRAM()/WriteRAM() - $A000-$BFFF accesses not served by a RAM window
+ * - LoadExtra()/SaveExtra() - mapper data appended to the .sav file (RTC)
+ * - SaveState()/LoadState() - registers for save states; loading rebuilds
+ *   the windows
+ */
+class Mapper : public ArenaAllocated {
+public:
+    explicit Mapper(CartridgeMemory& memory);
+    virtual ~Mapper() = default;
+
+    virtual const char* GetName() const = 0;
+    void Reset();
+    virtual void WriteROM(uint16_t addr, uint8_t value) = 0;
+    virtual uint8_t ReadRAM(uint16_t addr);
+    virtual void WriteRAM(uint16_t addr, uint8_t value);
+
+    // Extra battery-backed state stored after RAM in the save file
+    virtual void LoadExtra(std::istream&) {}
+    virtual void SaveExtra(std::ostream&) {}
+
+    // Bank registers and other volatile state (save states)
+    virtual void SaveState(StateWriter&) const {}
+    virtual void LoadState(StateReader&) {}
+
+    // RAM size in bytes (some MBCs ignore the header value)
+    virtual size_t GetRAMSize(size_t header_ram_size) const { return header_ram_size; }
+
+    // Save storage it owns besides mem.ram, in bytes (footprint report)
+    virtual size_t GetStorageFootprint() const { return 0; }
+
+protected:
+    CartridgeMemory& mem;
+    uint16_t rom_bank_mask;         // 16 KB bank AND mask (hardware AND gates)
+    uint16_t ram_bank_mask;         // 8 KB bank AND mask
+
+    // === Window Mapping (called when bank registers change) ===
+    void MapROM(uint8_t slot, uint32_t bank);          // 16 KB slot 0/1
+    void MapROM8K(uint8_t window, uint32_t bank);      // 8 KB window 0-3
+    void MapRAM(uint32_t bank);                        // 8 KB bank to $A000-$BFFF
+    void MapRAM4K(uint8_t window, uint32_t bank);      // 4 KB bank to window 0/1
+    void UnmapRAM();                                   // Reads $FF, writes ignored
+    void RouteRAMToMapper();                           // Keep offsets, bypass windows
+
+    // Offset of each 4 KB RAM window into mem.ram (used by the slow path)
+    std::array<uint32_t, 2> ram_window_offset;
+    bool ram_mapped;
+
+    // Power-on register state and initial mapping
+    virtual void ResetRegisters() = 0;
+};
+
+// === ROM Only (with optional RAM, types $00/$08/$09) ===
+class MapperROMOnly : public Mapper {
+public:
+    using Mapper::Mapper;
+    const char* GetName() const override { return "No MBC"; }
+    void ResetRegisters() override;
+    void WriteROM(uint16_t, uint8_t) override {}
+};
+
+// === MBC1 (types $01-$03) ===
+class MapperMBC1 : public Mapper {
+public:
+    using Mapper::Mapper;
+    const char* GetName() const override { return "MBC1"; }
+    void ResetRegisters() override;
+    void WriteROM(uint16_t addr, uint8_t value) override;
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+protected:
+    bool ram_enabled;
+    uint8_t bank1;          // $2000-$3FFF: 5-bit BANK1 register
+    uint8_t bank2;          // $4000-$5FFF: 2-bit BANK2 register
+    bool mode;              // $6000-$7FFF: banking mode
+
+    virtual void UpdateMapping();
+};
+
+// === MBC1M (1 MB multicart wiring: BANK2 drives bank bits 4-5) ===
+class MapperMBC1M : public MapperMBC1 {
+public:
+    using MapperMBC1::MapperMBC1;
+    const char* GetName() const override { return "MBC1M (multicart)"; }
+
+protected:
+    void UpdateMapping() override;
+};
+
+// === MBC2 (types $05/$06, built-in 512 x 4-bit RAM) ===
+class MapperMBC2 : public Mapper {
+public:
+    using Mapper::Mapper;
+    const char* GetName() const override { return "MBC2"; }
+    void ResetRegisters() override;
+    void WriteROM(uint16_t addr, uint8_t value) override;
+    uint8_t ReadRAM(uint16_t addr) override;
+    void WriteRAM(uint16_t addr, uint8_t value) override;
+    size_t GetRAMSize(size_t) const override { return 512; }
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+private:
+    bool ram_enabled;
+    uint8_t rom_bank;
+};
+
+// === MBC3 (types $0F-$13, optional RTC) ===
+class MapperMBC3 : public Mapper {
+public:
+    MapperMBC3(CartridgeMemory& memory, bool has_rtc);
+    const char* GetName() const override { return has_rtc ? "MBC3+RTC" : "MBC3"; }
+    void ResetRegisters() override;
+    void WriteROM(uint16_t addr, uint8_t value) override;
+    uint8_t ReadRAM(uint16_t addr) override;
+    void WriteRAM(uint16_t addr, uint8_t value) override;
+    void LoadExtra(std::istream& in) override;
+    void SaveExtra(std::ostream& out) override;
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+private:
+    bool has_rtc;
+    bool ram_enabled;
+    uint8_t rom_bank;
+    uint8_t ram_bank;       // 0-3: RAM bank, $08-$0C: RTC register select (RTC carts)
+
+    // Per hardware: RTC runs from real system time, latched values frozen when latch triggered
+    struct RTCRegisters {
+        uint8_t seconds;    // 0-59
+        uint8_t minutes;    // 0-59
+        uint8_t hours;      // 0-23
+        uint8_t days_low;   // Lower 8 bits of day counter
+        uint8_t days_high;  // Bit 0: Day counter MSB, Bit 6: Halt, Bit 7: Day carry
+    };
+    RTCRegisters rtc_real = {};     // Current RTC values (synced with system time)
+    RTCRegisters rtc_latched = {};  // Latched values (frozen on latch)
+    int64_t last_rtc_second = 0;    // Unix timestamp when RTC was last synced
+    uint8_t rtc_latch_register; // For detecting 0->1 latch transition
+
+    void UpdateMapping();
+    void UpdateRTC();
+};
+
+// === MBC5 (types $19-$1E) ===
+class MapperMBC5 : public Mapper {
+public:
+    using Mapper::Mapper;
+    const char* GetName() const override { return "MBC5"; }
+    void ResetRegisters() override;
+    void WriteROM(uint16_t addr, uint8_t value) override;
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+private:
+    bool ram_enabled;
+    uint16_t rom_bank;      // 9-bit, bank 0 IS selectable
+    uint8_t ram_bank;
+
+    void UpdateMapping();
+};
+
+// === MMM01 (types $0B-$0D, multi-game menu mapper) ===
+class MapperMMM01 : public Mapper {
+public:
+    using Mapper::Mapper;
+    const char* GetName() const override { return "MMM01"; }
+    void ResetRegisters() override;
+    void WriteROM(uint16_t addr, uint8_t value) override;
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+private:
+    bool mapped;            // Leaves "unmapped" (menu) mode once set, then locked
+    bool ram_enabled;
+    uint8_t rom_bank_low;   // RB0-4
+    uint8_t rom_bank_mid;   // RB5-6 (write-locked once mapped)
+    uint8_t rom_bank_high;  // RB7-8 (write-locked once mapped)
+    uint8_t rom_bank_protect;  // Bits of RB1-4 frozen once mapped ($6000 bits 2-5)
+    uint8_t ram_bank_low;   // RAM bank bits 0-1
+    uint8_t ram_bank_high;  // RAM bank bits 2-3 (write-locked once mapped)
+    uint8_t ram_bank_protect;  // RAM bank bits 0-1 frozen once mapped ($0000 bits 4-5)
+    bool mode;              // MBC1-style banking mode
+    bool mode_locked;
+    bool multiplex;         // Swap RB5-6 with RAM bank bits 0-1
+
+    void UpdateMapping();
+};
+
+// === HuC1 (type $FF, RAM + infrared) ===
+class MapperHuC1 : public Mapper {
+public:
+    using Mapper::Mapper;
+    const char* GetName() const override { return "HuC1"; }
+    void ResetRegisters() override;
+    void WriteROM(uint16_t addr, uint8_t value) override;
+    uint8_t ReadRAM(uint16_t addr) override;
+    void WriteRAM(uint16_t addr, uint8_t value) override;
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+private:
+    bool ir_mode;           // $0000-$1FFF = $0E selects IR instead of RAM
+    uint8_t rom_bank;
+    uint8_t ram_bank;
+
+    void UpdateMapping();
+};
+
+// === HuC3 (type $FE, RAM + RTC + infrared, command interface) ===
+class MapperHuC3 : public Mapper {
+public:
+    using Mapper::Mapper;
+    const char* GetName() const override { return "HuC3"; }
+    void ResetRegisters() override;
+    void WriteROM(uint16_t addr, uint8_t value) override;
+    uint8_t ReadRAM(uint16_t addr) override;
+    void WriteRAM(uint16_t addr, uint8_t value) override;
+    void LoadExtra(std::istream& in) override;
+    void SaveExtra(std::ostream& out) override;
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+private:
+    uint8_t mode;           // $0000-$1FFF: $0A RAM, $0B command, $0C result, $0D semaphore, $0E IR
+    uint8_t rom_bank;
+    uint8_t ram_bank;
+
+    // Clock: minute-of-day and day counter, exchanged as nibbles through a
+    // small register file addressed by access_index (battery-backed)
+    uint16_t minutes = 0;           // 0-1439
+    uint16_t days = 0;              // 12-bit
+    int64_t last_rtc_second = 0;
+    std::array<uint8_t, 256> nibbles = {};
+    uint8_t access_index;
+    uint8_t result;         // Last command byte with read nibble in bits 0-3
+
+    void UpdateMapping();
+    void UpdateRTC();
+    void ExecuteCommand(uint8_t value);
+};
+
+// === MBC6 (type $20, 8 KB ROM banks, 4 KB RAM banks, flash) ===
+class MapperMBC6 : public Mapper {
+public:
+    using Mapper::Mapper;
+    const char* GetName() const override { return "MBC6"; }
+    void ResetRegisters() override;
+    void WriteROM(uint16_t addr, uint8_t value) override;
+    size_t GetRAMSize(size_t) const override { return 32768; }
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+private:
+    bool ram_enabled;
+    uint8_t rom_bank[2];    // $4000-$5FFF / $6000-$7FFF (8 KB units)
+    bool flash_select[2];   // Window maps flash instead of ROM
+    uint8_t ram_bank[2];    // $A000-$AFFF / $B000-$BFFF (4 KB units)
+
+    void UpdateMapping();
+};
+
+// === MBC7 (type $22, accelerometer + 93LC56 serial EEPROM) ===
+class MapperMBC7 : public Mapper {
+public:
+    using Mapper::Mapper;
+    const char* GetName() const override { return "MBC7"; }
+    void ResetRegisters() override;
+    void WriteROM(uint16_t addr, uint8_t value) override;
+    uint8_t ReadRAM(uint16_t addr) override;
+    void WriteRAM(uint16_t addr, uint8_t value) override;
+    size_t GetRAMSize(size_t) const override { return 256; }  // EEPROM
+    void SaveState(StateWriter& state) const override;
+    void LoadState(StateReader& state) override;
+
+private:
+    bool ram_enabled_1;     // $0000-$1FFF = $0A
+    bool ram_enabled_2;     // $4000-$5FFF = $40
+    uint8_t rom_bank;
+
+    // Accelerometer (no tilt input: reports the resting value)
+    uint16_t accel_x;
+    uint16_t accel_y;
+    bool accel_erased;
+
+    // EEPROM pins and serial state machine
+    bool eeprom_cs;
+    bool eeprom_clk;
+    bool eeprom_di;
+    bool eeprom_do;
+    bool eeprom_write_enabled;
+    uint16_t eeprom_command;    // Start bit + opcode + address shifted in
+    uint8_t eeprom_command_bits;
+    uint16_t eeprom_data;       // Data being shifted in (write) or out (read)
+    uint8_t eeprom_data_bits;
+    bool eeprom_reading;
+
+    void UpdateMapping();
+    void ClockEEPROM();
+    void WriteEEPROMWord(uint8_t word, uint16_t value);
+};
@@ -1,5 +1,6 @@
 #include "CPU.hpp"
 #include "Instructions.hpp"
+#include "../state/StateBuffer.hpp"
 #include <cstdio>
 
 CPU::CPU() {
@@ -39,7 +40,7 @@ void CPU::Reset(bool bootRomEnabled) {
     }
 }
 
-uint8_t CPU::Step() {
+inline uint8_t CPU::ExecuteInstruction() {
     // Handle interrupts first (uses IF from previous Step)
     // For HALT wake, we jump here after detecting interrupt mid-M-cycle
 handle_interrupts:
@@ -61,9 +62,7 @@ handle_interrupts:
         
         // Step 2: Check IF NOW (per SameBoy L1629)
         // This happens BETWEEN the two 2-cycle advances
-        uint8_t if_reg = bus_read ? bus_read(0xFF0F) : 0;
-        uint8_t ie_reg = bus_read ? bus_read(0xFFFF) : 0;
-        if ((if_reg & ie_reg & 0x1F) != 0) {
+        if (SamplePendingInterrupts() != 0) {
             halted = false;  // Wake from HALT at mid-M-cycle
             // Still need to complete the M-cycle
             if (tick_callback) {
@@ -82,6 +81,13 @@ handle_interrupts:
         return 4;
     }
     
+    // Scripting exec hooks see the machine before the fetch; flushing
+    // first is what FetchByte would do anyway, so timing is unchanged
+    if (exec_map && ((exec_map[pc >> 3] >> (pc & 7)) & 1)) {
+        FlushPendingCycles();
+        exec_callback(pc);
+    }
+    
     // Fetch and execute instruction
     uint8_t opcode = FetchByte();
     
@@ -112,6 +118,31 @@ handle_interrupts:
     return cycles;
 }
 
+uint8_t CPU::Step() {
+    return ExecuteInstruction();
+}
+
+/**
+ * Run - Instruction loop for RunFrame/StepCycles
+ *
+ * Moves the frame-end check out of Emulator::Step into one loop per frame.
+ * This is not a register-caching fast path: instructions still work on
+ * the CPU object through ExecuteOpcode, and each one ticks the rest of the
+ * machine at least once (see "Batched Execution" in TECHNICAL.md).
+ */
+uint32_t CPU::Run(uint32_t cycle_budget, const uint32_t* stop_counter) {
+    static const uint32_t never = 0;
+    if (!stop_counter) stop_counter = &never;
+    const uint32_t start_count = *stop_counter;
+    
+    uint32_t executed = 0;
+    while (executed < cycle_budget) {
+        executed += ExecuteInstruction();
+        if (*stop_counter != start_count) break;
+    }
+    return executed;
+}
+
 void CPU::RequestInterrupt(uint8_t bit) {
     // Set IF bit via bus (hardware accurate)
     if (bus_read && bus_write) {
@@ -120,14 +151,22 @@ void CPU::RequestInterrupt(uint8_t bit) {
     }
 }
 
+uint8_t CPU::SamplePendingInterrupts() const {
+    // Fast path: single load of the IF & IE line driven by the interrupt controller
+    if (interrupt_line) {
+        return *interrupt_line;
+    }
+    uint8_t if_reg = bus_read ? bus_read(0xFF0F) : 0;
+    uint8_t ie_reg = bus_read ? bus_read(0xFFFF) : 0;
+    return if_reg & ie_reg & 0x1F;
+}
+
 void CPU::HandleInterrupts() {
     // NOTE: ime_scheduled is processed in FetchByte() per GBCTR spec
     // IME=1 must happen AT M2/M1 (during fetch), not before
     
-    // Read IF and IE from bus (hardware accurate)
-    uint8_t if_reg = bus_read ? bus_read(0xFF0F) : 0;
-    uint8_t ie_reg = bus_read ? bus_read(0xFFFF) : 0;
-    uint8_t pending = if_reg & ie_reg & 0x1F;
+    // Sample the IF & IE line (no bus traffic unless we actually dispatch)
+    uint8_t pending = SamplePendingInterrupts();
     
     if (pending) {
         halted = false;  // Wake from HALT
@@ -135,11 +174,14 @@ void CPU::HandleInterrupts() {
         if (ime) {
             ime = false;
             
+            // Dispatch path: read IF/IE from bus (hardware accurate)
+            uint8_t if_reg = bus_read ? bus_read(0xFF0F) : 0;
+            uint8_t ie_reg = bus_read ? bus_read(0xFFFF) : 0;
+            pending = if_reg & ie_reg & 0x1F;
+            
             // Find highest priority interrupt
             for (int i = 0; i < 5; i++) {
                 if (pending & (1 << i)) {
-                    uint8_t int_bit = 1 << i;
-                    
                     // === Interrupt Dispatch: 20 T-cycles (5 M-cycles) ===
                     // Per Cycle-Accurate GB Docs:
                     // 1. Two wait states (2 M-cycles = 8T)
@@ -272,3 +314,21 @@ void CPU::FlushPendingCycles() {
     }
     pending_cycles = 0;
 }
+
+// === Save State ===
+
+template <typename Self, typename Archive>
+void CPU::Serialize(Self& self, Archive& archive) {
+    archive(self.a, self.f, self.b, self.c, self.d, self.e, self.h, self.l, self.sp, self.pc);
+    archive(self.ime, self.ime_scheduled, self.halted, self.halt_bug);
+    archive(self.address_bus, self.data_bus, self.read_signal, self.write_signal);
+    archive(self.pending_cycles);
+}
+
+void CPU::SaveState(StateWriter& state) const {
+    Serialize(*this, state);
+}
+
+void CPU::LoadState(StateReader& state) {
+    Serialize(*this, state);
+}
@@ -3,6 +3,10 @@
 #include <cstdint>
 #include <array>
 #include <functional>
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
 
 /**
  * SM83 CPU - Sharp LR35902 CPU Core
@@ -17,7 +21,7 @@
  * - Receives data from memory reads
  * - Signals: RD (read), WR (write), interrupt lines
  */
-class CPU {
+class CPU : public ArenaAllocated {
 public:
     CPU();
     
@@ -27,6 +31,12 @@ public:
     // Execute one instruction, returns T-cycles consumed
     uint8_t Step();
     
+    // Execute instructions until at least cycle_budget T-cycles have run,
+    // or until *stop_counter changes (checked after every instruction, e.g.
+    // the PPU frame counter so frame hooks run right after the frame).
+    // Returns T-cycles consumed; overshoots the budget by under one instruction.
+    uint32_t Run(uint32_t cycle_budget, const uint32_t* stop_counter = nullptr);
+    
     // Interrupt request lines (directly exposed pins)
     void RequestInterrupt(uint8_t bit);
     
@@ -55,6 +65,17 @@ public:
     
     void SetMooneyeCallback(MooneyeCallback cb) { mooneye_callback = cb; }
     
+    // Interrupt input line (IF & IE & $1F, driven by the interrupt controller)
+    // When unconnected, IF/IE are sampled through the bus instead
+    void ConnectInterruptLine(const uint8_t* line) { interrupt_line = line; }
+    
+    // Execution hooks (scripting): the callback gets PC before each opcode
+    // fetch whose bit is set in the map (one bit per address). The map is
+    // swapped freely, even from inside the callback; nullptr disables.
+    using ExecCallback = std::function<void(uint16_t)>;
+    void ConnectExecHook(ExecCallback callback) { exec_callback = callback; }
+    void SetExecHookMap(const uint8_t* map) { exec_map = map; }
+    
     // === Register Access (for instruction implementations) ===
     // Getters
     uint8_t GetA() const { return a; }
@@ -124,6 +145,10 @@ public:
     // Peek memory without ticking (for internal checks like HALT bug)
     uint8_t PeekByte(uint16_t addr) { return bus_read ? bus_read(addr) : 0xFF; }
     
+    // === Save State (see StateBuffer.hpp) ===
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+    
 private:
     // === Registers (internal flip-flops) ===
     uint8_t a, f;           // Accumulator and flags
@@ -150,6 +175,9 @@ private:
     WriteCallback bus_write;
     TickCallback tick_callback;  // Called each M-cycle (4 T-cycles)
     MooneyeCallback mooneye_callback;  // Called on LD B,B with test result
+    const uint8_t* interrupt_line = nullptr;  // IF & IE & $1F (wired by Emulator)
+    ExecCallback exec_callback;       // Scripting exec hooks (wired by Emulator)
+    const uint8_t* exec_map = nullptr;  // Addresses with exec hooks, nullptr = none
     
     // === Pending Cycles (SameBoy pattern for hardware accuracy) ===
     uint8_t pending_cycles = 0;  // Deferred cycles, flushed before next memory op
@@ -164,5 +192,10 @@ private:
     void Push(uint16_t value);
     uint16_t Pop();
     void HandleInterrupts();
+    uint8_t SamplePendingInterrupts() const;
     void FlushPendingCycles();  // Flush deferred cycles to components
+    inline uint8_t ExecuteInstruction();  // Body of Step, inlined into Run
+    
+    template <typename Self, typename Archive>
+    static void Serialize(Self& self, Archive& archive);
 };
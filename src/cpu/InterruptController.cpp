@@ -1,4 +1,5 @@
 #include "InterruptController.hpp"
+#include "../state/StateBuffer.hpp"
 
 InterruptController::InterruptController() {
     Reset();
@@ -7,10 +8,11 @@ InterruptController::InterruptController() {
 void InterruptController::Reset() {
     interrupt_flag = 0;
     interrupt_enable = 0;
+    pending_line = 0;
 }
 
 int8_t InterruptController::GetHighestPriorityInterrupt() const {
-    uint8_t pending = interrupt_flag & interrupt_enable & 0x1F;
+    uint8_t pending = pending_line;
     
     if (!pending) return -1;
     
@@ -35,3 +37,19 @@ uint16_t InterruptController::GetInterruptVector(uint8_t bit) {
         default:     return 0x0000;
     }
 }
+
+// === Save State ===
+
+template <typename Self, typename Archive>
+void InterruptController::Serialize(Self& self, Archive& archive) {
+    archive(self.interrupt_flag, self.interrupt_enable);
+}
+
+void InterruptController::SaveState(StateWriter& state) const {
+    Serialize(*this, state);
+}
+
+void InterruptController::LoadState(StateReader& state) {
+    Serialize(*this, state);
+    UpdatePendingLine();
+}
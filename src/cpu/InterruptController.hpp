@@ -1,6 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
 
 /**
  * InterruptController - Interrupt Flag and Enable Registers
@@ -14,6 +18,10 @@
  * This represents the interrupt latch/enable logic in the LR35902.
  * Does NOT contain CPU logic - just the flag storage.
  * 
+ * The IF & IE & $1F result is kept latched in a pending line that is
+ * refreshed on every IF/IE write and request, so the CPU can sample it
+ * once per instruction without going through the bus.
+ * 
  * Interrupt bits:
  * - Bit 0: VBlank (highest priority)
  * - Bit 1: LCD STAT
@@ -21,7 +29,7 @@
  * - Bit 3: Serial
  * - Bit 4: Joypad (lowest priority)
  */
-class InterruptController {
+class InterruptController : public ArenaAllocated {
 public:
     InterruptController();
     
@@ -36,23 +44,24 @@ public:
     
     // === IF Register Interface (directly exposed $FF0F) ===
     uint8_t ReadIF() const { return interrupt_flag | 0xE0; }  // Upper bits always 1
-    void WriteIF(uint8_t value) { interrupt_flag = value & 0x1F; }
+    void WriteIF(uint8_t value) { interrupt_flag = value & 0x1F; UpdatePendingLine(); }
     
     // === IE Register Interface (directly exposed $FFFF) ===
     // Note: Unlike IF, ALL 8 bits of IE are R/W (per Mooneye unused_hwio test)
     uint8_t ReadIE() const { return interrupt_enable; }
-    void WriteIE(uint8_t value) { interrupt_enable = value; }
+    void WriteIE(uint8_t value) { interrupt_enable = value; UpdatePendingLine(); }
     
     // === Request Interrupt (directly exposed input from peripheral) ===
-    void RequestInterrupt(uint8_t bit) { interrupt_flag |= bit; }
+    void RequestInterrupt(uint8_t bit) { interrupt_flag |= bit; UpdatePendingLine(); }
     
     // === Clear Interrupt (directly exposed for CPU acknowledgment) ===
-    void ClearInterrupt(uint8_t bit) { interrupt_flag &= ~bit; }
+    void ClearInterrupt(uint8_t bit) { interrupt_flag &= ~bit; UpdatePendingLine(); }
     
     // === Check for Pending Interrupts (directly exposed for CPU) ===
-    uint8_t GetPendingInterrupts() const { 
-        return interrupt_flag & interrupt_enable & 0x1F; 
-    }
+    uint8_t GetPendingInterrupts() const { return pending_line; }
+    
+    // Pending line (IF & IE & $1F) wired directly to the CPU's interrupt input
+    const uint8_t* GetPendingLine() const { return &pending_line; }
     
     // Returns the highest priority pending interrupt (0-4), or -1 if none
     int8_t GetHighestPriorityInterrupt() const;
@@ -60,8 +69,18 @@ public:
     // Get the vector address for an interrupt bit
     static uint16_t GetInterruptVector(uint8_t bit);
     
+    // === Save State (see StateBuffer.hpp) ===
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+    
 private:
     // === Registers (directly exposed internal flip-flops) ===
     uint8_t interrupt_flag;     // IF ($FF0F) - which interrupts are pending
     uint8_t interrupt_enable;   // IE ($FFFF) - which interrupts are enabled
+    uint8_t pending_line;       // IF & IE & $1F - latched on every IF/IE change
+    
+    void UpdatePendingLine() { pending_line = interrupt_flag & interrupt_enable & 0x1F; }
+    
+    template <typename Self, typename Archive>
+    static void Serialize(Self& self, Archive& archive);
 };
@@ -0,0 +1,141 @@
+#include "HangWatchdog.hpp"
+#include "../util/Hash.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+HangWatchdog::HangWatchdog(uint32_t stall_frames)
+    : stall_frames(stall_frames)
+{
+}
+
+const char* HangWatchdog::GetReasonName(Reason reason) {
+    switch (reason) {
+        case Reason::SELF_JUMP: return "self-jump with interrupts disabled";
+        case Reason::HALT_NO_INTERRUPTS: return "HALT with no interrupt enabled";
+        case Reason::STALLED: return "stalled";
+        default: return "none";
+    }
+}
+
+// === Detection ===
+
+HangWatchdog::Reason HangWatchdog::Check(const Emulator& emu) {
+    next_check = emu.GetTotalCycles() + CHECK_CYCLES;
+    bool new_frame = emu.GetFrameCount() != checked_frame;
+    checked_frame = emu.GetFrameCount();
+
+    // LCD on: wait for the frame boundary, mid-frame VRAM/OAM reads are blocked
+    if (!new_frame && (emu.DebugRead(0xFF40) & 0x80)) return reason;
+
+    // Provable hangs: nothing inside or outside the loop can change them
+    uint8_t enabled = emu.DebugRead(0xFFFF) & 0x1F;
+    Reason found = Reason::NONE;
+    if (emu.IsCPUHalted()) {
+        if (!enabled) found = Reason::HALT_NO_INTERRUPTS;
+    } else if ((!emu.GetIME() || !enabled) && IsSelfJump(emu)) {
+        found = Reason::SELF_JUMP;
+    }
+    if (found != Reason::NONE && found == pending) {
+        reason = found;
+        return reason;
+    }
+    pending = found;
+
+    // Heuristic: same code, same picture, same memory. Reading memory back
+    // costs ~25K bus reads, so it's only hashed every MEMORY_INTERVAL checks
+    // of a streak the cheap tests haven't broken
+    uint16_t pc = emu.GetPC();
+    uint16_t low = std::min(window_low, pc);
+    uint16_t high = std::max(window_high, pc);
+    bool same = high - low < 0x100 &&
+                std::equal(screen.begin(), screen.end(), emu.GetFramebuffer());
+    if (same && stalled_checks % MEMORY_INTERVAL == MEMORY_INTERVAL - 1) {
+        uint64_t hash = HashMemory(emu);
+        same = !memory_hashed || hash == memory_hash;
+        memory_hash = hash;
+        memory_hashed = true;
+    }
+    if (same) {
+        window_low = low;
+        window_high = high;
+        stalled_checks++;
+    } else {
+        window_low = window_high = pc;
+        stalled_checks = 0;
+        std::copy(emu.GetFramebuffer(), emu.GetFramebuffer() + screen.size(), screen.begin());
+        memory_hashed = false;
+    }
+
+    if (stall_frames && stalled_checks >= stall_frames) {
+        reason = Reason::STALLED;
+    }
+    return reason;
+}
+
+// Unconditional or taken jump back onto itself: JR -2, JR cc,-2, JP nn,
+// JP cc,nn or JP (HL) with the target equal to PC
+bool HangWatchdog::IsSelfJump(const Emulator& emu) {
+    uint16_t pc = emu.GetPC();
+    uint8_t opcode = emu.DebugRead(pc);
+    uint8_t flags = emu.GetAF() & 0xFF;
+
+    bool taken = true;
+    if ((opcode & 0xE7) == 0x20 || (opcode & 0xE7) == 0xC2) {
+        // cc in bits 3-4: NZ, Z, NC, C
+        uint8_t condition = (opcode >> 3) & 3;
+        bool flag = condition < 2 ? (flags & 0x80) : (flags & 0x10);
+        taken = (condition & 1) ? flag : !flag;
+    }
+    if (!taken) return false;
+
+    if (opcode == 0x18 || (opcode & 0xE7) == 0x20) {
+        return emu.DebugRead(pc + 1) == 0xFE;
+    }
+    if (opcode == 0xC3 || (opcode & 0xE7) == 0xC2) {
+        uint16_t target = emu.DebugRead(pc + 1) | (emu.DebugRead(pc + 2) << 8);
+        return target == pc;
+    }
+    return opcode == 0xE9 && emu.GetHL() == pc;
+}
+
+// Everything else a stuck program could still be changing, minus I/O
+// registers (DIV, LY and the APU move on their own)
+uint64_t HangWatchdog::HashMemory(const Emulator& emu) {
+    static constexpr uint16_t RANGES[][2] = {
+        { 0x8000, 0xDFFF },   // VRAM, cartridge RAM, WRAM
+        { 0xFE00, 0xFE9F },   // OAM
+        { 0xFF80, 0xFFFF },   // HRAM, IE
+    };
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (const auto& range : RANGES) {
+        for (uint32_t addr = range[0]; addr <= range[1]; addr++) {
+            hash = HashByte(hash, emu.DebugRead(static_cast<uint16_t>(addr)));
+        }
+    }
+    return hash;
+}
+
+// === Diagnostics ===
+
+void HangWatchdog::Report(const Emulator& emu, std::ostream& out) const {
+    uint16_t pc = emu.GetPC();
+    out << std::hex << std::setfill('0')
+        << "Hang: " << GetReasonName(reason) << "\n"
+        << "  PC=$" << std::setw(4) << pc << " [";
+    for (int i = 0; i < 3; i++) {
+        out << (i ? " " : "") << std::setw(2) << static_cast<int>(emu.DebugRead(pc + i));
+    }
+    out << "] SP=$" << std::setw(4) << emu.GetSP()
+        << " AF=$" << std::setw(4) << emu.GetAF() << "\n"
+        << "  IME=" << emu.GetIME()
+        << " IE=$" << std::setw(2) << static_cast<int>(emu.DebugRead(0xFFFF))
+        << " IF=$" << std::setw(2) << static_cast<int>(emu.DebugRead(0xFF0F))
+        << " halted=" << emu.IsCPUHalted() << "\n";
+    if (reason == Reason::STALLED) {
+        out << "  PC within $" << std::setw(4) << window_low << "-$" << std::setw(4) << window_high
+            << std::dec << ", memory and screen unchanged for " << stalled_checks << " frames\n";
+    }
+    out << std::dec << std::setfill(' ');
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../Emulator.hpp"
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * HangWatchdog - Early Stop for Headless Runs That Can't Make Progress
+ *
+ * Failing test ROMs usually park the CPU forever, and without a verdict
+ * a headless run burns its whole cycle budget. Once per frame (at VBlank
+ * start, where VRAM and OAM read back reliably; every 70224 T-cycles
+ * while the LCD is off) the watchdog looks for states that never change:
+ * - SELF_JUMP: PC sits on JR -2 / JP to itself (or a taken JR cc,-2) while
+ *   no interrupt can be dispatched (IME off or IE & $1F = 0)
+ * - HALT_NO_INTERRUPTS: halted with IE & $1F = 0, which nothing can wake
+ * - STALLED: PC stays within a 256-byte window for N checks in a row while
+ *   VRAM, cartridge RAM, WRAM, OAM, HRAM and the framebuffer hash stay
+ *   unchanged (covers DI+HALT waiting on a source that will never fire,
+ *   and busy loops polling I/O that no longer changes)
+ *
+ * The first two need the same condition at two consecutive checks, so an
+ * EI right before the loop (IME pending) is never mistaken for a hang.
+ * STALLED is a heuristic: a ROM that spins on registers alone for N frames
+ * with a frozen screen looks hung too, hence the configurable window.
+ */
+class HangWatchdog {
+public:
+    enum class Reason { NONE, SELF_JUMP, HALT_NO_INTERRUPTS, STALLED };
+
+    explicit HangWatchdog(uint32_t stall_frames = 120);
+
+    // Call between instructions; does real work about once per frame
+    Reason Poll(const Emulator& emu) {
+        if (emu.GetFrameCount() == checked_frame && emu.GetTotalCycles() < next_check) {
+            return Reason::NONE;
+        }
+        return Check(emu);
+    }
+
+    // What was detected, where, and the interrupt state behind it
+    void Report(const Emulator& emu, std::ostream& out) const;
+
+    static const char* GetReasonName(Reason reason);
+
+private:
+    static constexpr uint32_t CHECK_CYCLES = 70224;
+    static constexpr uint32_t MEMORY_INTERVAL = 8;
+
+    uint32_t stall_frames;
+    uint32_t checked_frame = 0;
+    uint64_t next_check = 0;
+    Reason reason = Reason::NONE;
+    Reason pending = Reason::NONE;      // Provable hang seen at the last check
+
+    // STALLED tracking
+    uint16_t window_low = 0;
+    uint16_t window_high = 0;
+    std::array<uint8_t, 160 * 144> screen = {};
+    uint64_t memory_hash = 0;
+    bool memory_hashed = false;
+    uint32_t stalled_checks = 0;
+
+    Reason Check(const Emulator& emu);
+    static bool IsSelfJump(const Emulator& emu);
+    static uint64_t HashMemory(const Emulator& emu);
+};
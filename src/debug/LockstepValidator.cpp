@@ -0,0 +1,196 @@
+#include "LockstepValidator.hpp"
+#include "../util/Hash.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+// Bytes shown either side of the first difference in a section
+static constexpr size_t HEX_WINDOW = 8;
+
+LockstepValidator::LockstepValidator(Variant variant)
+    : variant(variant)
+{
+}
+
+LockstepValidator::~LockstepValidator() {
+    // Stop the synthesis worker before candidate_audio goes away
+    candidate.ConnectAudioBuffer(nullptr);
+}
+
+bool LockstepValidator::ParseVariant(const std::string& name, Variant& variant) {
+    if (name == "step") variant = Variant::STEP;
+    else if (name == "worker") variant = Variant::WORKER;
+    else if (name == "state") variant = Variant::STATE;
+    else {
+        std::cerr << "Unknown lockstep variant: " << name << " (expected step, worker or state)\n";
+        return false;
+    }
+    return true;
+}
+
+bool LockstepValidator::Load(const std::string& rom_path, const std::string& boot_rom_path) {
+    for (Emulator* emu : { &reference, &candidate }) {
+        if (!boot_rom_path.empty() && !emu->LoadBootROM(boot_rom_path)) {
+            std::cerr << "Failed to load boot ROM: " << boot_rom_path << "\n";
+            return false;
+        }
+        if (!emu->LoadROM(rom_path)) {
+            std::cerr << "Failed to load ROM: " << rom_path << "\n";
+            return false;
+        }
+        emu->Reset();
+    }
+
+    if (variant == Variant::WORKER) {
+        candidate.ConnectAudioBuffer(&candidate_audio);
+    }
+    return true;
+}
+
+// === Run Loop ===
+
+bool LockstepValidator::Run(uint64_t max_cycles, bool every_instruction) {
+    // Same frame boundary as Emulator::RunFrame (cycle cap covers LCD off)
+    constexpr uint32_t FRAME_CYCLES = 70224;
+    uint64_t target = max_cycles > 0 ? max_cycles : 30000000;
+
+    if (!Compare()) {
+        ReportDivergence();
+        return false;
+    }
+
+    while (reference.GetTotalCycles() < target) {
+        ApplyInput();
+        reference.ClearFrameComplete();
+        candidate.ClearFrameComplete();
+
+        uint64_t frame_start = reference.GetTotalCycles();
+        while (!reference.IsFrameComplete() && reference.GetTotalCycles() - frame_start < FRAME_CYCLES) {
+            reference.Step();
+            instruction++;
+
+            if (every_instruction) {
+                AdvanceCandidate(reference.GetTotalCycles(), false);
+                if (!Compare()) {
+                    ReportDivergence();
+                    return false;
+                }
+            }
+        }
+
+        if (!every_instruction) {
+            AdvanceCandidate(reference.GetTotalCycles(), true);
+            if (!Compare()) {
+                ReportDivergence();
+                return false;
+            }
+        }
+        frame++;
+    }
+
+    std::cout << "Lockstep: no divergence in " << frame << " frames, " << instruction
+              << " instructions, " << reference.GetTotalCycles() << " cycles\n";
+    return true;
+}
+
+void LockstepValidator::ApplyInput() {
+    if (input_state == 0 || frame % 16 != 0) return;
+
+    // xorshift32: one bit per button, identical for both instances
+    input_state ^= input_state << 13;
+    input_state ^= input_state >> 17;
+    input_state ^= input_state << 5;
+    for (uint8_t button = 0; button < 8; button++) {
+        bool pressed = (input_state >> button) & 1;
+        reference.SetButton(button, pressed);
+        candidate.SetButton(button, pressed);
+    }
+}
+
+void LockstepValidator::AdvanceCandidate(uint64_t target_cycles, bool whole_frame) {
+    if (variant == Variant::STEP && whole_frame) {
+        candidate.RunFrame();
+    } else if (target_cycles > candidate.GetTotalCycles()) {
+        candidate.StepCycles(static_cast<uint32_t>(target_cycles - candidate.GetTotalCycles()));
+    }
+
+    if (variant == Variant::WORKER) {
+        // Drain like a frontend would so the worker never backs up
+        candidate.SyncAudio();
+        float block[512 * 2];
+        while (candidate_audio.Read(block, 512)) {}
+    } else if (variant == Variant::STATE) {
+        candidate.SaveState(candidate_state);
+        if (!candidate.LoadState(candidate_state)) {
+            std::cerr << "Lockstep: candidate rejected its own save state\n";
+        }
+    }
+}
+
+// === Comparison ===
+
+bool LockstepValidator::Compare() {
+    reference.SaveState(reference_state, &reference_sections);
+    candidate.SaveState(candidate_state, &candidate_sections);
+    return reference_state == candidate_state &&
+           HashFramebuffer(reference.GetFramebuffer()) == HashFramebuffer(candidate.GetFramebuffer());
+}
+
+void LockstepValidator::ReportDivergence() {
+    std::cout << std::hex << std::setfill('0');
+    std::cout << "\n=== LOCKSTEP DIVERGENCE ===\n" << std::dec
+              << "Frame " << frame << ", instruction " << instruction
+              << ", cycles " << reference.GetTotalCycles() << " (reference) / "
+              << candidate.GetTotalCycles() << " (candidate)\n";
+
+    for (Emulator* emu : { &reference, &candidate }) {
+        std::cout << (emu == &reference ? "  reference" : "  candidate") << std::hex
+                  << ": PC=$" << std::setw(4) << emu->GetPC()
+                  << " SP=$" << std::setw(4) << emu->GetSP()
+                  << " AF=$" << std::setw(4) << emu->GetAF()
+                  << " BC=$" << std::setw(4) << emu->GetBC()
+                  << " DE=$" << std::setw(4) << emu->GetDE()
+                  << " HL=$" << std::setw(4) << emu->GetHL()
+                  << " LY=" << std::dec << static_cast<int>(emu->GetLY())
+                  << " mode=" << static_cast<int>(emu->GetPPUMode())
+                  << " fb=" << std::hex << std::setw(16) << HashFramebuffer(emu->GetFramebuffer())
+                  << std::dec << "\n";
+    }
+
+    // Both sides run the same code, so sections line up by index
+    size_t count = std::min(reference_sections.size(), candidate_sections.size());
+    for (size_t i = 0; i < count; i++) {
+        const Emulator::StateSection& ref = reference_sections[i];
+        const Emulator::StateSection& cand = candidate_sections[i];
+        if (ref.size != cand.size) {
+            std::cout << "  " << ref.name << ": size " << ref.size << " vs " << cand.size << "\n";
+            continue;
+        }
+
+        const uint8_t* a = reference_state.data() + ref.offset;
+        const uint8_t* b = candidate_state.data() + cand.offset;
+        size_t differing = 0;
+        size_t first = ref.size;
+        for (size_t j = 0; j < ref.size; j++) {
+            if (a[j] != b[j]) {
+                if (differing++ == 0) first = j;
+            }
+        }
+        if (differing == 0) continue;
+
+        std::cout << "  " << ref.name << ": " << differing << " of " << ref.size
+                  << " bytes differ, first at +0x" << std::hex << first << "\n";
+        size_t begin = first > HEX_WINDOW ? first - HEX_WINDOW : 0;
+        size_t end = std::min(ref.size, first + HEX_WINDOW + 1);
+        for (const uint8_t* bytes : { a, b }) {
+            std::cout << (bytes == a ? "    ref  +0x" : "    cand +0x") << std::setw(4) << begin << ":";
+            for (size_t j = begin; j < end; j++) {
+                std::cout << (j == first ? '[' : ' ') << std::setw(2) << static_cast<int>(bytes[j]);
+            }
+            std::cout << "\n";
+        }
+        std::cout << std::dec;
+    }
+    std::cout << std::setfill(' ');
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../Emulator.hpp"
+#include "../apu/AudioBuffer.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * LockstepValidator - Differential Check of Two Emulator Instances
+ *
+ * Runs a reference Emulator and a candidate Emulator from the same ROM and
+ * the same (pseudo-random) button presses, and compares their full save
+ * state plus a framebuffer hash at every frame boundary, or after every
+ * instruction on demand. The first mismatch is reported per component
+ * (the save-state sections), with the byte offset and a hex window of
+ * both sides, and the run stops there.
+ *
+ * The reference always advances one Step() at a time. The candidate
+ * takes the path under test:
+ * - STEP:   RunFrame()/StepCycles() batching instead of single steps
+ * - WORKER: audio synthesis on the APU worker thread (ConnectAudioBuffer)
+ * - STATE:  SaveState()/LoadState() round trip at every comparison
+ *
+ * Variants that differ by compile-time switches are compared by building
+ * this against both configurations of the code under test; the runtime
+ * variants above keep one binary honest about its own fast paths.
+ */
+class LockstepValidator {
+public:
+    enum class Variant { STEP, WORKER, STATE };
+
+    explicit LockstepValidator(Variant variant);
+    ~LockstepValidator();
+
+    LockstepValidator(const LockstepValidator&) = delete;
+    LockstepValidator& operator=(const LockstepValidator&) = delete;
+
+    static bool ParseVariant(const std::string& name, Variant& variant);
+
+    // Loads both instances and resets them (boot ROM optional)
+    bool Load(const std::string& rom_path, const std::string& boot_rom_path);
+
+    // Button presses change every 16 frames; seed 0 leaves input idle
+    void SetInputSeed(uint32_t seed) { input_state = seed; }
+
+    // Runs until max_cycles or the first divergence (returns false)
+    bool Run(uint64_t max_cycles, bool every_instruction);
+
+private:
+    Variant variant;
+    Emulator reference;
+    Emulator candidate;
+    AudioBuffer candidate_audio;
+
+    uint32_t input_state = 0x2F6B1D35;
+    uint32_t frame = 0;
+    uint64_t instruction = 0;
+
+    // Reused between comparisons
+    std::vector<uint8_t> reference_state;
+    std::vector<uint8_t> candidate_state;
+    std::vector<Emulator::StateSection> reference_sections;
+    std::vector<Emulator::StateSection> candidate_sections;
+
+    void ApplyInput();
+    void AdvanceCandidate(uint64_t target_cycles, bool whole_frame);
+    bool Compare();
+    void ReportDivergence();
+
+};
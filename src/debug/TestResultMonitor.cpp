@@ -0,0 +1,134 @@
+#include "TestResultMonitor.hpp"
+#include "../util/Hash.hpp"
+
+#include <cstring>
+
+// Blargg RAM protocol (cartridge RAM at $A000)
+static constexpr uint16_t BLARGG_STATUS = 0xA000;
+static constexpr uint16_t BLARGG_SIGNATURE = 0xA001;
+static constexpr uint16_t BLARGG_TEXT = 0xA004;
+static constexpr uint8_t BLARGG_RUNNING = 0x80;
+static constexpr uint8_t BLARGG_RESET = 0x81;       // "Press reset to continue"
+static constexpr uint32_t BLARGG_RESET_FRAMES = 6;  // Hold before resetting (~100 ms)
+static constexpr uint32_t BLARGG_MAX_RESETS = 8;
+static constexpr size_t BLARGG_TEXT_MAX = 1024;
+
+// Serial text kept for the summary; the oldest half is dropped when full,
+// so a ROM printing forever never makes the run allocate
+static constexpr size_t SERIAL_KEEP = 4096;
+
+static bool EndsWith(const std::string& text, const char* suffix) {
+    size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+TestResultMonitor::TestResultMonitor(Emulator& emu, std::ostream* serial_echo)
+    : emu(emu)
+    , serial_echo(serial_echo)
+{
+    serial_output.reserve(SERIAL_KEEP);
+    emu.SetMooneyeCallback([this](bool passed) {
+        Decide(passed ? Verdict::PASSED : Verdict::FAILED, "Mooneye");
+    });
+    emu.SetSerialCallback([this](uint8_t byte) { OnSerialByte(byte); });
+}
+
+TestResultMonitor::~TestResultMonitor() {
+    emu.SetMooneyeCallback(nullptr);
+    emu.SetSerialCallback(nullptr);
+}
+
+void TestResultMonitor::AddDetector(const std::string& name, Detector detector) {
+    detectors.emplace_back(name, detector);
+}
+
+void TestResultMonitor::AddScreenHash(uint64_t hash, bool passed) {
+    (passed ? pass_screens : fail_screens).insert(hash);
+}
+
+// First verdict wins; later ones (e.g. text after "Passed") are ignored
+void TestResultMonitor::Decide(Verdict verdict, const std::string& source, const std::string& detail) {
+    if (result.verdict != Verdict::NONE) return;
+    result.verdict = verdict;
+    result.source = source;
+    result.detail = detail;
+}
+
+// === Event Detectors (emulator callbacks) ===
+
+void TestResultMonitor::OnSerialByte(uint8_t byte) {
+    char c = static_cast<char>(byte);
+    if (serial_output.size() == SERIAL_KEEP) serial_output.erase(0, SERIAL_KEEP / 2);
+    serial_output += c;
+    if (serial_echo) *serial_echo << c << std::flush;
+
+    if (EndsWith(serial_output, "Passed") || EndsWith(serial_output, "passed")) {
+        Decide(Verdict::PASSED, "Blargg");
+    } else if (EndsWith(serial_output, "Failed") || EndsWith(serial_output, "failed")) {
+        Decide(Verdict::FAILED, "Blargg");
+    }
+}
+
+// === Frame Boundary Detectors ===
+
+bool TestResultMonitor::Check() {
+    if (!HasResult()) CheckBlarggRAM();
+    if (!HasResult() && !(pass_screens.empty() && fail_screens.empty())) CheckScreen();
+
+    for (auto& detector : detectors) {
+        if (HasResult()) break;
+        std::string detail;
+        Verdict verdict = detector.second(emu, detail);
+        if (verdict != Verdict::NONE) Decide(verdict, detector.first, detail);
+    }
+    return HasResult();
+}
+
+void TestResultMonitor::CheckBlarggRAM() {
+    // Reads $FF while cartridge RAM is absent or disabled
+    if (emu.DebugRead(BLARGG_SIGNATURE) != 0xDE ||
+        emu.DebugRead(BLARGG_SIGNATURE + 1) != 0xB0 ||
+        emu.DebugRead(BLARGG_SIGNATURE + 2) != 0x61) {
+        return;
+    }
+
+    uint8_t status = emu.DebugRead(BLARGG_STATUS);
+    if (status == BLARGG_RUNNING) {
+        blargg_running = true;
+        return;
+    }
+    if (!blargg_running) return;
+
+    if (status == BLARGG_RESET) {
+        if (++blargg_reset_wait < BLARGG_RESET_FRAMES) return;
+        blargg_reset_wait = 0;
+        if (++blargg_resets > BLARGG_MAX_RESETS) {
+            Decide(Verdict::FAILED, "Blargg RAM", "Reset requested " + std::to_string(blargg_resets) + " times");
+            return;
+        }
+        // The status stays $81 until the restarted test writes $80 again
+        blargg_running = false;
+        emu.Reset();
+        return;
+    }
+
+    std::string text;
+    for (size_t i = 0; i < BLARGG_TEXT_MAX; i++) {
+        char c = static_cast<char>(emu.DebugRead(static_cast<uint16_t>(BLARGG_TEXT + i)));
+        if (c == 0) break;
+        text += c;
+    }
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.pop_back();
+    if (status != 0) text += (text.empty() ? "" : "\n") + std::string("Result code ") + std::to_string(status);
+    Decide(status == 0 ? Verdict::PASSED : Verdict::FAILED, "Blargg RAM", text);
+}
+
+void TestResultMonitor::CheckScreen() {
+    uint64_t hash = HashFramebuffer(emu.GetFramebuffer());
+    screen_frames = hash == screen_hash ? screen_frames + 1 : 1;
+    screen_hash = hash;
+    if (screen_frames < screen_stable_frames) return;
+
+    if (pass_screens.count(hash)) Decide(Verdict::PASSED, "Screen");
+    else if (fail_screens.count(hash)) Decide(Verdict::FAILED, "Screen");
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../Emulator.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * TestResultMonitor - Early Verdicts for Headless Test ROM Runs
+ *
+ * Collects the ways test ROMs announce a result, so a run can stop as soon
+ * as one is known instead of after its cycle budget:
+ * - Mooneye: LD B,B with the Fibonacci (pass) or $42 (fail) registers
+ * - Blargg serial: "Passed"/"Failed" in the text sent over the link port
+ * - Blargg RAM: signature DE B0 61 at $A001-$A003, status at $A000 ($80
+ *   while running, then 0 = pass or an error code; text from $A004). A
+ *   final status only counts after $80 was seen, so a stale battery save
+ *   can't pass a test that hasn't run. $81 asks for the reset button: the
+ *   monitor resets the emulator (cartridge RAM survives) ~100 ms later
+ *   and keeps watching; past a few resets in a row it fails the test
+ * - Screen: framebuffer hash unchanged for N frames and equal to a known
+ *   pass or fail hash (for ROMs that only draw their result)
+ * - Custom detectors added with AddDetector()
+ *
+ * Mooneye and serial results arrive through emulator callbacks as they
+ * happen; everything else is evaluated by Check() at frame boundaries.
+ * Nothing runs per instruction.
+ */
+class TestResultMonitor {
+public:
+    enum class Verdict { NONE, PASSED, FAILED };
+
+    struct Result {
+        Verdict verdict = Verdict::NONE;
+        std::string source;     // Detector that decided ("Mooneye", "Blargg", ...)
+        std::string detail;     // Optional text (Blargg RAM message, custom detail)
+    };
+
+    // Return NONE until the result is known; `detail` may be filled in
+    using Detector = std::function<Verdict(const Emulator& emu, std::string& detail)>;
+
+    // Installs the Mooneye and serial callbacks on `emu`. Serial text is
+    // echoed to `serial_echo` when given.
+    explicit TestResultMonitor(Emulator& emu, std::ostream* serial_echo = nullptr);
+    ~TestResultMonitor();
+
+    TestResultMonitor(const TestResultMonitor&) = delete;
+    TestResultMonitor& operator=(const TestResultMonitor&) = delete;
+
+    void AddDetector(const std::string& name, Detector detector);
+
+    // Known final screens (see util/Hash.hpp); matched once stable for N frames
+    void AddScreenHash(uint64_t hash, bool passed);
+    void SetScreenStableFrames(uint32_t frames) { screen_stable_frames = frames; }
+
+    // Evaluate the frame-boundary detectors; true once a verdict exists
+    bool Check();
+
+    bool HasResult() const { return result.verdict != Verdict::NONE; }
+    const Result& GetResult() const { return result; }
+    const std::string& GetSerialOutput() const { return serial_output; }   // Last 2-4 KB
+    uint32_t GetResetCount() const { return blargg_resets; }               // Resets done for Blargg $81
+
+private:
+    Emulator& emu;
+    std::ostream* serial_echo;
+    Result result;
+
+    std::string serial_output;
+    bool blargg_running = false;     // Saw status $80 with a valid signature
+    uint32_t blargg_reset_wait = 0;  // Frames status has been $81
+    uint32_t blargg_resets = 0;
+
+    std::set<uint64_t> pass_screens;
+    std::set<uint64_t> fail_screens;
+    uint32_t screen_stable_frames = 10;
+    uint64_t screen_hash = 0;
+    uint32_t screen_frames = 0;
+
+    std::vector<std::pair<std::string, Detector>> detectors;
+
+    void Decide(Verdict verdict, const std::string& source, const std::string& detail = "");
+    void OnSerialByte(uint8_t byte);
+    void CheckBlarggRAM();
+    void CheckScreen();
+};
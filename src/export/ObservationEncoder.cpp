@@ -0,0 +1,182 @@
+#include "ObservationEncoder.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+// Shade to gray as compares and blends rather than a table load, so the
+// row loops vectorize (the table is passed by value: no aliasing with rows)
+struct GrayTable {
+    uint8_t shade[4];
+};
+
+static inline uint8_t Gray(uint8_t shade, GrayTable gray) {
+    uint8_t low = (shade & 1) ? gray.shade[1] : gray.shade[0];
+    uint8_t high = (shade & 1) ? gray.shade[3] : gray.shade[2];
+    return (shade & 2) ? high : low;
+}
+
+// Box rows. Factors 2 and 4 read each box as one 16/32-bit word, so the
+// loops use contiguous loads instead of strided byte loads and vectorize
+// (a word's byte sum or max doesn't depend on byte order). Other factors
+// take the plain loop.
+template <typename Word>
+static void AddBoxWords(const uint8_t* row, uint32_t width, uint16_t* sums) {
+    Word words[ObservationEncoder::SCREEN_WIDTH / sizeof(Word)];
+    std::memcpy(words, row, width * sizeof(Word));
+    for (uint32_t x = 0; x < width; x++) {
+        uint16_t sum = 0;
+        for (uint32_t b = 0; b < sizeof(Word); b++) sum += (words[x] >> (8 * b)) & 0xFF;
+        sums[x] += sum;
+    }
+}
+
+template <typename Word>
+static void MaxBoxWords(const uint8_t* row, uint32_t width, uint8_t* line) {
+    Word words[ObservationEncoder::SCREEN_WIDTH / sizeof(Word)];
+    std::memcpy(words, row, width * sizeof(Word));
+    for (uint32_t x = 0; x < width; x++) {
+        uint8_t darkest = line[x];
+        for (uint32_t b = 0; b < sizeof(Word); b++) {
+            darkest = std::max(darkest, static_cast<uint8_t>(words[x] >> (8 * b)));
+        }
+        line[x] = darkest;
+    }
+}
+
+// Inlined into EncodeFrame, whose local row buffers then provably don't
+// alias anything
+static inline void AddBox(const uint8_t* row, uint32_t width, uint32_t ds, uint16_t* sums) {
+    if (ds == 2) return AddBoxWords<uint16_t>(row, width, sums);
+    if (ds == 4) return AddBoxWords<uint32_t>(row, width, sums);
+    for (uint32_t x = 0; x < width; x++) {
+        for (uint32_t dx = 0; dx < ds; dx++) sums[x] += row[x * ds + dx];
+    }
+}
+
+static inline void MaxBox(const uint8_t* row, uint32_t width, uint32_t ds, uint8_t* line) {
+    if (ds == 2) return MaxBoxWords<uint16_t>(row, width, line);
+    if (ds == 4) return MaxBoxWords<uint32_t>(row, width, line);
+    for (uint32_t x = 0; x < width; x++) {
+        for (uint32_t dx = 0; dx < ds; dx++) line[x] = std::max(line[x], row[x * ds + dx]);
+    }
+}
+
+bool ObservationEncoder::Configure(const Config& next) {
+    uint32_t ds = next.downsample;
+    if (ds == 0 || ds > MAX_DOWNSAMPLE || next.stack == 0 || next.stack > MAX_STACK) return false;
+    if (next.crop_width == 0 || next.crop_height == 0) return false;
+    if (next.crop_x + next.crop_width > SCREEN_WIDTH || next.crop_y + next.crop_height > SCREEN_HEIGHT) return false;
+    if (next.crop_width % ds || next.crop_height % ds) return false;
+
+    config = next;
+    width = next.crop_width / ds;
+    height = next.crop_height / ds;
+    row_size = next.format == Format::PACKED_2BPP ? (width + 3) / 4 : width;
+    frame_size = row_size * height;
+    return true;
+}
+
+void ObservationEncoder::Encode(const uint8_t* framebuffer, uint8_t* out, bool reset) const {
+    size_t older = frame_size * (config.stack - 1);
+    uint8_t* newest = out + older;
+
+    if (!reset && older) std::memmove(out, out + frame_size, older);
+    EncodeFrame(framebuffer, newest);
+    if (reset) {
+        for (size_t offset = 0; offset < older; offset += frame_size) {
+            std::memcpy(out + offset, newest, frame_size);
+        }
+    }
+}
+
+void ObservationEncoder::EncodeFrame(const uint8_t* framebuffer, uint8_t* out) const {
+    const uint32_t ds = config.downsample;
+    // Box mean as a 16.16 multiply (a division per pixel doesn't vectorize);
+    // exact for power-of-two boxes
+    const uint32_t reciprocal = (65536 + ds * ds / 2) / (ds * ds);
+    const uint32_t crop_width = config.crop_width;
+    const uint32_t out_width = width;   // Locals: stores through dst can't alias them
+    const GrayTable gray = { { config.gray[0], config.gray[1], config.gray[2], config.gray[3] } };
+    bool packed = config.format == Format::PACKED_2BPP;
+
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* src = framebuffer + (config.crop_y + y * ds) * SCREEN_WIDTH + config.crop_x;
+        uint8_t* dst = out + y * row_size;
+
+        if (config.format == Format::GRAYSCALE) {
+            if (ds == 1) {
+                for (uint32_t x = 0; x < out_width; x++) dst[x] = Gray(src[x], gray);
+                continue;
+            }
+            uint8_t mapped[SCREEN_WIDTH];
+            uint16_t sums[SCREEN_WIDTH] = {};
+            for (uint32_t dy = 0; dy < ds; dy++) {
+                const uint8_t* row = src + dy * SCREEN_WIDTH;
+                for (uint32_t x = 0; x < crop_width; x++) mapped[x] = Gray(row[x], gray);
+                AddBox(mapped, out_width, ds, sums);
+            }
+            for (uint32_t x = 0; x < out_width; x++) {
+                dst[x] = static_cast<uint8_t>(std::min<uint32_t>((sums[x] * reciprocal + 0x8000) >> 16, 255));
+            }
+            continue;
+        }
+
+        // Shades: darkest of each box, padded with 0 to whole packed bytes
+        const uint8_t* shades = src;
+        uint8_t line[SCREEN_WIDTH] = {};
+        if (ds > 1 || (packed && out_width % 4)) {
+            for (uint32_t dy = 0; dy < ds; dy++) {
+                MaxBox(src + dy * SCREEN_WIDTH, out_width, ds, line);
+            }
+            shades = line;
+        }
+
+        if (packed) {
+            Pack2bpp(shades, row_size * 4, dst);
+        } else {
+            std::memcpy(dst, shades, out_width);
+        }
+    }
+}
+
+void ObservationEncoder::Pack2bpp(const uint8_t* shades, size_t count, uint8_t* out) {
+    for (size_t i = 0; i < count / 4; i++) {
+        const uint8_t* p = shades + i * 4;
+        out[i] = static_cast<uint8_t>((p[0] & 3) | (p[1] & 3) << 2 | (p[2] & 3) << 4 | (p[3] & 3) << 6);
+    }
+}
+
+// === Spec Strings ===
+
+bool ObservationEncoder::ParseSpec(const std::string& spec, Config& config) {
+    Config parsed;
+    std::stringstream stream(spec);
+    std::string field;
+
+    if (!std::getline(stream, field, ',')) return false;
+    if (field == "indices") parsed.format = Format::INDICES;
+    else if (field == "packed") parsed.format = Format::PACKED_2BPP;
+    else if (field == "gray") parsed.format = Format::GRAYSCALE;
+    else return false;
+
+    while (std::getline(stream, field, ',')) {
+        unsigned a, b, c, d;
+        if (std::sscanf(field.c_str(), "crop=%u:%u:%u:%u", &a, &b, &c, &d) == 4 &&
+            a <= SCREEN_WIDTH && b <= SCREEN_HEIGHT && c <= SCREEN_WIDTH && d <= SCREEN_HEIGHT) {
+            parsed.crop_x = static_cast<uint8_t>(a);
+            parsed.crop_y = static_cast<uint8_t>(b);
+            parsed.crop_width = static_cast<uint8_t>(c);
+            parsed.crop_height = static_cast<uint8_t>(d);
+        } else if (std::sscanf(field.c_str(), "down=%u", &a) == 1 && a <= 255) {
+            parsed.downsample = static_cast<uint8_t>(a);
+        } else if (std::sscanf(field.c_str(), "stack=%u", &a) == 1 && a <= MAX_STACK) {
+            parsed.stack = static_cast<uint8_t>(a);
+        } else {
+            return false;
+        }
+    }
+
+    config = parsed;
+    return true;
+}
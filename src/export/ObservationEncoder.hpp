@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * ObservationEncoder - Compact Framebuffer Formats for Agents
+ *
+ * Turns the 160x144 framebuffer (one byte per shade, 23 KB) into what an
+ * agent actually consumes, in the emulator process at frame end instead
+ * of in the agent's runtime:
+ * - Crop to a rectangle (drop a status bar, borders)
+ * - Integer downsample: box mean for GRAYSCALE; the darkest shade of the
+ *   box for INDICES/PACKED_2BPP, so 1-pixel lines and text survive
+ * - Format: INDICES (one byte per shade 0-3), PACKED_2BPP (four pixels per
+ *   byte, first pixel in the low bits, rows padded to whole bytes; the
+ *   full screen is 5,760 bytes) or GRAYSCALE (shade mapped through a
+ *   4-entry gray table, default 255/170/85/0)
+ * - Frame stacking: the caller's buffer holds `stack` frames, oldest
+ *   first; each Encode() shifts them down one slot and writes the newest
+ *   last
+ *
+ * Encode() never allocates. The loops run over contiguous rows without
+ * branches so -O3 -march=native vectorizes them; there are no intrinsics.
+ *
+ * Spec strings (command lines, tools):
+ *   format[,crop=X:Y:W:H][,down=N][,stack=N]
+ *   e.g. "gray,crop=0:0:160:128,down=2,stack=4" or "packed"
+ */
+class ObservationEncoder {
+public:
+    static constexpr uint32_t SCREEN_WIDTH = 160;
+    static constexpr uint32_t SCREEN_HEIGHT = 144;
+    static constexpr uint32_t MAX_STACK = 16;
+    static constexpr uint32_t MAX_DOWNSAMPLE = 16;   // 16-bit box sums
+
+    enum class Format : uint8_t { INDICES = 0, PACKED_2BPP = 1, GRAYSCALE = 2 };
+
+    struct Config {
+        Format format = Format::INDICES;
+        uint8_t crop_x = 0;
+        uint8_t crop_y = 0;
+        uint8_t crop_width = SCREEN_WIDTH;
+        uint8_t crop_height = SCREEN_HEIGHT;
+        uint8_t downsample = 1;          // 1-MAX_DOWNSAMPLE; crop width/height must divide by it
+        uint8_t stack = 1;               // 1-MAX_STACK
+        std::array<uint8_t, 4> gray = { 255, 170, 85, 0 };
+    };
+
+    ObservationEncoder() { Configure(Config()); }
+
+    // False (and unchanged) if the crop leaves the screen or doesn't
+    // divide by the downsample factor
+    bool Configure(const Config& config);
+    const Config& GetConfig() const { return config; }
+
+    uint32_t GetWidth() const { return width; }
+    uint32_t GetHeight() const { return height; }
+    size_t GetFrameSize() const { return frame_size; }
+    size_t GetOutputSize() const { return frame_size * config.stack; }
+
+    // Write the current screen into `out` (GetOutputSize() bytes). `reset`
+    // fills every stacked slot with it (episode start).
+    void Encode(const uint8_t* framebuffer, uint8_t* out, bool reset = false) const;
+
+    // Four shades per byte, first in the low bits; `count` multiple of 4
+    static void Pack2bpp(const uint8_t* shades, size_t count, uint8_t* out);
+
+    // See above; false on a malformed spec (config untouched)
+    static bool ParseSpec(const std::string& spec, Config& config);
+
+private:
+    Config config;
+    uint32_t width = SCREEN_WIDTH;
+    uint32_t height = SCREEN_HEIGHT;
+    size_t row_size = SCREEN_WIDTH;
+    size_t frame_size = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+    void EncodeFrame(const uint8_t* framebuffer, uint8_t* out) const;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * SharedFrameLayout - POSIX Shared-Memory Export Format
+ *
+ * Layout of the /dev/shm object written by SharedMemoryExport.
+ * Self-contained (no emulator headers) so external readers can include
+ * it directly; see tools/shm_reader.cpp.
+ *
+ * Structure:
+ * - SharedFrameHeader at offset 0
+ * - FRAME_SLOTS SharedFrameSlot at header.frame_offset
+ * - AUDIO_SLOTS SharedAudioSlot at header.audio_offset
+ *
+ * Publishing (single writer):
+ * - Each slot is a seqlock: `sequence` is odd while the writer fills it,
+ *   then set to 2 * (number + 1). A reader copies/uses the payload and
+ *   re-checks `sequence`; a change means the slot was overwritten.
+ * - frame_seq/audio_seq count published items (low 32 bits). They are
+ *   also the futex words: writers FUTEX_WAKE after each publish, readers
+ *   FUTEX_WAIT on the last value they saw (Linux; poll elsewhere).
+ * - Item N lives in slot N % SLOTS; readers that fall more than SLOTS
+ *   behind skip ahead.
+ */
+
+struct SharedFrameLayout {
+    static constexpr char MAGIC[8] = { 'G', 'B', 'E', 'M', 'U', '3', 'S', 'M' };
+    static constexpr uint32_t VERSION = 1;
+
+    static constexpr uint32_t FRAME_WIDTH = 160;
+    static constexpr uint32_t FRAME_HEIGHT = 144;
+    static constexpr uint32_t FRAME_SLOTS = 8;
+
+    static constexpr uint32_t AUDIO_RATE = 48000;
+    static constexpr uint32_t AUDIO_BLOCK_SAMPLES = 2048;   // Stereo samples per slot
+    static constexpr uint32_t AUDIO_SLOTS = 16;
+};
+
+struct SharedFrameHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+
+    uint32_t frame_width;
+    uint32_t frame_height;
+    uint32_t frame_slots;
+    uint32_t frame_slot_size;
+    uint64_t frame_offset;
+
+    uint32_t audio_rate;
+    uint32_t audio_channels;
+    uint32_t audio_block_samples;
+    uint32_t audio_slots;
+    uint32_t audio_slot_size;
+    uint32_t reserved;
+    uint64_t audio_offset;
+
+    std::atomic<uint32_t> frame_seq;    // Frames published (futex word)
+    std::atomic<uint32_t> audio_seq;    // Audio blocks published (futex word)
+    std::atomic<uint32_t> writer_alive; // Cleared when the emulator exits
+    uint32_t writer_pid;
+};
+
+struct SharedFrameSlot {
+    std::atomic<uint64_t> sequence;     // Seqlock, see above
+    uint64_t frame_number;
+    uint64_t cycle;                     // Emulator T-cycle count at frame end
+    uint8_t pixels[SharedFrameLayout::FRAME_WIDTH * SharedFrameLayout::FRAME_HEIGHT];  // Color indices 0-3
+};
+
+struct SharedAudioSlot {
+    std::atomic<uint64_t> sequence;
+    uint64_t block_number;
+    uint32_t sample_count;              // Stereo samples valid in this block
+    uint32_t reserved;
+    float samples[SharedFrameLayout::AUDIO_BLOCK_SAMPLES * 2];   // Interleaved L/R
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+              std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory export needs address-free atomics");
@@ -0,0 +1,164 @@
+#include "SharedMemoryExport.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+SharedMemoryExport::~SharedMemoryExport() {
+    Close();
+}
+
+bool SharedMemoryExport::Open(const std::string& name) {
+    Close();
+
+    shm_name = "/" + name;
+    int fd = shm_open(shm_name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "shm_open failed: " << shm_name << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    // Slots are 64-byte aligned so each seqlock word starts a cache line
+    auto align = [](size_t n) { return (n + 63) & ~size_t(63); };
+    size_t frame_slot_size = align(sizeof(SharedFrameSlot));
+    size_t audio_slot_size = align(sizeof(SharedAudioSlot));
+    size_t frame_offset = align(sizeof(SharedFrameHeader));
+    size_t audio_offset = frame_offset + frame_slot_size * SharedFrameLayout::FRAME_SLOTS;
+    mapping_size = audio_offset + audio_slot_size * SharedFrameLayout::AUDIO_SLOTS;
+
+    if (ftruncate(fd, static_cast<off_t>(mapping_size)) < 0) {
+        std::cerr << "ftruncate failed: " << shm_name << ": " << std::strerror(errno) << "\n";
+        close(fd);
+        shm_unlink(shm_name.c_str());
+        return false;
+    }
+
+    mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "mmap failed: " << shm_name << ": " << std::strerror(errno) << "\n";
+        mapping = nullptr;
+        shm_unlink(shm_name.c_str());
+        return false;
+    }
+
+    // ftruncate zero-fills, so the atomics start at 0; construct them in
+    // place anyway to make their lifetime explicit
+    uint8_t* base = static_cast<uint8_t*>(mapping);
+    header = new (base) SharedFrameHeader();
+    frame_slots = reinterpret_cast<SharedFrameSlot*>(base + frame_offset);
+    audio_slots = reinterpret_cast<SharedAudioSlot*>(base + audio_offset);
+    for (uint32_t i = 0; i < SharedFrameLayout::FRAME_SLOTS; i++) {
+        new (base + frame_offset + i * frame_slot_size) SharedFrameSlot();
+    }
+    for (uint32_t i = 0; i < SharedFrameLayout::AUDIO_SLOTS; i++) {
+        new (base + audio_offset + i * audio_slot_size) SharedAudioSlot();
+    }
+
+    header->version = SharedFrameLayout::VERSION;
+    header->header_size = sizeof(SharedFrameHeader);
+    header->frame_width = SharedFrameLayout::FRAME_WIDTH;
+    header->frame_height = SharedFrameLayout::FRAME_HEIGHT;
+    header->frame_slots = SharedFrameLayout::FRAME_SLOTS;
+    header->frame_slot_size = static_cast<uint32_t>(frame_slot_size);
+    header->frame_offset = frame_offset;
+    header->audio_rate = SharedFrameLayout::AUDIO_RATE;
+    header->audio_channels = 2;
+    header->audio_block_samples = SharedFrameLayout::AUDIO_BLOCK_SAMPLES;
+    header->audio_slots = SharedFrameLayout::AUDIO_SLOTS;
+    header->audio_slot_size = static_cast<uint32_t>(audio_slot_size);
+    header->audio_offset = audio_offset;
+    header->writer_pid = static_cast<uint32_t>(getpid());
+    header->writer_alive.store(1, std::memory_order_relaxed);
+
+    // Magic last: readers treat the object as valid once it matches
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, SharedFrameLayout::MAGIC, sizeof(header->magic));
+
+    frames_published = 0;
+    audio_blocks_published = 0;
+
+    std::cout << "Exporting frames/audio to shared memory: " << shm_name << "\n";
+    return true;
+}
+
+void SharedMemoryExport::Close() {
+    if (!mapping) return;
+
+    header->writer_alive.store(0, std::memory_order_release);
+    Wake(header->frame_seq);
+    Wake(header->audio_seq);
+
+    munmap(mapping, mapping_size);
+    shm_unlink(shm_name.c_str());
+
+    mapping = nullptr;
+    header = nullptr;
+    frame_slots = nullptr;
+    audio_slots = nullptr;
+}
+
+void SharedMemoryExport::PublishFrame(const uint8_t* framebuffer, uint64_t cycle) {
+    if (!header) return;
+
+    uint64_t n = frames_published;
+    SharedFrameSlot& slot = *reinterpret_cast<SharedFrameSlot*>(
+        reinterpret_cast<uint8_t*>(frame_slots) + (n % SharedFrameLayout::FRAME_SLOTS) * header->frame_slot_size);
+
+    slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.frame_number = n;
+    slot.cycle = cycle;
+    std::memcpy(slot.pixels, framebuffer, sizeof(slot.pixels));
+    slot.sequence.store(2 * n + 2, std::memory_order_release);
+
+    frames_published++;
+    header->frame_seq.store(static_cast<uint32_t>(frames_published), std::memory_order_release);
+    Wake(header->frame_seq);
+}
+
+void SharedMemoryExport::PublishAudio(const float* samples, size_t sample_count) {
+    if (!header) return;
+
+    while (sample_count > 0) {
+        uint32_t count = static_cast<uint32_t>(
+            std::min<size_t>(sample_count, SharedFrameLayout::AUDIO_BLOCK_SAMPLES));
+
+        uint64_t n = audio_blocks_published;
+        SharedAudioSlot& slot = *reinterpret_cast<SharedAudioSlot*>(
+            reinterpret_cast<uint8_t*>(audio_slots) + (n % SharedFrameLayout::AUDIO_SLOTS) * header->audio_slot_size);
+
+        slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.block_number = n;
+        slot.sample_count = count;
+        std::memcpy(slot.samples, samples, count * 2 * sizeof(float));
+        slot.sequence.store(2 * n + 2, std::memory_order_release);
+
+        audio_blocks_published++;
+        header->audio_seq.store(static_cast<uint32_t>(audio_blocks_published), std::memory_order_release);
+        Wake(header->audio_seq);
+
+        samples += count * 2;
+        sample_count -= count;
+    }
+}
+
+void SharedMemoryExport::Wake(std::atomic<uint32_t>& word) {
+#ifdef __linux__
+    // Shared (non-private) futex so waiters in other processes are woken
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;  // Readers poll frame_seq/audio_seq
+#endif
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "SharedFrameLayout.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * SharedMemoryExport - Publish Frames and Audio to POSIX Shared Memory
+ *
+ * Creates /dev/shm/<name> in SharedFrameLayout format and publishes each
+ * completed framebuffer and block of audio into its rings. External
+ * processes map the object read-only and consume in place; they never
+ * link against the emulator or block it (the writer never waits).
+ *
+ * Threads:
+ * - PublishFrame(): one producer (emulation thread)
+ * - PublishAudio(): one producer (emulation thread, once per frame)
+ *
+ * Interface:
+ * - Open(name): create + map (name without leading '/')
+ * - Close(): mark writer gone, wake readers, unmap and unlink
+ */
+class SharedMemoryExport {
+public:
+    SharedMemoryExport() = default;
+    ~SharedMemoryExport();
+
+    SharedMemoryExport(const SharedMemoryExport&) = delete;
+    SharedMemoryExport& operator=(const SharedMemoryExport&) = delete;
+
+    bool Open(const std::string& name);
+    void Close();
+    bool IsOpen() const { return header != nullptr; }
+
+    void PublishFrame(const uint8_t* framebuffer, uint64_t cycle);
+    void PublishAudio(const float* samples, size_t sample_count);
+
+private:
+    std::string shm_name;
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+
+    SharedFrameHeader* header = nullptr;
+    SharedFrameSlot* frame_slots = nullptr;
+    SharedAudioSlot* audio_slots = nullptr;
+
+    uint64_t frames_published = 0;
+    uint64_t audio_blocks_published = 0;
+
+    static void Wake(std::atomic<uint32_t>& word);
+};
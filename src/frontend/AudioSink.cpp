@@ -0,0 +1,276 @@
+#include "AudioSink.hpp"
+#include "../apu/AudioBuffer.hpp"
+#include <SDL2/SDL.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#ifdef GB_HAVE_ALSA
+#include <alsa/asoundlib.h>
+#endif
+
+// === Factory ===
+
+std::unique_ptr<AudioSink> AudioSink::Create(const std::string& name) {
+    if (name == "sdl") return std::make_unique<SDLAudioSink>();
+    if (name == "null") return std::make_unique<NullAudioSink>();
+    if (name.rfind("file:", 0) == 0 && name.size() > 5) {
+        return std::make_unique<FileAudioSink>(name.substr(5));
+    }
+#ifdef GB_HAVE_ALSA
+    if (name == "alsa") return std::make_unique<ALSAAudioSink>();
+#else
+    if (name == "alsa") {
+        std::cerr << "ALSA audio backend not compiled in\n";
+        return nullptr;
+    }
+#endif
+    std::cerr << "Unknown audio backend: " << name << "\n";
+    return nullptr;
+}
+
+void AudioSink::Render(float* output, size_t sample_count) {
+    // Muted/unfocused leaves samples in the AudioBuffer (the APU drops
+    // when it fills), same as before sinks existed
+    if (!buffer || muted.load(std::memory_order_relaxed) ||
+        !focused.load(std::memory_order_relaxed)) {
+        std::memset(output, 0, sample_count * 2 * sizeof(float));
+        return;
+    }
+
+    time_stretch.Process(*buffer, output, sample_count);
+
+    float vol = volume.load(std::memory_order_relaxed);
+    if (vol < 1.0f) {
+        for (size_t i = 0; i < sample_count * 2; i++) {
+            output[i] *= vol;
+        }
+    }
+}
+
+// === SDL ===
+
+bool SDLAudioSink::Open(AudioBuffer* audio_buffer) {
+    if (!audio_buffer) return false;
+    buffer = audio_buffer;
+
+    SDL_AudioSpec want, have;
+    SDL_memset(&want, 0, sizeof(want));
+    want.freq = SAMPLE_RATE;
+    want.format = AUDIO_F32;
+    want.channels = 2;
+    want.samples = 1024;
+    want.callback = Callback;
+    want.userdata = this;
+
+    device = SDL_OpenAudioDevice(nullptr, 0, &want, &have, 0);
+    if (device == 0) {
+        std::cerr << "SDL_OpenAudioDevice failed: " << SDL_GetError() << "\n";
+        return false;
+    }
+
+    SDL_PauseAudioDevice(device, 0);
+
+    std::cout << "Audio initialized: " << have.freq << "Hz, "
+              << (int)have.channels << " channels, "
+              << have.samples << " samples\n";
+
+    return true;
+}
+
+void SDLAudioSink::Close() {
+    if (device != 0) {
+        SDL_CloseAudioDevice(device);
+        device = 0;
+    }
+    buffer = nullptr;
+}
+
+void SDLAudioSink::Callback(void* userdata, uint8_t* stream, int len) {
+    SDLAudioSink* sink = static_cast<SDLAudioSink*>(userdata);
+    size_t sample_count = len / sizeof(float) / 2;
+    sink->Render(reinterpret_cast<float*>(stream), sample_count);
+}
+
+// === Paced (null / file) ===
+
+PacedAudioSink::~PacedAudioSink() {
+    Close();
+}
+
+bool PacedAudioSink::Open(AudioBuffer* audio_buffer) {
+    if (!audio_buffer) return false;
+    if (!Start()) return false;
+    buffer = audio_buffer;
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&PacedAudioSink::Run, this);
+    std::cout << "Audio initialized: " << GetName() << " sink, " << SAMPLE_RATE << "Hz\n";
+    return true;
+}
+
+void PacedAudioSink::Close() {
+    if (!thread.joinable()) return;
+    running.store(false, std::memory_order_release);
+    thread.join();
+    Finish();
+    buffer = nullptr;
+}
+
+void PacedAudioSink::Run() {
+    std::vector<float> block(PERIOD * 2);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t blocks = 0;
+
+    while (running.load(std::memory_order_acquire)) {
+        Render(block.data(), PERIOD);
+        WriteBlock(block.data(), PERIOD);
+
+        // Absolute schedule so rounding never accumulates into drift
+        blocks++;
+        auto due = start + std::chrono::nanoseconds(blocks * PERIOD * 1000000000ull / SAMPLE_RATE);
+        std::this_thread::sleep_until(due);
+    }
+}
+
+// === File ===
+
+static void PutLE16(FILE* f, uint16_t v) {
+    uint8_t b[2] = { static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8) };
+    std::fwrite(b, 1, 2, f);
+}
+
+static void PutLE32(FILE* f, uint32_t v) {
+    uint8_t b[4] = { static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8),
+                     static_cast<uint8_t>(v >> 16), static_cast<uint8_t>(v >> 24) };
+    std::fwrite(b, 1, 4, f);
+}
+
+bool FileAudioSink::Start() {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Failed to open audio file: " << path << "\n";
+        return false;
+    }
+    data_bytes = 0;
+    WriteHeader();
+    return true;
+}
+
+void FileAudioSink::WriteHeader() {
+    // RIFF/WAVE, format 3 = IEEE float, stereo 32-bit
+    std::fwrite("RIFF", 1, 4, file);
+    PutLE32(file, 36 + data_bytes);
+    std::fwrite("WAVEfmt ", 1, 8, file);
+    PutLE32(file, 16);
+    PutLE16(file, 3);
+    PutLE16(file, 2);
+    PutLE32(file, SAMPLE_RATE);
+    PutLE32(file, SAMPLE_RATE * 8);
+    PutLE16(file, 8);
+    PutLE16(file, 32);
+    std::fwrite("data", 1, 4, file);
+    PutLE32(file, data_bytes);
+}
+
+void FileAudioSink::WriteBlock(const float* samples, size_t sample_count) {
+    for (size_t i = 0; i < sample_count * 2; i++) {
+        uint32_t bits;
+        std::memcpy(&bits, &samples[i], 4);
+        PutLE32(file, bits);
+    }
+    data_bytes += static_cast<uint32_t>(sample_count * 8);
+}
+
+void FileAudioSink::Finish() {
+    if (!file) return;
+    std::fseek(file, 0, SEEK_SET);
+    WriteHeader();
+    std::fclose(file);
+    file = nullptr;
+    std::cout << "Audio written to: " << path << "\n";
+}
+
+// === ALSA ===
+
+#ifdef GB_HAVE_ALSA
+bool ALSAAudioSink::Open(AudioBuffer* audio_buffer) {
+    if (!audio_buffer) return false;
+
+    snd_pcm_t* handle = nullptr;
+    int err = snd_pcm_open(&handle, "default", SND_PCM_STREAM_PLAYBACK, 0);
+    if (err < 0) {
+        std::cerr << "snd_pcm_open failed: " << snd_strerror(err) << "\n";
+        return false;
+    }
+
+    snd_pcm_hw_params_t* hw;
+    snd_pcm_hw_params_alloca(&hw);
+    snd_pcm_hw_params_any(handle, hw);
+
+    unsigned rate = SAMPLE_RATE;
+    snd_pcm_uframes_t period = PERIOD;
+    snd_pcm_uframes_t buffer_size = PERIOD * PERIODS;
+
+    if ((err = snd_pcm_hw_params_set_access(handle, hw, SND_PCM_ACCESS_RW_INTERLEAVED)) < 0 ||
+        (err = snd_pcm_hw_params_set_format(handle, hw, SND_PCM_FORMAT_FLOAT_LE)) < 0 ||
+        (err = snd_pcm_hw_params_set_channels(handle, hw, 2)) < 0 ||
+        (err = snd_pcm_hw_params_set_rate_near(handle, hw, &rate, nullptr)) < 0 ||
+        (err = snd_pcm_hw_params_set_period_size_near(handle, hw, &period, nullptr)) < 0 ||
+        (err = snd_pcm_hw_params_set_buffer_size_near(handle, hw, &buffer_size)) < 0 ||
+        (err = snd_pcm_hw_params(handle, hw)) < 0) {
+        std::cerr << "ALSA hw_params failed: " << snd_strerror(err) << "\n";
+        snd_pcm_close(handle);
+        return false;
+    }
+
+    if (rate != SAMPLE_RATE) {
+        std::cerr << "ALSA device doesn't support " << SAMPLE_RATE << "Hz (got " << rate << ")\n";
+        snd_pcm_close(handle);
+        return false;
+    }
+
+    pcm = handle;
+    buffer = audio_buffer;
+
+    // Device buffering is tiny, so steer the AudioBuffer backlog down
+    // to about one emulated frame of samples
+    SetTargetBacklog(1024);
+
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&ALSAAudioSink::Run, this);
+
+    std::cout << "Audio initialized: ALSA " << rate << "Hz, period " << period
+              << ", buffer " << buffer_size << " samples\n";
+    return true;
+}
+
+void ALSAAudioSink::Close() {
+    if (thread.joinable()) {
+        running.store(false, std::memory_order_release);
+        thread.join();
+    }
+    if (pcm) {
+        snd_pcm_t* handle = static_cast<snd_pcm_t*>(pcm);
+        snd_pcm_drop(handle);
+        snd_pcm_close(handle);
+        pcm = nullptr;
+    }
+    buffer = nullptr;
+}
+
+void ALSAAudioSink::Run() {
+    snd_pcm_t* handle = static_cast<snd_pcm_t*>(pcm);
+    std::vector<float> block(PERIOD * 2);
+
+    while (running.load(std::memory_order_acquire)) {
+        Render(block.data(), PERIOD);
+
+        // Blocks until the device has room for one period
+        snd_pcm_sframes_t written = snd_pcm_writei(handle, block.data(), PERIOD);
+        if (written < 0) {
+            // Underrun (-EPIPE) or suspend: re-prepare and carry on
+            snd_pcm_recover(handle, static_cast<int>(written), 1);
+        }
+    }
+}
+#endif
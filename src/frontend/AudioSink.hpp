@@ -0,0 +1,170 @@
+#pragma once
+
+#include "../apu/TimeStretch.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AudioBuffer;
+
+/**
+ * AudioSink - Audio Output Backend
+ *
+ * Pulls samples from the emulator's AudioBuffer (through TimeStretch)
+ * and hands them to an output device. Backends:
+ * - "sdl":  SDL audio callback (default)
+ * - "alsa": direct ALSA PCM with small periods for low latency
+ *           (only when built with GB_HAVE_ALSA)
+ * - "null": discards samples at realtime pace (headless cabinets, benchmarks)
+ * - "file:<path>": writes a 32-bit float WAV at realtime pace
+ *
+ * Mute, focus, volume and speed are atomics written by the UI thread
+ * and read once per block by the output thread, so the output thread
+ * never calls back into the window system.
+ */
+class AudioSink {
+public:
+    static constexpr int SAMPLE_RATE = 48000;
+
+    virtual ~AudioSink() = default;
+
+    // Create a sink by name (see above). Returns nullptr for unknown names.
+    static std::unique_ptr<AudioSink> Create(const std::string& name);
+
+    // Start pulling from buffer. Returns false if the device can't be opened.
+    virtual bool Open(AudioBuffer* buffer) = 0;
+    virtual void Close() = 0;
+    virtual const char* GetName() const = 0;
+
+    // === Output State (any thread) ===
+    void SetMuted(bool m) { muted.store(m, std::memory_order_relaxed); }
+    void SetFocused(bool f) { focused.store(f, std::memory_order_relaxed); }
+    void SetVolume(float v) { volume.store(v, std::memory_order_relaxed); }
+    void SetSpeed(float multiplier) { time_stretch.SetSpeed(multiplier); }
+
+protected:
+    AudioBuffer* buffer = nullptr;
+
+    // Fill one block of interleaved stereo samples (output thread)
+    void Render(float* output, size_t sample_count);
+
+    // Device-side latency tuning, before the first Render()
+    void SetTargetBacklog(size_t samples) { time_stretch.SetTargetFill(samples); }
+
+private:
+    std::atomic<bool> muted{false};
+    std::atomic<bool> focused{true};
+    std::atomic<float> volume{1.0f};
+    TimeStretch time_stretch;
+};
+
+/**
+ * SDLAudioSink - SDL audio device, rendered from SDL's callback thread
+ */
+class SDLAudioSink : public AudioSink {
+public:
+    ~SDLAudioSink() override { Close(); }
+
+    bool Open(AudioBuffer* buffer) override;
+    void Close() override;
+    const char* GetName() const override { return "SDL"; }
+
+private:
+    uint32_t device = 0;        // SDL_AudioDeviceID
+    static void Callback(void* userdata, uint8_t* stream, int len);
+};
+
+/**
+ * PacedAudioSink - Base for sinks without a device clock
+ *
+ * Renders PERIOD-sample blocks on its own thread against an absolute
+ * 48kHz schedule and passes them to WriteBlock().
+ */
+class PacedAudioSink : public AudioSink {
+public:
+    static constexpr size_t PERIOD = 512;
+
+    ~PacedAudioSink() override;
+
+    bool Open(AudioBuffer* buffer) override;
+    void Close() override;
+
+protected:
+    virtual bool Start() { return true; }
+    virtual void WriteBlock(const float* samples, size_t sample_count) = 0;
+    virtual void Finish() {}
+
+private:
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+    void Run();
+};
+
+/**
+ * NullAudioSink - Consumes audio at realtime and discards it
+ */
+class NullAudioSink : public PacedAudioSink {
+public:
+    ~NullAudioSink() override { Close(); }
+
+    const char* GetName() const override { return "null"; }
+
+protected:
+    void WriteBlock(const float*, size_t) override {}
+};
+
+/**
+ * FileAudioSink - Records the output stream to a float WAV file
+ */
+class FileAudioSink : public PacedAudioSink {
+public:
+    explicit FileAudioSink(const std::string& path) : path(path) {}
+    ~FileAudioSink() override { Close(); }
+
+    const char* GetName() const override { return "file"; }
+
+protected:
+    bool Start() override;
+    void WriteBlock(const float* samples, size_t sample_count) override;
+    void Finish() override;
+
+private:
+    std::string path;
+    FILE* file = nullptr;
+    uint32_t data_bytes = 0;
+
+    void WriteHeader();
+};
+
+#ifdef GB_HAVE_ALSA
+/**
+ * ALSAAudioSink - Direct ALSA PCM output
+ *
+ * Bypasses SDL's mixing thread and its 1024-sample default buffer:
+ * 256-sample periods, 3 periods of device buffering (~16ms), written
+ * from a dedicated thread that blocks on the PCM.
+ */
+class ALSAAudioSink : public AudioSink {
+public:
+    static constexpr unsigned PERIOD = 256;
+    static constexpr unsigned PERIODS = 3;
+
+    ~ALSAAudioSink() override { Close(); }
+
+    bool Open(AudioBuffer* buffer) override;
+    void Close() override;
+    const char* GetName() const override { return "ALSA"; }
+
+private:
+    void* pcm = nullptr;        // snd_pcm_t*
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+    void Run();
+};
+#endif
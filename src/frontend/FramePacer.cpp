@@ -0,0 +1,80 @@
+#include "FramePacer.hpp"
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <time.h>
+#endif
+
+FramePacer::FramePacer(std::chrono::nanoseconds period)
+    : period(period)
+{
+    Reset();
+}
+
+void FramePacer::Reset() {
+    deadline = Clock::now();
+    sample_start = deadline;
+    sample_cpu = std::clock();
+    sample_frames = 0;
+    sample_late = 0;
+}
+
+void FramePacer::EndFrame(bool wait) {
+    deadline += period;
+    sample_frames++;
+
+    Clock::time_point now = Clock::now();
+    if (now > deadline) {
+        sample_late++;
+        if (now - deadline > period * MAX_LAG) deadline = now;
+        return;
+    }
+    if (wait) SleepUntil(deadline);
+}
+
+void FramePacer::EndUnpacedFrame() {
+    deadline = Clock::now();
+    sample_frames++;
+}
+
+bool FramePacer::SampleLoad(Load& load) {
+    Clock::time_point now = Clock::now();
+    double wall = std::chrono::duration<double>(now - sample_start).count();
+    if (wall < 1.0) return false;
+
+    std::clock_t cpu_now = std::clock();
+    double cpu = static_cast<double>(cpu_now - sample_cpu) / CLOCKS_PER_SEC;
+    load.frames_per_second = sample_frames / wall;
+    load.cpu_ms_per_frame = sample_frames ? cpu * 1000.0 / sample_frames : 0;
+    load.cpu_percent = cpu * 100.0 / wall;
+    load.late_frames = sample_late;
+
+    sample_start = now;
+    sample_cpu = cpu_now;
+    sample_frames = 0;
+    sample_late = 0;
+    return true;
+}
+
+void FramePacer::SleepUntil(Clock::time_point target) const {
+    Clock::time_point wake = target - spin_margin;
+#ifdef __linux__
+    // steady_clock is CLOCK_MONOTONIC, so its time points are valid
+    // absolute clock_nanosleep targets
+    auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(wake.time_since_epoch());
+    if (since_epoch.count() > 0) {
+        timespec until;
+        until.tv_sec = static_cast<time_t>(since_epoch.count() / 1000000000);
+        until.tv_nsec = static_cast<long>(since_epoch.count() % 1000000000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr) == EINTR) {}
+    }
+#else
+    std::this_thread::sleep_until(wake);
+#endif
+
+    // Short spin for the wakeup latency the sleep can't promise
+    while (Clock::now() < target) {
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * FramePacer - Absolute-Deadline Frame Pacing and Host Load
+ *
+ * Frame N is due at start + N * period. EndFrame() advances the deadline
+ * and sleeps until it, so time spent emulating, rendering or blocked in a
+ * vsync'd present is absorbed instead of added (a relative sleep_for per
+ * frame drifts by every oversleep). The sleep is an absolute
+ * clock_nanosleep to just before the deadline, then a short spin on the
+ * clock for the rest (Linux; std::this_thread::sleep_until elsewhere).
+ *
+ * Falling more than MAX_LAG frames behind (fast-forward, a stall) moves
+ * the schedule to now rather than running the missed frames back to back.
+ *
+ * Host load is sampled about once per second: process CPU time (every
+ * thread: emulation, audio output, APU synthesis) per emulated frame and
+ * per wall second, plus how many deadlines were missed.
+ */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Load {
+        double frames_per_second = 0;
+        double cpu_ms_per_frame = 0;   // Process CPU time per emulated frame
+        double cpu_percent = 0;        // Process CPU time per wall time (100 = one core)
+        uint32_t late_frames = 0;      // Frames that finished after their deadline
+    };
+
+    explicit FramePacer(std::chrono::nanoseconds period);
+
+    // Restart the schedule and the load sample from now (after a pause)
+    void Reset();
+
+    // One frame done; sleep until its deadline unless `wait` is false
+    // (several frames batched per wakeup)
+    void EndFrame(bool wait = true);
+
+    // One frame done with pacing off (fast-forward): counted for the load
+    // sample but never late, and the schedule restarts from now
+    void EndUnpacedFrame();
+
+    // True about once per second, with the load since the last sample
+    bool SampleLoad(Load& load);
+
+    // Spin before each deadline; covers the sleep's wakeup latency
+    void SetSpinMargin(std::chrono::nanoseconds margin) { spin_margin = margin; }
+
+private:
+    static constexpr int MAX_LAG = 4;
+
+    std::chrono::nanoseconds period;
+    std::chrono::nanoseconds spin_margin{std::chrono::microseconds(100)};
+    Clock::time_point deadline;
+
+    // Load sample
+    Clock::time_point sample_start;
+    std::clock_t sample_cpu = 0;
+    uint32_t sample_frames = 0;
+    uint32_t sample_late = 0;
+
+    void SleepUntil(Clock::time_point target) const;
+};
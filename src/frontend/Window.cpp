@@ -1,6 +1,5 @@
 #include "Window.hpp"
 #include "Config.hpp"
-#include "../apu/AudioBuffer.hpp"
 #include <iostream>
 #include <cstring>
 #include <filesystem>
@@ -66,8 +65,6 @@ Window::Window()
 {
     keys_current.fill(false);
     keys_previous.fill(false);
-    pixels.fill(PALETTE[0]);
-    last_framebuffer.resize(160 * 144);
 }
 
 Window::~Window() {
@@ -82,6 +79,10 @@ Window::~Window() {
 bool Window::Init(const std::string& title, int window_scale) {
     scale = window_scale;
     
+    // Pixel buffers only exist once there is a window (headless runs skip Init)
+    pixels.assign(160 * 144, PALETTE[0]);
+    last_framebuffer.assign(160 * 144, 0);
+    
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
         std::cerr << "SDL_Init failed: " << SDL_GetError() << "\n";
         return false;
@@ -166,72 +167,34 @@ void Window::RestoreWindowState() {
     // Called from Init, already handled there
 }
 
-bool Window::InitAudio(AudioBuffer* buffer) {
+bool Window::InitAudio(AudioBuffer* buffer, const std::string& backend) {
     if (!buffer) return false;
     
-    audio_buffer = buffer;
+    CloseAudio();
+    audio_sink = AudioSink::Create(backend);
+    if (!audio_sink) return false;
     
-    SDL_AudioSpec want, have;
-    SDL_memset(&want, 0, sizeof(want));
-    want.freq = 48000;
-    want.format = AUDIO_F32;
-    want.channels = 2;
-    want.samples = 1024;
-    want.callback = AudioCallback;
-    want.userdata = this;  // Pass Window* for volume/mute
+    // Focus is tracked from window events here; the sink's output thread
+    // never queries SDL window state
+    focused = window && (SDL_GetWindowFlags(window) & SDL_WINDOW_INPUT_FOCUS);
+    UpdateAudioState();
     
-    audio_device = SDL_OpenAudioDevice(nullptr, 0, &want, &have, 0);
-    if (audio_device == 0) {
-        std::cerr << "SDL_OpenAudioDevice failed: " << SDL_GetError() << "\n";
+    if (!audio_sink->Open(buffer)) {
+        audio_sink.reset();
         return false;
     }
-    
-    SDL_PauseAudioDevice(audio_device, 0);
-    
-    std::cout << "Audio initialized: " << have.freq << "Hz, " 
-              << (int)have.channels << " channels, "
-              << have.samples << " samples\n";
-    
     return true;
 }
 
 void Window::CloseAudio() {
-    if (audio_device != 0) {
-        SDL_CloseAudioDevice(audio_device);
-        audio_device = 0;
-    }
-    audio_buffer = nullptr;
+    audio_sink.reset();
 }
 
-void Window::AudioCallback(void* userdata, uint8_t* stream, int len) {
-    Window* win = static_cast<Window*>(userdata);
-    float* output = reinterpret_cast<float*>(stream);
-    size_t sample_count = len / sizeof(float) / 2;
-    
-    if (win && win->audio_buffer) {
-        // Check focus - mute if window not focused
-        bool should_mute = win->muted;
-        if (win->window) {
-            Uint32 flags = SDL_GetWindowFlags(win->window);
-            if (!(flags & SDL_WINDOW_INPUT_FOCUS)) {
-                should_mute = true;  // Mute when not focused
-            }
-        }
-        
-        if (should_mute) {
-            std::memset(stream, 0, len);
-        } else {
-            win->audio_buffer->Pop(output, sample_count);
-            // Apply volume
-            if (win->volume < 1.0f) {
-                for (size_t i = 0; i < sample_count * 2; i++) {
-                    output[i] *= win->volume;
-                }
-            }
-        }
-    } else {
-        std::memset(stream, 0, len);
-    }
+void Window::UpdateAudioState() {
+    if (!audio_sink) return;
+    audio_sink->SetMuted(muted);
+    audio_sink->SetFocused(focused);
+    audio_sink->SetVolume(volume);
 }
 
 void Window::RenderFrame(const uint8_t* framebuffer) {
@@ -259,22 +222,22 @@ void Window::RenderFrame(const uint8_t* framebuffer) {
     
     // Draw OSD
     if (show_fps) {
-        std::string fps_str = "FPS:" + std::to_string(fps_display);
+        char fps_str[16];
+        std::snprintf(fps_str, sizeof(fps_str), "FPS:%d", fps_display);
         DrawString(2, 144 - 10, fps_str, 0xFFFFFF00);
     }
     
-    // Draw notifications (stacked from top)
+    // Draw notifications (stacked from top), compacting out expired ones
     int notify_y = 2;
-    for (auto it = notifications.begin(); it != notifications.end(); ) {
-        DrawString(2, notify_y, it->text, 0xFFFFFFFF);
+    int kept = 0;
+    for (int i = 0; i < notification_count; i++) {
+        DrawString(2, notify_y, notifications[i].text, 0xFFFFFFFF);
         notify_y += 10;
-        it->frames_remaining--;
-        if (it->frames_remaining <= 0) {
-            it = notifications.erase(it);
-        } else {
-            ++it;
+        if (--notifications[i].frames_remaining > 0) {
+            notifications[kept++] = notifications[i];
         }
     }
+    notification_count = kept;
     
     SDL_RenderPresent(renderer);
 }
@@ -321,6 +284,26 @@ bool Window::ProcessEvents() {
             case SDL_DROPFILE:
                 SDL_free(event.drop.file);
                 break;
+                
+            case SDL_WINDOWEVENT:
+                // Mute when not focused
+                if (event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED ||
+                    event.window.event == SDL_WINDOWEVENT_FOCUS_LOST) {
+                    focused = event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED;
+                    UpdateAudioState();
+                }
+                
+                // Visibility for the idle policy (see RunGUI)
+                if (event.window.event == SDL_WINDOWEVENT_MINIMIZED ||
+                    event.window.event == SDL_WINDOWEVENT_HIDDEN) {
+                    hidden = true;
+                } else if (event.window.event == SDL_WINDOWEVENT_RESTORED ||
+                           event.window.event == SDL_WINDOWEVENT_MAXIMIZED ||
+                           event.window.event == SDL_WINDOWEVENT_SHOWN ||
+                           event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+                    hidden = false;
+                }
+                break;
         }
     }
     
@@ -337,8 +320,11 @@ bool Window::IsKeyJustPressed(SDL_Scancode key) const {
 
 void Window::AdjustVolume(float delta) {
     volume = std::max(0.0f, std::min(1.0f, volume + delta));
+    UpdateAudioState();
     int percent = static_cast<int>(volume * 100);
-    ShowNotification("VOL:" + std::to_string(percent) + "%");
+    char text[16];
+    std::snprintf(text, sizeof(text), "VOL:%d%%", percent);
+    ShowNotification(text);
 }
 
 void Window::SaveScreenshot() {
@@ -360,11 +346,15 @@ void Window::SaveScreenshot() {
     ShowNotification("SCREENSHOT SAVED");
 }
 
-void Window::ShowNotification(const std::string& text) {
-    notifications.push_back({text, 120});  // 2 seconds at 60fps
-    while (notifications.size() > 5) {
-        notifications.pop_front();
+void Window::ShowNotification(const char* text) {
+    if (notification_count == MAX_NOTIFICATIONS) {
+        // Drop the oldest
+        std::copy(notifications.begin() + 1, notifications.end(), notifications.begin());
+        notification_count--;
     }
+    Notification& slot = notifications[notification_count++];
+    std::snprintf(slot.text, sizeof(slot.text), "%s", text);
+    slot.frames_remaining = 120;  // 2 seconds at 60fps
 }
 
 void Window::DrawChar(int x, int y, char c, uint32_t color) {
@@ -410,10 +400,10 @@ void Window::DrawChar(int x, int y, char c, uint32_t color) {
     }
 }
 
-void Window::DrawString(int x, int y, const std::string& str, uint32_t color) {
+void Window::DrawString(int x, int y, const char* str, uint32_t color) {
     int curX = x;
-    for (char c : str) {
-        DrawChar(curX, y, c, color);
+    for (; *str; str++) {
+        DrawChar(curX, y, *str, color);
         curX += 8;
     }
 }
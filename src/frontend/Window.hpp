@@ -6,8 +6,8 @@
 #include <array>
 #include <future>
 #include <atomic>
-#include <deque>
 #include <vector>
+#include "AudioSink.hpp"
 
 class AudioBuffer;
 
@@ -17,7 +17,7 @@ class AudioBuffer;
  * Handles:
  * - Window creation and management
  * - Framebuffer display (160x144 scaled)
- * - Audio output via SDL
+ * - Audio output via pluggable AudioSink (time-stretched to the emulation speed)
  * - File dialog for ROM loading
  * - ROM info display
  * - QOL: Volume, mute, FPS, screenshots, notifications
@@ -30,8 +30,8 @@ public:
     // Initialize SDL2 and create window
     bool Init(const std::string& title, int scale = 4);
     
-    // Initialize audio with buffer connection
-    bool InitAudio(AudioBuffer* buffer);
+    // Initialize audio with buffer connection ("sdl", "alsa", "null", "file:<path>")
+    bool InitAudio(AudioBuffer* buffer, const std::string& backend = "sdl");
     void CloseAudio();
     
     // Display framebuffer (2-bit color indices)
@@ -55,6 +55,9 @@ public:
     // Check if window is open
     bool IsOpen() const { return window != nullptr; }
     
+    // Minimized or hidden: nothing drawn would be seen
+    bool IsHidden() const { return hidden; }
+    
     // Get key states
     bool IsKeyPressed(SDL_Scancode key) const;
     bool IsKeyJustPressed(SDL_Scancode key) const;
@@ -66,25 +69,28 @@ public:
     // === QOL Features ===
     
     // Volume (0.0 - 1.0)
-    void SetVolume(float vol) { volume = std::max(0.0f, std::min(1.0f, vol)); }
+    void SetVolume(float vol) { volume = std::max(0.0f, std::min(1.0f, vol)); UpdateAudioState(); }
     float GetVolume() const { return volume; }
     void AdjustVolume(float delta);
     
     // Mute
-    void SetMuted(bool m) { muted = m; }
+    void SetMuted(bool m) { muted = m; UpdateAudioState(); }
     bool IsMuted() const { return muted; }
-    void ToggleMute() { muted = !muted; }
+    void ToggleMute() { muted = !muted; UpdateAudioState(); }
     
     // FPS display
     void SetShowFPS(bool show) { show_fps = show; }
     bool GetShowFPS() const { return show_fps; }
     void ToggleFPS() { show_fps = !show_fps; }
     
+    // Emulation speed multiplier for audio time-stretching (1.0 = realtime)
+    void SetAudioSpeed(float multiplier) { if (audio_sink) audio_sink->SetSpeed(multiplier); }
+    
     // Screenshot
     void SaveScreenshot();
     
     // Notifications (auto-dismiss after ~2 seconds)
-    void ShowNotification(const std::string& text);
+    void ShowNotification(const char* text);
     
     // Save/restore window state
     void SaveWindowState();
@@ -117,16 +123,17 @@ private:
         0xFF101808   // Darkest
     };
     
-    // Pixel buffer for texture update
-    std::array<uint32_t, 160 * 144> pixels;
+    // Pixel buffer for texture update (allocated by Init)
+    std::vector<uint32_t> pixels;
     std::vector<uint32_t> last_framebuffer;  // For clean screenshots
     
     bool quit_requested;
+    bool hidden = false;
     
     // Audio
-    SDL_AudioDeviceID audio_device = 0;
-    AudioBuffer* audio_buffer = nullptr;
-    static void AudioCallback(void* userdata, uint8_t* stream, int len);
+    std::unique_ptr<AudioSink> audio_sink;
+    bool focused = true;
+    void UpdateAudioState();        // Push volume/mute/focus to the sink
     
     // === QOL State ===
     float volume = 1.0f;
@@ -136,15 +143,17 @@ private:
     int fps_display = 0;
     uint32_t fps_last_time = 0;
     
-    // Notification queue
+    // Notification queue (fixed slots, oldest first: nothing allocates per frame)
+    static constexpr int MAX_NOTIFICATIONS = 5;
     struct Notification {
-        std::string text;
+        char text[24];
         int frames_remaining;
     };
-    std::deque<Notification> notifications;
+    std::array<Notification, MAX_NOTIFICATIONS> notifications;
+    int notification_count = 0;
     
     // Bitmap font rendering
     static const uint8_t FONT[38][8];
     void DrawChar(int x, int y, char c, uint32_t color);
-    void DrawString(int x, int y, const std::string& str, uint32_t color);
+    void DrawString(int x, int y, const char* str, uint32_t color);
 };
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+class NodeArena;
+
+/**
+ * ArenaAllocated - Placement of Emulator Components in a NodeArena
+ *
+ * Empty base for the Emulator and its components. `new` places the object
+ * in the calling thread's current NodeArena (see NodeArena::Scope) when one
+ * is set, otherwise on the ordinary heap, so nothing changes outside the
+ * instance scheduler. Each block carries a small header naming its arena,
+ * which lets `delete` run from any thread.
+ */
+class ArenaAllocated {
+public:
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr) noexcept;
+};
@@ -0,0 +1,280 @@
+#include "InstanceScheduler.hpp"
+#include "../Emulator.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// === Topology ===
+
+struct CpuSlot {
+    int cpu;
+    int node;
+};
+
+// "0-3,8,10-11" -> {0,1,2,3,8,10,11}
+static std::vector<int> ParseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range[0] < '0' || range[0] > '9') continue;
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// CPUs this process may run on, grouped by NUMA node and interleaved
+// across nodes so the first N workers spread over every node
+static std::vector<CpuSlot> ReadTopology() {
+    std::map<int, std::vector<int>> nodes;
+
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool have_affinity = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    for (int node = 0; node < 1024; node++) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) {
+            if (node > 0 && !nodes.empty()) break;
+            continue;
+        }
+        std::string text;
+        std::getline(file, text);
+        for (int cpu : ParseCpuList(text)) {
+            if (!have_affinity || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))) {
+                nodes[node].push_back(cpu);
+            }
+        }
+    }
+
+    // No sysfs NUMA info: one node with every allowed CPU
+    if (nodes.empty() && have_affinity) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) nodes[0].push_back(cpu);
+        }
+    }
+#endif
+
+    std::vector<CpuSlot> slots;
+    if (nodes.empty()) {
+        // Unknown platform: unpinned, single node
+        unsigned count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < count; i++) slots.push_back({ -1, 0 });
+        return slots;
+    }
+
+    for (size_t round = 0;; round++) {
+        bool any = false;
+        for (const auto& node : nodes) {
+            if (round < node.second.size()) {
+                slots.push_back({ node.second[round], node.first });
+                any = true;
+            }
+        }
+        if (!any) break;
+    }
+    return slots;
+}
+
+void InstanceScheduler::Pin(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+// === Lifetime ===
+
+InstanceScheduler::InstanceScheduler(const Config& config)
+    : config(config)
+{
+    std::vector<CpuSlot> slots = ReadTopology();
+    unsigned count = config.workers ? config.workers : static_cast<unsigned>(slots.size());
+
+    // One arena per NUMA node that has a worker
+    std::map<int, unsigned> node_index;
+    for (unsigned i = 0; i < count; i++) {
+        const CpuSlot& slot = slots[i % slots.size()];
+        if (!node_index.count(slot.node)) {
+            node_index[slot.node] = static_cast<unsigned>(arenas.size());
+            arenas.push_back(std::make_unique<NodeArena>(slot.node, config.huge_pages));
+        }
+
+        auto worker = std::make_unique<Worker>();
+        worker->index = i;
+        worker->cpu = config.pin_threads ? slot.cpu : -1;
+        worker->node = node_index[slot.node];
+        workers.push_back(std::move(worker));
+    }
+
+    for (auto& worker : workers) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w] { WorkerLoop(*w); });
+    }
+}
+
+InstanceScheduler::~InstanceScheduler() {
+    stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+    }
+    idle_cv.notify_all();
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+// === Public Interface ===
+
+uint32_t InstanceScheduler::Spawn(Setup setup, Quantum quantum, Priority priority) {
+    auto instance = std::make_unique<Instance>();
+    instance->id = next_id++;
+    instance->priority = priority;
+    instance->setup = std::move(setup);
+    instance->quantum = std::move(quantum);
+    uint32_t id = instance->id;
+
+    {
+        std::lock_guard<std::mutex> lock(done_mutex);
+        live++;
+    }
+    spawned++;
+
+    Worker& home = *workers[next_worker++ % workers.size()];
+    Push(home, std::move(instance));
+    return id;
+}
+
+void InstanceScheduler::WaitIdle() {
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done_cv.wait(lock, [this] { return live == 0; });
+}
+
+InstanceScheduler::Stats InstanceScheduler::GetStats() const {
+    return { spawned.load(), finished.load(), failed.load(), quanta.load(), steals.load() };
+}
+
+// === Queues ===
+
+void InstanceScheduler::Push(Worker& worker, std::unique_ptr<Instance> instance) {
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queues[static_cast<int>(instance->priority)].push_back(std::move(instance));
+    }
+    // Pairs with the sleepers/runnable check in WorkerLoop (both seq_cst),
+    // so either we see the sleeper or it sees the new work
+    runnable++;
+    if (sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+        idle_cv.notify_one();
+    }
+}
+
+std::unique_ptr<InstanceScheduler::Instance> InstanceScheduler::Pop(Worker& worker) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    bool batch_first = (++worker.picks & 3) == 0;
+    Queue& first = worker.queues[static_cast<int>(batch_first ? Priority::BATCH : Priority::INTERACTIVE)];
+    Queue& second = worker.queues[static_cast<int>(batch_first ? Priority::INTERACTIVE : Priority::BATCH)];
+    Queue& queue = !first.empty() ? first : second;
+    if (queue.empty()) return nullptr;
+
+    std::unique_ptr<Instance> instance = std::move(queue.front());
+    queue.pop_front();
+    runnable--;
+    return instance;
+}
+
+std::unique_ptr<InstanceScheduler::Instance> InstanceScheduler::Steal(Worker& thief) {
+    if (runnable.load() <= 0) return nullptr;
+
+    // Same node first: the victim's instances live in our arena
+    for (int same_node = 1; same_node >= 0; same_node--) {
+        for (size_t i = 1; i < workers.size(); i++) {
+            Worker& victim = *workers[(thief.index + i) % workers.size()];
+            if ((victim.node == thief.node) != (same_node == 1)) continue;
+
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            for (Queue* queue : { &victim.queues[0], &victim.queues[1] }) {
+                if (queue->empty()) continue;
+                std::unique_ptr<Instance> instance = std::move(queue->back());
+                queue->pop_back();
+                runnable--;
+                steals++;
+                return instance;
+            }
+        }
+    }
+    return nullptr;
+}
+
+// === Workers ===
+
+void InstanceScheduler::WorkerLoop(Worker& worker) {
+    if (worker.cpu >= 0) Pin(worker.cpu);
+    NodeArena* arena = arenas[worker.node].get();
+
+    while (!stopping.load()) {
+        std::unique_ptr<Instance> instance = Pop(worker);
+        if (!instance) instance = Steal(worker);
+        if (!instance) {
+            std::unique_lock<std::mutex> lock(idle_mutex);
+            sleepers++;
+            idle_cv.wait(lock, [this] { return stopping.load() || runnable.load() > 0; });
+            sleepers--;
+            continue;
+        }
+
+        // First quantum: build the machine in this node's arena
+        if (!instance->emu) {
+            NodeArena::Scope scope(arena);
+            instance->emu = std::make_unique<Emulator>();
+            if (!instance->setup || !instance->setup(*instance->emu)) {
+                Retire(std::move(instance), false);
+                continue;
+            }
+        }
+
+        if (RunQuantum(*instance)) {
+            Push(worker, std::move(instance));
+        } else {
+            Retire(std::move(instance), true);
+        }
+    }
+}
+
+bool InstanceScheduler::RunQuantum(Instance& instance) {
+    Emulator& emu = *instance.emu;
+    if (config.quantum_cycles) {
+        emu.StepCycles(config.quantum_cycles);
+    } else {
+        for (uint32_t i = 0; i < std::max(config.quantum_frames, 1u); i++) {
+            emu.RunFrame();
+        }
+    }
+    quanta++;
+    return !instance.quantum || instance.quantum(emu);
+}
+
+void InstanceScheduler::Retire(std::unique_ptr<Instance> instance, bool ok) {
+    instance.reset();
+    (ok ? finished : failed)++;
+
+    std::lock_guard<std::mutex> lock(done_mutex);
+    if (--live == 0) done_cv.notify_all();
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "NodeArena.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Emulator;
+
+/**
+ * InstanceScheduler - M:N Scheduling of Emulator Instances on Worker Threads
+ *
+ * For batch hosts running many more instances than cores. A fixed pool of
+ * worker threads, each pinned to one CPU, runs instances in round-robin
+ * quanta of emulated time; an instance is only ever on one worker at a
+ * time, so Emulator needs no locking.
+ *
+ * Scheduling:
+ * - Each worker owns a queue per priority and runs quanta from the front,
+ *   requeueing at the back; idle workers steal from other workers' backs,
+ *   same NUMA node first
+ * - INTERACTIVE instances run before BATCH ones, except every fourth pick
+ *   prefers BATCH so a busy interactive set can't starve the batch work
+ * - Quanta are N frames (RunFrame) or N T-cycles (StepCycles)
+ *
+ * Memory:
+ * - One NodeArena per NUMA node (2MB huge-page chunks, node-preferred)
+ * - An instance is constructed on the first worker that runs it, inside
+ *   that worker's node arena, so its state starts out node-local
+ *
+ * Callbacks run on worker threads:
+ * - setup(emu): load ROM/boot ROM and Reset; false drops the instance
+ * - quantum(emu): after each quantum (inputs, result checks, output);
+ *   false finishes the instance and frees it
+ */
+class InstanceScheduler {
+public:
+    enum class Priority { INTERACTIVE, BATCH };
+
+    using Setup = std::function<bool(Emulator&)>;
+    using Quantum = std::function<bool(Emulator&)>;
+
+    struct Config {
+        unsigned workers = 0;               // 0 = one per online CPU
+        uint32_t quantum_frames = 1;        // Frames per quantum, or...
+        uint32_t quantum_cycles = 0;        // ...T-cycles per quantum when non-zero
+        bool pin_threads = true;
+        bool huge_pages = true;
+    };
+
+    struct Stats {
+        uint64_t spawned;
+        uint64_t finished;
+        uint64_t failed;       // setup returned false
+        uint64_t quanta;
+        uint64_t steals;
+    };
+
+    explicit InstanceScheduler(const Config& config);
+    ~InstanceScheduler();  // Stops workers; unfinished instances are dropped
+
+    InstanceScheduler(const InstanceScheduler&) = delete;
+    InstanceScheduler& operator=(const InstanceScheduler&) = delete;
+
+    // Thread-safe; returns the instance id
+    uint32_t Spawn(Setup setup, Quantum quantum, Priority priority = Priority::BATCH);
+
+    // Block until every spawned instance has finished or failed
+    void WaitIdle();
+
+    Stats GetStats() const;
+    unsigned GetWorkerCount() const { return static_cast<unsigned>(workers.size()); }
+    unsigned GetNodeCount() const { return static_cast<unsigned>(arenas.size()); }
+
+private:
+    struct Instance {
+        uint32_t id;
+        Priority priority;
+        Setup setup;
+        Quantum quantum;
+        std::unique_ptr<Emulator> emu;   // Built lazily on a worker
+    };
+
+    using Queue = std::deque<std::unique_ptr<Instance>>;
+
+    struct Worker {
+        unsigned index;
+        int cpu;                // -1 = not pinned
+        unsigned node;          // Index into arenas
+        std::mutex mutex;
+        Queue queues[2];        // Indexed by Priority
+        uint32_t picks = 0;
+        std::thread thread;
+    };
+
+    Config config;
+
+    // Arenas outlive the workers (and the instances they hold)
+    std::vector<std::unique_ptr<NodeArena>> arenas;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::atomic<bool> stopping{false};
+    std::atomic<int64_t> runnable{0};      // Queued instances across all workers
+    std::atomic<int> sleepers{0};
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    uint64_t live = 0;                     // Spawned and not yet finished (done_mutex)
+
+    std::atomic<uint32_t> next_id{1};
+    std::atomic<unsigned> next_worker{0};
+    std::atomic<uint64_t> spawned{0};
+    std::atomic<uint64_t> finished{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> quanta{0};
+    std::atomic<uint64_t> steals{0};
+
+    void WorkerLoop(Worker& worker);
+    void Push(Worker& worker, std::unique_ptr<Instance> instance);
+    std::unique_ptr<Instance> Pop(Worker& worker);
+    std::unique_ptr<Instance> Steal(Worker& thief);
+    bool RunQuantum(Instance& instance);
+    void Retire(std::unique_ptr<Instance> instance, bool ok);
+
+    static void Pin(int cpu);
+};
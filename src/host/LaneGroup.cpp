@@ -0,0 +1,200 @@
+#include "LaneGroup.hpp"
+#include "../Emulator.hpp"
+#include "../util/Hash.hpp"
+
+#include <iostream>
+#include <unordered_map>
+
+LaneGroup::LaneGroup(unsigned lanes)
+    : lane_machine(lanes, nullptr)
+    , lane_input(lanes, 0)
+{
+}
+
+LaneGroup::~LaneGroup() = default;
+
+// === Setup ===
+
+std::unique_ptr<Emulator> LaneGroup::NewEmulator() {
+    if (!spares.empty()) {
+        std::unique_ptr<Emulator> emu = std::move(spares.back());
+        spares.pop_back();
+        return emu;
+    }
+    // Every machine loads the same file, so they share one ROM image
+    auto emu = std::make_unique<Emulator>();
+    if (!boot_rom_path.empty() && !emu->LoadBootROM(boot_rom_path)) return nullptr;
+    if (!emu->LoadROM(rom_path)) return nullptr;
+    return emu;
+}
+
+bool LaneGroup::Load(const std::string& rom, const std::string& boot_rom) {
+    rom_path = rom;
+    boot_rom_path = boot_rom;
+    machines.clear();
+    spares.clear();
+    stats = {};
+    frames_since_merge = 0;
+
+    auto machine = std::make_unique<Machine>();
+    machine->emu = NewEmulator();
+    if (!machine->emu) return false;
+    machine->emu->Reset();
+
+    for (unsigned lane = 0; lane < lane_machine.size(); lane++) {
+        lane_machine[lane] = machine.get();
+        lane_input[lane] = 0;
+        machine->lanes.push_back(lane);
+    }
+    machines.push_back(std::move(machine));
+    return true;
+}
+
+void LaneGroup::SetInput(unsigned lane, uint8_t buttons) {
+    lane_input[lane] = buttons;
+}
+
+// === Frame ===
+
+void LaneGroup::RunFrame() {
+    Split();
+    for (auto& machine : machines) {
+        ApplyInput(*machine);
+        machine->emu->RunFrame();
+    }
+    stats.machine_frames += machines.size();
+    stats.lane_frames += lane_machine.size();
+
+    if (merge_interval && ++frames_since_merge >= merge_interval) {
+        frames_since_merge = 0;
+        Merge();
+    }
+}
+
+// Only edges are sent, like a real pad: a press can raise the joypad interrupt
+void LaneGroup::ApplyInput(Machine& machine) {
+    uint8_t changed = machine.held ^ machine.input;
+    for (uint8_t button = 0; button < 8; button++) {
+        if (changed & (1 << button)) {
+            machine.emu->SetButton(button, (machine.input >> button) & 1);
+        }
+    }
+    machine.held = machine.input;
+}
+
+const Emulator& LaneGroup::GetLane(unsigned lane) const {
+    return *lane_machine[lane]->emu;
+}
+
+const uint8_t* LaneGroup::GetFramebuffer(unsigned lane) const {
+    return lane_machine[lane]->emu->GetFramebuffer();
+}
+
+bool LaneGroup::SaveState(unsigned lane, std::vector<uint8_t>& out) {
+    return lane_machine[lane]->emu->SaveState(out);
+}
+
+// === Divergence ===
+
+// Lanes of one machine that want different buttons get their own copies;
+// the group already matching the machine's input (or the first) stays put
+void LaneGroup::Split() {
+    size_t count = machines.size();
+    for (size_t m = 0; m < count; m++) {
+        Machine& source = *machines[m];
+
+        bool diverged = false;
+        for (unsigned lane : source.lanes) {
+            if (lane_input[lane] != lane_input[source.lanes[0]]) {
+                diverged = true;
+                break;
+            }
+        }
+        if (!diverged) {
+            source.input = lane_input[source.lanes[0]];
+            continue;
+        }
+
+        // Group lanes by input, keeping lane order within each group
+        std::vector<std::pair<uint8_t, std::vector<unsigned>>> groups;
+        for (unsigned lane : source.lanes) {
+            uint8_t input = lane_input[lane];
+            auto it = groups.begin();
+            while (it != groups.end() && it->first != input) ++it;
+            if (it == groups.end()) {
+                groups.push_back({ input, {} });
+                it = groups.end() - 1;
+            }
+            it->second.push_back(lane);
+        }
+
+        size_t keep = 0;
+        for (size_t g = 0; g < groups.size(); g++) {
+            if (groups[g].first == source.input) keep = g;
+        }
+
+        source.emu->SaveState(source.state);
+        for (size_t g = 0; g < groups.size(); g++) {
+            if (g == keep) continue;
+
+            auto clone = std::make_unique<Machine>();
+            clone->emu = NewEmulator();
+            if (!clone->emu || !clone->emu->LoadState(source.state)) {
+                // Out of memory or a bad ROM path can't happen after Load
+                // succeeded; if it does, the lanes stay on the source
+                std::cerr << "LaneGroup: failed to clone a machine\n";
+                continue;
+            }
+            clone->held = source.held;   // Part of the cloned Joypad state
+            clone->input = groups[g].first;
+            clone->lanes = std::move(groups[g].second);
+            for (unsigned lane : clone->lanes) lane_machine[lane] = clone.get();
+            machines.push_back(std::move(clone));
+            stats.splits++;
+        }
+
+        source.input = groups[keep].first;
+        source.lanes.clear();
+        for (unsigned lane = 0; lane < lane_machine.size(); lane++) {
+            if (lane_machine[lane] == &source) source.lanes.push_back(lane);
+        }
+    }
+}
+
+// === Reconvergence ===
+
+// Machines with byte-identical save states behave identically from here
+// on, whatever inputs got them there: fold each into the first one seen
+void LaneGroup::Merge() {
+    if (machines.size() < 2) return;
+
+    std::unordered_multimap<uint64_t, Machine*> seen;
+    std::vector<std::unique_ptr<Machine>> survivors;
+    for (auto& machine : machines) {
+        machine->emu->SaveState(machine->state);
+        uint64_t hash = HashBytes(machine->state);
+
+        Machine* twin = nullptr;
+        auto range = seen.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second->state == machine->state) {
+                twin = it->second;
+                break;
+            }
+        }
+
+        if (!twin) {
+            seen.emplace(hash, machine.get());
+            survivors.push_back(std::move(machine));
+            continue;
+        }
+
+        for (unsigned lane : machine->lanes) {
+            lane_machine[lane] = twin;
+            twin->lanes.push_back(lane);
+        }
+        spares.push_back(std::move(machine->emu));
+        stats.merges++;
+    }
+    machines = std::move(survivors);
+}
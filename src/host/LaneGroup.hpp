@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Emulator;
+
+/**
+ * LaneGroup - Many Copies of One ROM, Executed Once per Distinct State (experimental)
+ *
+ * For RL-style hosts running 8-64 instances ("lanes") of the same ROM.
+ * Lanes that are in exactly the same machine state share one Emulator
+ * (a "machine"), so a frame is emulated once per distinct state instead
+ * of once per lane:
+ * - All lanes start converged on one machine after Load()
+ * - Diverge: before a frame, lanes of one machine whose inputs differ are
+ *   split off onto clones of it (save state -> load state)
+ * - Reconverge: after a frame, machines whose full save state is byte-for-
+ *   byte identical are merged back into one (e.g. lanes that pressed
+ *   different buttons on a screen that ignored them)
+ *
+ * Results are exact: a lane sees precisely what its own Emulator would
+ * have produced. Throughput scales with lanes per machine, so it helps
+ * most while lanes share inputs (menus, cutscenes, synchronized resets).
+ *
+ * Lanes are read-only views; hooks, audio output and DebugWrite don't fit
+ * shared machines and aren't offered.
+ */
+class LaneGroup {
+public:
+    struct Stats {
+        uint64_t lane_frames;      // Frames delivered across all lanes
+        uint64_t machine_frames;   // Frames actually emulated
+        uint64_t splits;
+        uint64_t merges;
+    };
+
+    explicit LaneGroup(unsigned lanes);
+    ~LaneGroup();
+
+    LaneGroup(const LaneGroup&) = delete;
+    LaneGroup& operator=(const LaneGroup&) = delete;
+
+    // Load the ROM (and optional boot ROM) and reset every lane onto one machine
+    bool Load(const std::string& rom_path, const std::string& boot_rom_path = "");
+
+    // Buttons held by a lane from the next frame on (bit n = Joypad button n)
+    void SetInput(unsigned lane, uint8_t buttons);
+
+    // Advance every lane by one frame
+    void RunFrame();
+
+    // Look for identical machines every N frames (0 = never reconverge)
+    void SetMergeInterval(uint32_t frames) { merge_interval = frames; }
+
+    const Emulator& GetLane(unsigned lane) const;
+    const uint8_t* GetFramebuffer(unsigned lane) const;
+    bool SaveState(unsigned lane, std::vector<uint8_t>& out);
+
+    unsigned GetLaneCount() const { return static_cast<unsigned>(lane_machine.size()); }
+    unsigned GetMachineCount() const { return static_cast<unsigned>(machines.size()); }
+    Stats GetStats() const { return stats; }
+
+private:
+    struct Machine {
+        std::unique_ptr<Emulator> emu;
+        uint8_t input = 0;                // Buttons its lanes want next frame
+        uint8_t held = 0;                 // Buttons the Joypad holds (saved with the state)
+        std::vector<unsigned> lanes;
+        std::vector<uint8_t> state;       // Scratch for merge/clone snapshots
+    };
+
+    std::string rom_path;
+    std::string boot_rom_path;
+
+    std::vector<std::unique_ptr<Machine>> machines;
+    std::vector<std::unique_ptr<Emulator>> spares;   // Retired by merges, reused by splits
+    std::vector<Machine*> lane_machine;
+    std::vector<uint8_t> lane_input;
+
+    uint32_t merge_interval = 1;
+    uint32_t frames_since_merge = 0;
+    Stats stats = {};
+
+    std::unique_ptr<Emulator> NewEmulator();
+    void Split();
+    void Merge();
+    static void ApplyInput(Machine& machine);
+};
@@ -0,0 +1,151 @@
+#include "NodeArena.hpp"
+
+#include <iostream>
+#include <new>
+
+#include <sys/mman.h>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static thread_local NodeArena* current_arena = nullptr;
+
+NodeArena::NodeArena(int node, bool huge_pages)
+    : node(node)
+    , huge_pages(huge_pages)
+{
+}
+
+NodeArena::~NodeArena() {
+    for (const Chunk& chunk : chunks) {
+        munmap(chunk.base, chunk.size);
+    }
+}
+
+// === Allocation ===
+
+void* NodeArena::Allocate(size_t size) {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (FreeList& list : free_lists) {
+        if (list.size == size && list.head) {
+            void* ptr = list.head;
+            list.head = *static_cast<void**>(ptr);
+            return ptr;
+        }
+    }
+
+    for (Chunk& chunk : chunks) {
+        if (chunk.size - chunk.used >= size) {
+            void* ptr = chunk.base + chunk.used;
+            chunk.used += size;
+            return ptr;
+        }
+    }
+
+    Chunk chunk = MapChunk(size > CHUNK_SIZE ? size : CHUNK_SIZE);
+    if (!chunk.base) throw std::bad_alloc();
+    chunk.used = size;
+    chunks.push_back(chunk);
+    return chunk.base;
+}
+
+void NodeArena::Release(void* ptr, size_t size) {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (FreeList& list : free_lists) {
+        if (list.size == size) {
+            *static_cast<void**>(ptr) = list.head;
+            list.head = ptr;
+            return;
+        }
+    }
+    *static_cast<void**>(ptr) = nullptr;
+    free_lists.push_back({ size, ptr });
+}
+
+size_t NodeArena::GetReservedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t total = 0;
+    for (const Chunk& chunk : chunks) total += chunk.size;
+    return total;
+}
+
+NodeArena::Chunk NodeArena::MapChunk(size_t size) {
+    size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+
+    // Over-map by one huge page and trim, so the chunk starts 2MB aligned
+    size_t mapped = size + HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        std::cerr << "NodeArena: mmap of " << mapped << " bytes failed\n";
+        return { nullptr, 0, 0 };
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    if (aligned > start) munmap(raw, aligned - start);
+    size_t tail = (start + mapped) - (aligned + size);
+    if (tail) munmap(reinterpret_cast<void*>(aligned + size), tail);
+    uint8_t* base = reinterpret_cast<uint8_t*>(aligned);
+
+#ifdef __linux__
+    if (huge_pages) {
+        madvise(base, size, MADV_HUGEPAGE);
+    }
+    // Preferred rather than bound: a full node falls back instead of failing.
+    // Errors (no NUMA support, node >= 64) just leave the default policy.
+    if (node >= 0 && node < 64) {
+        unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, base, size, MPOL_PREFERRED, &mask, sizeof(mask) * 8, 0);
+    }
+#endif
+
+    return { base, size, 0 };
+}
+
+// === Scope ===
+
+NodeArena::Scope::Scope(NodeArena* arena)
+    : previous(current_arena)
+{
+    current_arena = arena;
+}
+
+NodeArena::Scope::~Scope() {
+    current_arena = previous;
+}
+
+NodeArena* NodeArena::Current() {
+    return current_arena;
+}
+
+// === ArenaAllocated ===
+// The header keeps the object 16-byte aligned (arena blocks are 64-aligned)
+// and remembers the block size for the arena's free lists
+
+struct alignas(16) ArenaBlockHeader {
+    NodeArena* arena;
+    size_t size;
+};
+
+void* ArenaAllocated::operator new(std::size_t size) {
+    NodeArena* arena = current_arena;
+    size_t total = size + sizeof(ArenaBlockHeader);
+    void* block = arena ? arena->Allocate(total) : ::operator new(total);
+    ArenaBlockHeader* header = static_cast<ArenaBlockHeader*>(block);
+    header->arena = arena;
+    header->size = total;
+    return header + 1;
+}
+
+void ArenaAllocated::operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    ArenaBlockHeader* header = static_cast<ArenaBlockHeader*>(ptr) - 1;
+    if (header->arena) header->arena->Release(header, header->size);
+    else ::operator delete(header);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "ArenaAllocated.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * NodeArena - Per-NUMA-Node Memory for Emulator Instances
+ *
+ * Hands out instance state from large chunks that are:
+ * - Aligned to 2MB and advised for transparent huge pages, so thousands of
+ *   ~40KB instances don't each cost their own TLB entries
+ * - Bound (preferred) to one NUMA node via mbind, next to the worker
+ *   threads pinned on that node
+ *
+ * Allocation is a bump pointer per chunk. Released blocks go on a free
+ * list for their (aligned) size and are handed out again first: every
+ * instance is made of the same handful of component sizes, so a replaced
+ * instance refills exactly the blocks its predecessor left. The list is
+ * threaded through the free blocks themselves, so it never allocates.
+ *
+ * Only the components deriving from ArenaAllocated land here. Cartridge RAM
+ * comes from the heap, first touched on the pinned worker that builds the
+ * instance, which keeps it local too. ROM images are shared by all
+ * instances of a file (see Cartridge::LoadROM).
+ */
+class NodeArena {
+public:
+    explicit NodeArena(int node, bool huge_pages = true);
+    ~NodeArena();
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    void* Allocate(size_t size);
+    void Release(void* ptr, size_t size);   // `size` as passed to Allocate
+
+    int GetNode() const { return node; }
+    size_t GetReservedBytes() const;
+
+    // Routes ArenaAllocated objects created on this thread into `arena`
+    // for the lifetime of the scope (nullptr = ordinary heap)
+    class Scope {
+    public:
+        explicit Scope(NodeArena* arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        NodeArena* previous;
+    };
+
+    static NodeArena* Current();
+
+private:
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    static constexpr size_t CHUNK_SIZE = HUGE_PAGE_SIZE;
+    static constexpr size_t ALIGNMENT = 64;   // Cache line
+
+    struct Chunk {
+        uint8_t* base;
+        size_t size;
+        size_t used;
+    };
+
+    // Released blocks of one aligned size; each starts with the next pointer
+    struct FreeList {
+        size_t size;
+        void* head;
+    };
+
+    int node;
+    bool huge_pages;
+    mutable std::mutex mutex;
+    std::vector<Chunk> chunks;
+    std::vector<FreeList> free_lists;   // A few entries: one per component size
+
+    Chunk MapChunk(size_t size);
+};
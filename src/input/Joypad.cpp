@@ -1,4 +1,5 @@
 #include "Joypad.hpp"
+#include "../state/StateBuffer.hpp"
 
 Joypad::Joypad() {
     Reset();
@@ -80,3 +81,18 @@ void Joypad::SetButton(uint8_t button, bool pressed) {
         interrupt_requested = true;
     }
 }
+
+// === Save State ===
+
+template <typename Self, typename Archive>
+void Joypad::Serialize(Self& self, Archive& archive) {
+    archive(self.select, self.buttons, self.interrupt_requested);
+}
+
+void Joypad::SaveState(StateWriter& state) const {
+    Serialize(*this, state);
+}
+
+void Joypad::LoadState(StateReader& state) {
+    Serialize(*this, state);
+}
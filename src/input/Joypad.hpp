@@ -1,6 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
 
 /**
  * Joypad - Button Input Hardware
@@ -16,7 +20,7 @@
  * - Button state input from frontend
  * - Interrupt output signal
  */
-class Joypad {
+class Joypad : public ArenaAllocated {
 public:
     Joypad();
     
@@ -44,6 +48,10 @@ public:
     bool IsInterruptRequested() const { return interrupt_requested; }
     void ClearInterrupt() { interrupt_requested = false; }
     
+    // === Save State (see StateBuffer.hpp) ===
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+    
 private:
     // === Internal State (directly exposed internal flip-flops) ===
     uint8_t select;             // P14/P15 select lines (bits 4-5 of $FF00)
@@ -57,4 +65,7 @@ private:
     
     // Helper to calculate P10-P13 state based on current select and buttons
     uint8_t GetP10_P13_State() const;
+    
+    template <typename Self, typename Archive>
+    static void Serialize(Self& self, Archive& archive);
 };
@@ -1,15 +1,30 @@
 #include <iostream>
 #include <fstream>
+#include <cstdio>
 #include <string>
 #include <chrono>
-#include <thread>
 #include <iomanip>
 #include <filesystem>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 #include "Emulator.hpp"
 #include "frontend/Window.hpp"
+#include "frontend/FramePacer.hpp"
 #include "cartridge/Cartridge.hpp"
 #include "apu/AudioBuffer.hpp"
+#include "export/SharedMemoryExport.hpp"
+#include "automation/AutomationServer.hpp"
+#include "state/Timeline.hpp"
+#include "debug/LockstepValidator.hpp"
+#include "debug/HangWatchdog.hpp"
+#include "debug/TestResultMonitor.hpp"
+#include "util/Hash.hpp"
+
+#ifdef GB_HAVE_LUA
+#include "script/LuaScript.hpp"
+#endif
 
 void PrintUsage(const char* program) {
     std::cout << "Usage: " << program << " [options] [rom_file]\n"
@@ -19,10 +34,30 @@ void PrintUsage(const char* program) {
               << "  --cycles <n>        Run for N cycles then exit\n"
               << "  --dump-screen <f>   Dump screen to PGM file on exit\n"
               << "  --scale <n>         Window scale (1-8, default: 4)\n"
+              << "  --when-hidden <m>   pause, throttle or run while minimized (default: pause)\n"
+              << "  --audio <backend>   sdl, alsa, null or file:<path.wav> (default: sdl)\n"
+              << "  --export-shm <name> Publish frames/audio to /dev/shm/<name>\n"
+              << "  --automation <path> Accept automation clients on a Unix socket (headless: run only for them)\n"
+              << "  --timeline <file>   Record the session, seekable with PgUp/PgDn/Home/End (replays an existing file)\n"
+              << "  --script <file.lua> Run a Lua script with emulator hooks\n"
+              << "  --lockstep <variant> Compare against a second instance (step, worker, state)\n"
+              << "  --lockstep-instructions  Compare after every instruction, not every frame\n"
+              << "  --footprint         Print per-instance memory use on exit (headless)\n"
+              << "  --no-watchdog       Keep running headless ROMs that have hung\n"
+              << "  --stall-frames <n>  Frames without progress before a stall counts as a hang (default: 120)\n"
+              << "  --pass-hash <hex>   Screen hash that means the test passed (repeatable)\n"
+              << "  --fail-hash <hex>   Screen hash that means the test failed (repeatable)\n"
               << "  --help              Show this help\n"
               << "\nIf no ROM file is specified, a file dialog will open.\n";
 }
 
+// What the GUI does while its window is minimized or hidden
+enum class HiddenMode {
+    PAUSE,      // Stop emulating; sleep in the event loop
+    THROTTLE,   // Keep realtime, skip rendering, wake once per 4 frames
+    RUN,        // As if visible
+};
+
 struct Args {
     std::string rom_path;
     std::string boot_rom_path;
@@ -30,6 +65,19 @@ struct Args {
     bool headless = false;
     uint64_t max_cycles = 0;
     int scale = 4;
+    HiddenMode hidden_mode = HiddenMode::PAUSE;
+    std::string audio_backend = "sdl";
+    std::string export_shm;
+    std::string automation_socket;
+    std::string timeline_path;
+    std::string script_path;
+    std::string lockstep;
+    bool lockstep_instructions = false;
+    bool footprint = false;
+    bool watchdog = true;
+    uint32_t stall_frames = 120;
+    std::vector<uint64_t> pass_hashes;
+    std::vector<uint64_t> fail_hashes;
 };
 
 bool ParseArgs(int argc, char* argv[], Args& args) {
@@ -51,6 +99,40 @@ bool ParseArgs(int argc, char* argv[], Args& args) {
             args.scale = std::stoi(argv[++i]);
             if (args.scale < 1) args.scale = 1;
             if (args.scale > 8) args.scale = 8;
+        } else if (arg == "--when-hidden" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "pause") args.hidden_mode = HiddenMode::PAUSE;
+            else if (mode == "throttle") args.hidden_mode = HiddenMode::THROTTLE;
+            else if (mode == "run") args.hidden_mode = HiddenMode::RUN;
+            else {
+                std::cerr << "Unknown --when-hidden mode: " << mode << "\n";
+                return false;
+            }
+        } else if (arg == "--audio" && i + 1 < argc) {
+            args.audio_backend = argv[++i];
+        } else if (arg == "--export-shm" && i + 1 < argc) {
+            args.export_shm = argv[++i];
+        } else if (arg == "--automation" && i + 1 < argc) {
+            args.automation_socket = argv[++i];
+        } else if (arg == "--timeline" && i + 1 < argc) {
+            args.timeline_path = argv[++i];
+        } else if (arg == "--script" && i + 1 < argc) {
+            args.script_path = argv[++i];
+        } else if (arg == "--lockstep" && i + 1 < argc) {
+            args.lockstep = argv[++i];
+            args.headless = true;
+        } else if (arg == "--lockstep-instructions") {
+            args.lockstep_instructions = true;
+        } else if (arg == "--footprint") {
+            args.footprint = true;
+        } else if (arg == "--no-watchdog") {
+            args.watchdog = false;
+        } else if (arg == "--stall-frames" && i + 1 < argc) {
+            args.stall_frames = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--pass-hash" && i + 1 < argc) {
+            args.pass_hashes.push_back(std::stoull(argv[++i], nullptr, 16));
+        } else if (arg == "--fail-hash" && i + 1 < argc) {
+            args.fail_hashes.push_back(std::stoull(argv[++i], nullptr, 16));
         } else if (arg[0] != '-') {
             args.rom_path = arg;
         } else {
@@ -92,57 +174,95 @@ std::string GetTestName(const std::string& rom_path) {
     return p.stem().string();
 }
 
-int RunHeadless(Emulator& emu, uint64_t max_cycles, const std::string& rom_path, const std::string& dump_path = "") {
-    std::string serial_output;
-    uint64_t cycles = 0;
-    uint64_t target = max_cycles > 0 ? max_cycles : 30000000;
+// Per-component memory use against the lean headless budget
+void PrintFootprint(const Emulator& emu) {
+    size_t budgeted = 0;
+    size_t storage = 0;
+    std::cout << "\n=== Instance Footprint ===\n";
+    for (const Emulator::FootprintEntry& entry : emu.GetFootprint()) {
+        std::cout << "  " << std::left << std::setw(14) << entry.name << std::right
+                  << std::setw(9) << entry.bytes << " B" << (entry.shared ? "  (shared)" : "") << "\n";
+        if (entry.shared) continue;
+        if (std::string(entry.name) == "cartridge ram") storage += entry.bytes;
+        else budgeted += entry.bytes;
+    }
+    std::cout << "  Instance: " << budgeted << " B of " << Emulator::FOOTPRINT_BUDGET << " B budget"
+              << (budgeted > Emulator::FOOTPRINT_BUDGET ? " (OVER)" : "")
+              << ", plus " << storage << " B cartridge RAM\n";
+}
+
+// Publish the finished frame plus the audio emulated during it, then pass
+// the audio on to the sink's buffer (if playing), so the export never
+// depends on mute, focus or time stretching
+void ExportFrame(Emulator& emu, SharedMemoryExport& exporter, AudioBuffer& audio,
+                 AudioBuffer* playback = nullptr) {
+    exporter.PublishFrame(emu.GetFramebuffer(), emu.GetTotalCycles());
     
-    // Mooneye test result (set by callback)
-    int mooneye_result = -1;  // -1 = not done, 0 = pass, 1 = fail
+    emu.SyncAudio();
+    float block[SharedFrameLayout::AUDIO_BLOCK_SAMPLES * 2];
+    while (size_t count = audio.Read(block, SharedFrameLayout::AUDIO_BLOCK_SAMPLES)) {
+        exporter.PublishAudio(block, count);
+        if (!playback) continue;
+        for (size_t i = 0; i < count; i++) {
+            playback->Push(block[i * 2], block[i * 2 + 1]);
+        }
+    }
+}
+
+int RunHeadless(Emulator& emu, const Args& args, SharedMemoryExport* exporter = nullptr,
+                AudioBuffer* export_audio = nullptr) {
+    constexpr uint32_t FRAME_CYCLES = 70224;
+    uint64_t target = args.max_cycles > 0 ? args.max_cycles : 30000000;
+    
+    // Results are checked at frame boundaries (Mooneye and serial as they happen)
+    TestResultMonitor monitor(emu, &std::cout);
+    for (uint64_t hash : args.pass_hashes) monitor.AddScreenHash(hash, true);
+    for (uint64_t hash : args.fail_hashes) monitor.AddScreenHash(hash, false);
     
-    // Set up Mooneye detection callback
-    emu.SetMooneyeCallback([&mooneye_result](bool passed) {
-        mooneye_result = passed ? 0 : 1;
-    });
+    std::unique_ptr<HangWatchdog> watchdog;
+    if (args.watchdog) watchdog = std::make_unique<HangWatchdog>(args.stall_frames);
     
+    // Counted per step: the monitor may Reset() the emulator (Blargg $81)
+    uint64_t cycles = 0;
     auto start = std::chrono::high_resolution_clock::now();
     
-    while (cycles < target && mooneye_result < 0) {
-        cycles += emu.Step();
+    while (cycles < target && !monitor.HasResult()) {
+        uint64_t before = emu.GetTotalCycles();
+        if (target - cycles < FRAME_CYCLES) {
+            emu.StepCycles(static_cast<uint32_t>(target - cycles));
+        } else {
+            emu.RunFrame();
+        }
+        cycles += emu.GetTotalCycles() - before;
         
-        // Blargg-style serial detection
-        if (emu.IsSerialTransferComplete()) {
-            char c = static_cast<char>(emu.GetSerialData());
-            serial_output += c;
-            emu.ClearSerialTransferComplete();
-            std::cout << c << std::flush;
-            
-            if (serial_output.find("Passed") != std::string::npos ||
-                serial_output.find("passed") != std::string::npos) {
-                std::cout << "\n\n=== TEST PASSED (Blargg) ===\n";
-                return 0;
-            }
-            if (serial_output.find("Failed") != std::string::npos ||
-                serial_output.find("failed") != std::string::npos) {
-                std::cout << "\n\n=== TEST FAILED (Blargg) ===\n";
-                return 1;
-            }
+        if (exporter && emu.IsFrameComplete()) {
+            emu.ClearFrameComplete();
+            ExportFrame(emu, *exporter, *export_audio);
+        }
+        
+        if (monitor.Check()) break;
+        
+        // A hung ROM will never report; stop instead of running out the budget
+        if (watchdog && watchdog->Poll(emu) != HangWatchdog::Reason::NONE) {
+            std::cout << "\n\n=== HANG DETECTED ===\n";
+            watchdog->Report(emu, std::cout);
+            break;
         }
     }
     
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
     
-    // Mooneye result check
-    if (mooneye_result == 0) {
-        std::cout << "\n\n=== TEST PASSED (Mooneye) ===\n";
-        if (!dump_path.empty()) DumpScreen(emu, dump_path);
-        return 0;
-    } else if (mooneye_result == 1) {
-        std::cout << "\n\n=== TEST FAILED (Mooneye) ===\n";
-        DumpScreen(emu, "test_dumps/" + GetTestName(rom_path) + ".pgm");  // Dump to test_dumps with test name
-        if (!dump_path.empty()) DumpScreen(emu, dump_path);
-        return 1;
+    if (monitor.HasResult()) {
+        const TestResultMonitor::Result& result = monitor.GetResult();
+        bool passed = result.verdict == TestResultMonitor::Verdict::PASSED;
+        std::cout << "\n\n=== TEST " << (passed ? "PASSED" : "FAILED") << " (" << result.source << ") ===\n";
+        if (!result.detail.empty()) std::cout << result.detail << "\n";
+        if (!passed) {
+            DumpScreen(emu, "test_dumps/" + GetTestName(args.rom_path) + ".pgm");  // Dump to test_dumps with test name
+        }
+        if (!args.dump_screen_path.empty()) DumpScreen(emu, args.dump_screen_path);
+        return passed ? 0 : 1;
     }
     
     std::cout << "\n\nExecuted " << cycles << " cycles in " << duration.count() << "ms\n";
@@ -152,64 +272,181 @@ int RunHeadless(Emulator& emu, uint64_t max_cycles, const std::string& rom_path,
     std::cout << "\nCPU State: PC=$" << std::hex << emu.GetPC() 
               << " SP=$" << emu.GetSP()
               << " AF=$" << emu.GetAF() << std::dec << "\n";
+    std::cout << "Screen hash: " << std::hex << std::setw(16) << std::setfill('0')
+              << HashFramebuffer(emu.GetFramebuffer())
+              << std::dec << std::setfill(' ') << " (for --pass-hash/--fail-hash)\n";
     
-    if (!serial_output.empty()) {
-        std::cout << "\nSerial output: " << serial_output << "\n";
+    if (!monitor.GetSerialOutput().empty()) {
+        std::cout << "\nSerial output: " << monitor.GetSerialOutput() << "\n";
     } else {
         std::cout << "\nNo serial output received.\n";
     }
     return 0;
 }
 
-int RunGUI(Emulator& emu, Window& window, const std::string& rom_info, const std::string& save_path) {
+// Headless instance that only runs frames for automation clients, until
+// one of them sends QUIT
+int RunAutomation(Emulator& emu, AutomationServer& automation, SharedMemoryExport* exporter = nullptr,
+                  AudioBuffer* export_audio = nullptr) {
+    if (exporter) {
+        automation.SetFrameCallback([&emu, exporter, export_audio] {
+            emu.ClearFrameComplete();
+            ExportFrame(emu, *exporter, *export_audio);
+        });
+    }
+    
+    while (!automation.QuitRequested()) {
+        automation.Poll(emu, -1);
+    }
+    
+    std::cout << "Automation quit after " << emu.GetFrameCount() << " frames\n";
+    return 0;
+}
+
+// Differential run: exit code 1 on the first divergence
+int RunLockstep(const Args& args) {
+    LockstepValidator::Variant variant;
+    if (!LockstepValidator::ParseVariant(args.lockstep, variant)) {
+        return 1;
+    }
+    
+    LockstepValidator validator(variant);
+    if (!validator.Load(args.rom_path, args.boot_rom_path)) {
+        return 1;
+    }
+    
+    std::cout << "Lockstep validation (" << args.lockstep << ", per "
+              << (args.lockstep_instructions ? "instruction" : "frame") << ")\n";
+    return validator.Run(args.max_cycles, args.lockstep_instructions) ? 0 : 1;
+}
+
+int RunGUI(Emulator& emu, Window& window, const std::string& rom_info, const std::string& save_path,
+           const std::string& audio_backend, HiddenMode hidden_mode, SharedMemoryExport* exporter = nullptr,
+           AutomationServer* automation = nullptr, Timeline* timeline = nullptr) {
     window.DisplayROMInfo(rom_info);
     
-    // Initialize audio
+    // Initialize audio. Exporting, the APU fills export_audio and each
+    // frame's samples are published before they are forwarded to the sink
     AudioBuffer audio_buffer;
-    if (window.InitAudio(&audio_buffer)) {
-        emu.ConnectAudioBuffer(&audio_buffer);
+    AudioBuffer export_audio;
+    bool audio_connected = window.InitAudio(&audio_buffer, audio_backend);
+    AudioBuffer* playback = audio_connected ? &audio_buffer : nullptr;
+    AudioBuffer* apu_audio = exporter ? &export_audio : playback;
+    if (apu_audio) {
+        emu.ConnectAudioBuffer(apu_audio);
     }
     
     std::cout << "\n=== Starting Emulation ===\n";
     std::cout << "Controls: Arrows = D-Pad, Z = A, X = B, RShift = Select, Enter = Start\n";
+    if (timeline) std::cout << "Timeline: PgUp/PgDn = -/+10 s, Home/End = start/end\n";
     std::cout << "Press ESC to quit\n\n";
     
-    // FPS tracking
-    int frame_count = 0;
-    int fps_frame_count = 0;
-    auto fps_start = std::chrono::high_resolution_clock::now();
-    
     // Frame timing for 59.7275 Hz (DMG refresh rate)
     // 70224 T-cycles per frame at 4.194304 MHz = 16.742706... ms per frame
     constexpr auto FRAME_DURATION = std::chrono::nanoseconds(16742706);
+    constexpr int THROTTLE_BATCH = 4;
+    FramePacer pacer(FRAME_DURATION);
+    FramePacer::Load load;
+    int frame_count = 0;
     auto frame_start = std::chrono::high_resolution_clock::now();
+    double audio_speed = 1.0;
+    uint8_t buttons = 0;   // Bit n = Emulator::SetButton n
+    char seek_text[32];
+    
+    if (automation && exporter) {
+        automation->SetFrameCallback([&emu, exporter, &export_audio, playback] {
+            ExportFrame(emu, *exporter, export_audio, playback);
+        });
+    }
     
     while (window.ProcessEvents()) {
-        emu.RunFrame();
+        // An automation client owns the clock: keep the window live and wait
+        // up to a frame for its next batch instead of running on our own
+        if (automation && automation->Poll(emu, 0)) {
+            window.RenderFrame(emu.GetFramebuffer());
+            if (!automation->QuitRequested()) automation->Poll(emu, 16);
+            if (automation->QuitRequested()) break;
+            pacer.Reset();
+            frame_start = std::chrono::high_resolution_clock::now();
+            continue;
+        }
+        
+        // Minimized: block on window events instead of emulating frames
+        // nobody sees (audio is already muted without focus)
+        bool hidden = window.IsHidden() && hidden_mode != HiddenMode::RUN;
+        if (hidden && hidden_mode == HiddenMode::PAUSE) {
+            SDL_WaitEventTimeout(nullptr, 100);
+            pacer.Reset();
+            frame_start = std::chrono::high_resolution_clock::now();
+            continue;
+        }
+        
+        if (timeline) {
+            // Seeks replay silently; synthesis restarts from the new state
+            uint32_t position = timeline->GetPosition();
+            uint32_t target = position;
+            constexpr uint32_t SEEK_STEP = 600;   // 10 s
+            if (window.IsKeyJustPressed(SDL_SCANCODE_PAGEUP)) target = position - std::min(position, SEEK_STEP);
+            if (window.IsKeyJustPressed(SDL_SCANCODE_PAGEDOWN)) target = position + SEEK_STEP;
+            if (window.IsKeyJustPressed(SDL_SCANCODE_HOME)) target = 0;
+            if (window.IsKeyJustPressed(SDL_SCANCODE_END)) target = timeline->GetLength();
+            if (target != position) {
+                emu.ConnectAudioBuffer(nullptr);
+                timeline->Seek(emu, target);
+                if (apu_audio) emu.ConnectAudioBuffer(apu_audio);
+                uint32_t seconds = timeline->GetPosition() / 60;
+                uint32_t total = timeline->GetLength() / 60;
+                std::snprintf(seek_text, sizeof(seek_text), "%u:%02u OF %u:%02u",
+                              seconds / 60, seconds % 60, total / 60, total % 60);
+                window.ShowNotification(seek_text);
+                pacer.Reset();
+            }
+            
+            // Before the end, play the recording back until a button
+            // takes over (that cuts the recording there)
+            bool playback = timeline->GetPosition() < timeline->GetLength() && buttons == 0;
+            timeline->RunFrame(emu, playback ? timeline->GetInput(timeline->GetPosition()) : buttons);
+        } else {
+            emu.RunFrame();
+        }
         frame_count++;
-        fps_frame_count++;
         
-        // FPS tracking: print every second
-        auto now = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - fps_start);
-        if (elapsed.count() >= 1000) {
-            double fps = fps_frame_count * 1000.0 / elapsed.count();
-            std::cerr << "[FPS: " << std::fixed << std::setprecision(1) << fps << "] "
+        if (exporter) {
+            ExportFrame(emu, *exporter, export_audio, playback);
+        }
+        
+        // Host load: print every second
+        if (pacer.SampleLoad(load)) {
+            std::cerr << "[FPS: " << std::fixed << std::setprecision(1) << load.frames_per_second
+                      << " | CPU " << std::setprecision(2) << load.cpu_ms_per_frame << " ms/frame, "
+                      << std::setprecision(1) << load.cpu_percent << "%"
+                      << (load.late_frames ? " | late " + std::to_string(load.late_frames) : "") << "] "
                       << "PC=$" << std::hex << emu.GetPC() << std::dec << std::endl;
-            fps_frame_count = 0;
-            fps_start = now;
         }
         
-        window.RenderFrame(emu.GetFramebuffer());
+        if (!hidden) window.RenderFrame(emu.GetFramebuffer());
+        
+        // Absolute-deadline limiter for 59.7275 Hz (Tab held = fast-forward);
+        // with vsync the time blocked in RenderFrame counts toward the frame.
+        // Throttled, frames run in batches so the thread wakes less often
+        bool fast_forward = window.IsKeyPressed(SDL_SCANCODE_TAB);
+        if (fast_forward) {
+            pacer.EndUnpacedFrame();
+        } else {
+            pacer.EndFrame(!hidden || frame_count % THROTTLE_BATCH == 0);
+        }
+        auto frame_now = std::chrono::high_resolution_clock::now();
         
-        // Software frame limiter for 59.7275 Hz
-        // VSYNC may not work on all systems, so we add this fallback
-        auto frame_end = std::chrono::high_resolution_clock::now();
-        auto frame_elapsed = frame_end - frame_start;
-        if (frame_elapsed < FRAME_DURATION) {
-            std::this_thread::sleep_for(FRAME_DURATION - frame_elapsed);
+        // Tell the audio time-stretcher how fast emulated time is running,
+        // smoothed so one slow frame doesn't warble the audio (batched
+        // throttle frames would look like alternating speeds)
+        if (!hidden) {
+            double frame_speed = std::chrono::duration<double>(FRAME_DURATION).count() /
+                                 std::max(std::chrono::duration<double>(frame_now - frame_start).count(), 1e-4);
+            audio_speed += (frame_speed - audio_speed) * 0.1;
+            window.SetAudioSpeed(static_cast<float>(audio_speed));
         }
-        frame_start = std::chrono::high_resolution_clock::now();
+        frame_start = frame_now;
         
         // Serial output to console
         while (emu.IsSerialTransferComplete()) {
@@ -218,17 +455,27 @@ int RunGUI(Emulator& emu, Window& window, const std::string& rom_info, const std
             emu.ClearSerialTransferComplete();
         }
         
-        // Handle input
-        emu.SetButton(4, window.IsKeyPressed(SDL_SCANCODE_RIGHT));
-        emu.SetButton(5, window.IsKeyPressed(SDL_SCANCODE_LEFT));
-        emu.SetButton(6, window.IsKeyPressed(SDL_SCANCODE_UP));
-        emu.SetButton(7, window.IsKeyPressed(SDL_SCANCODE_DOWN));
-        emu.SetButton(0, window.IsKeyPressed(SDL_SCANCODE_Z));
-        emu.SetButton(1, window.IsKeyPressed(SDL_SCANCODE_X));
-        emu.SetButton(2, window.IsKeyPressed(SDL_SCANCODE_RSHIFT));
-        emu.SetButton(3, window.IsKeyPressed(SDL_SCANCODE_RETURN));
+        // Handle input (a timeline applies it at the next frame, so the
+        // recording holds every press)
+        buttons = static_cast<uint8_t>(window.IsKeyPressed(SDL_SCANCODE_Z) << 0 |
+                                       window.IsKeyPressed(SDL_SCANCODE_X) << 1 |
+                                       window.IsKeyPressed(SDL_SCANCODE_RSHIFT) << 2 |
+                                       window.IsKeyPressed(SDL_SCANCODE_RETURN) << 3 |
+                                       window.IsKeyPressed(SDL_SCANCODE_RIGHT) << 4 |
+                                       window.IsKeyPressed(SDL_SCANCODE_LEFT) << 5 |
+                                       window.IsKeyPressed(SDL_SCANCODE_UP) << 6 |
+                                       window.IsKeyPressed(SDL_SCANCODE_DOWN) << 7);
+        if (!timeline) {
+            for (uint8_t button = 0; button < 8; button++) {
+                emu.SetButton(button, (buttons >> button) & 1);
+            }
+        }
     }
     
+    // Stop the synthesis worker and audio sink before the buffers go out of scope
+    emu.ConnectAudioBuffer(nullptr);
+    window.CloseAudio();
+    
     // Save battery-backed RAM on exit
     if (emu.HasBattery() && !save_path.empty()) {
         if (emu.SaveRAM(save_path)) {
@@ -298,6 +545,10 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    if (!args.lockstep.empty()) {
+        return RunLockstep(args);
+    }
+    
     Cartridge cart;
     if (!cart.LoadROM(args.rom_path)) {
         std::cerr << "Failed to load ROM: " << args.rom_path << "\n";
@@ -339,9 +590,74 @@ int main(int argc, char* argv[]) {
     
     emu.Reset();
     
+    // Script hooks are registered by the script's top level, after reset
+#ifdef GB_HAVE_LUA
+    std::unique_ptr<LuaScript> script;
+    if (!args.script_path.empty()) {
+        script = std::make_unique<LuaScript>(emu);
+        if (!script->Load(args.script_path)) {
+            return 1;
+        }
+    }
+#else
+    if (!args.script_path.empty()) {
+        std::cerr << "Lua scripting not compiled in\n";
+        return 1;
+    }
+#endif
+    
+    SharedMemoryExport exporter;
+    if (!args.export_shm.empty() && !exporter.Open(args.export_shm)) {
+        return 1;
+    }
+    
+    AutomationServer automation;
+    if (!args.automation_socket.empty() && !automation.Open(args.automation_socket)) {
+        return 1;
+    }
+    
+    // Timelines record what the GUI player does; automation clients and
+    // headless runs have their own ways to save and restore
+    Timeline timeline;
+    if (!args.timeline_path.empty()) {
+        if (args.headless || automation.IsOpen()) {
+            std::cerr << "--timeline records GUI sessions (not with --headless or --automation)\n";
+            return 1;
+        }
+        if (std::filesystem::exists(args.timeline_path)) {
+            if (!timeline.Load(args.timeline_path) || !timeline.Seek(emu, 0)) {
+                return 1;
+            }
+            std::cout << "Timeline: " << args.timeline_path << " (" << timeline.GetLength()
+                      << " frames, playing back)\n";
+        } else {
+            timeline.Start(emu);
+            std::cout << "Timeline: recording to " << args.timeline_path << "\n";
+        }
+    }
+    
     if (args.headless) {
-        return RunHeadless(emu, args.max_cycles, args.rom_path, args.dump_screen_path);
+        // Exported audio comes straight from the APU, one batch per frame;
+        // without an export there is no audio ring at all
+        std::unique_ptr<AudioBuffer> export_audio;
+        if (exporter.IsOpen()) {
+            export_audio = std::make_unique<AudioBuffer>();
+            emu.ConnectAudioBuffer(export_audio.get());
+        }
+        int result = automation.IsOpen()
+            ? RunAutomation(emu, automation, exporter.IsOpen() ? &exporter : nullptr, export_audio.get())
+            : RunHeadless(emu, args, exporter.IsOpen() ? &exporter : nullptr, export_audio.get());
+        if (args.footprint) PrintFootprint(emu);
+        emu.ConnectAudioBuffer(nullptr);
+        return result;
     } else {
-        return RunGUI(emu, window, rom_info, save_path);
+        int result = RunGUI(emu, window, rom_info, save_path, args.audio_backend, args.hidden_mode,
+                            exporter.IsOpen() ? &exporter : nullptr, automation.IsOpen() ? &automation : nullptr,
+                            timeline.IsEmpty() ? nullptr : &timeline);
+        if (!timeline.IsEmpty() && timeline.Save(args.timeline_path)) {
+            std::cout << "Timeline saved: " << args.timeline_path << " (" << timeline.GetLength() << " frames, "
+                      << timeline.GetKeyframeCount() << " keyframes every " << timeline.GetSpacing() << ")\n";
+        }
+        return result;
     }
 }
@@ -1,4 +1,5 @@
 #include "BootROM.hpp"
+#include "../state/StateBuffer.hpp"
 #include <fstream>
 
 BootROM::BootROM()
@@ -31,3 +32,18 @@ uint8_t BootROM::Read(uint16_t addr) const {
     }
     return 0xFF;
 }
+
+// === Save State ===
+
+template <typename Self, typename Archive>
+void BootROM::Serialize(Self& self, Archive& archive) {
+    archive(self.enabled);
+}
+
+void BootROM::SaveState(StateWriter& state) const {
+    Serialize(*this, state);
+}
+
+void BootROM::LoadState(StateReader& state) {
+    Serialize(*this, state);
+}
@@ -3,6 +3,10 @@
 #include <cstdint>
 #include <array>
 #include <string>
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
 
 /**
  * BootROM - DMG Boot ROM (256 bytes)
@@ -17,7 +21,7 @@
  * - Address input ($00-$FF)
  * - Data output
  */
-class BootROM {
+class BootROM : public ArenaAllocated {
 public:
     BootROM();
     
@@ -34,10 +38,17 @@ public:
     // Check if boot ROM is loaded
     bool IsLoaded() const { return loaded; }
     
+    // === Save State (see StateBuffer.hpp) ===
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+    
 private:
     // === ROM Storage (directly exposed internal storage) ===
     std::array<uint8_t, 256> rom;
     
     bool enabled;   // Mapped to address space
     bool loaded;    // ROM file was loaded successfully
+    
+    template <typename Self, typename Archive>
+    static void Serialize(Self& self, Archive& archive);
 };
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <array>
 #include <functional>
+#include "../host/ArenaAllocated.hpp"
 
 /**
  * Bus - Memory Bus / Address Decoder
@@ -21,7 +22,7 @@
  * - Read/Write control signals
  * - Callbacks to individual components
  */
-class Bus {
+class Bus : public ArenaAllocated {
 public:
     // Read/Write callback types - each "chip" provides these
     using ReadCallback = std::function<uint8_t(uint16_t addr)>;
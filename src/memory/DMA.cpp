@@ -1,4 +1,5 @@
 #include "DMA.hpp"
+#include "../state/StateBuffer.hpp"
 
 // Hardware-accurate DMA implementation per SameBoy memory.c:
 //
@@ -128,3 +129,19 @@ bool DMA::IsBlockingOAM() const {
     return warm_up_cycles == 0;
 }
 
+// === Save State ===
+
+template <typename Self, typename Archive>
+void DMA::Serialize(Self& self, Archive& archive) {
+    archive(self.source_page, self.byte_index, self.active, self.warm_up_cycles);
+    archive(self.in_winding_down, self.is_restarting);
+    archive(self.cycle_counter, self.transfer_data, self.total_cycles_tracked);
+}
+
+void DMA::SaveState(StateWriter& state) const {
+    Serialize(*this, state);
+}
+
+void DMA::LoadState(StateReader& state) {
+    Serialize(*this, state);
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
 
 /**
  * DMA - OAM DMA Transfer Controller
@@ -17,7 +21,7 @@
  * - OAM write access (destination)
  * - Active signal (blocks other OAM access)
  */
-class DMA {
+class DMA : public ArenaAllocated {
 public:
     DMA();
     
@@ -57,6 +61,10 @@ public:
     // Advance to next byte after transfer
     void AcknowledgeTransfer();
     
+    // === Save State (see StateBuffer.hpp) ===
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+    
 private:
     // === Internal State (directly exposed internal flip-flops) ===
     uint8_t source_page;        // High byte of source address (written to $FF46)
@@ -75,4 +83,7 @@ private:
     // === Constants (directly expose the DMA timing) ===
     static constexpr uint8_t BYTES_TO_TRANSFER = 160;
     static constexpr uint8_t CYCLES_PER_BYTE = 4;  // 4 T-cycles per byte
+    
+    template <typename Self, typename Archive>
+    static void Serialize(Self& self, Archive& archive);
 };
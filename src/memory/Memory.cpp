@@ -1,4 +1,5 @@
 #include "Memory.hpp"
+#include "../state/StateBuffer.hpp"
 
 Memory::Memory() {
     Reset();
@@ -24,3 +25,18 @@ uint8_t Memory::ReadHRAM(uint16_t addr) const {
 void Memory::WriteHRAM(uint16_t addr, uint8_t value) {
     hram[addr - 0xFF80] = value;
 }
+
+// === Save State ===
+
+template <typename Self, typename Archive>
+void Memory::Serialize(Self& self, Archive& archive) {
+    archive(self.wram, self.hram);
+}
+
+void Memory::SaveState(StateWriter& state) const {
+    Serialize(*this, state);
+}
+
+void Memory::LoadState(StateReader& state) {
+    Serialize(*this, state);
+}
@@ -2,6 +2,10 @@
 
 #include <cstdint>
 #include <array>
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
 
 /**
  * Memory - RAM Regions (WRAM, HRAM)
@@ -16,7 +20,7 @@
  * - Data input/output
  * - Read/Write control
  */
-class Memory {
+class Memory : public ArenaAllocated {
 public:
     Memory();
     
@@ -30,8 +34,15 @@ public:
     uint8_t ReadHRAM(uint16_t addr) const;
     void WriteHRAM(uint16_t addr, uint8_t value);
     
+    // === Save State (see StateBuffer.hpp) ===
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+    
 private:
     // === RAM Storage (directly exposed internal storage) ===
     std::array<uint8_t, 8192> wram;     // 8KB Work RAM
     std::array<uint8_t, 127> hram;      // 127 bytes High RAM
+    
+    template <typename Self, typename Archive>
+    static void Serialize(Self& self, Archive& archive);
 };
@@ -1,6 +1,22 @@
 #include "PPU.hpp"
+#include "../state/StateBuffer.hpp"
 #include <cstdio>
 
+// Bit-reversal table for sprite X-flip (row bit 0 becomes the leftmost pixel)
+static constexpr std::array<uint8_t, 256> MakeReverseBitsTable() {
+    std::array<uint8_t, 256> table{};
+    for (int i = 0; i < 256; i++) {
+        uint8_t r = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            if (i & (1 << bit)) r |= 0x80 >> bit;
+        }
+        table[i] = r;
+    }
+    return table;
+}
+
+static constexpr std::array<uint8_t, 256> REVERSE_BITS = MakeReverseBitsTable();
+
 PPU::PPU() {
     Reset();
 }
@@ -44,11 +60,13 @@ void PPU::Reset(bool bootRomEnabled) {
     vram.fill(0);
     oam.fill(0);
     framebuffer.fill(0);
+    if (tile_maps) tile_maps->InvalidateAll();
     
     // Interrupts
     vblank_irq = false;
     stat_irq = false;
     frame_complete = false;
+    frame_count = 0;
     stat_line = false;
     mode_for_interrupt = 2;  // Start in Mode 2
     
@@ -317,7 +335,8 @@ void PPU::StepPixelTransfer() {
             fetcher_window = true;
             window_active = true;
             // Per SameBoy line 1915: only clear BG FIFO, NOT sprite FIFO
-            bg_fifo_head = bg_fifo_size = 0;
+            bg_fifo_low = bg_fifo_high = 0;
+            bg_fifo_size = 0;
             fetcher_step = FetcherStep::GET_TILE;
             fetcher_dots = 0;
             fetcher_x = 0;
@@ -464,6 +483,7 @@ void PPU::StepHBlank() {
             mode_for_interrupt = 1;  // Per SameBoy: Mode 1 interrupt check
             vblank_irq = true;
             frame_complete = true;
+            frame_count++;
             // OAM/VRAM accessible during VBlank
             oam_read_blocked = false;
             oam_write_blocked = false;
@@ -531,9 +551,7 @@ void PPU::InitFetcher() {
     // Per SameBoy display.c line 1851: Pre-fill FIFO with 8 "junk" pixels
     // These will be discarded, but allow rendering to start immediately
     // This enables pixel pop/render to run in parallel with the first tile fetch
-    for (int i = 0; i < 8; i++) {
-        bg_fifo[bg_fifo_size++] = {0, 0, false, 0};  // Junk pixel
-    }
+    bg_fifo_size = 8;  // Junk pixels are color 0 (planes already cleared)
     
     fetcher_step = FetcherStep::GET_TILE;
     fetcher_dots = 0;
@@ -618,10 +636,12 @@ uint8_t PPU::FetchTileDataHigh() {
 }
 
 void PPU::PushRowToFIFO() {
-    for (int bit = 7; bit >= 0; bit--) {
-        uint8_t color = ((fetcher_tile_high >> bit) & 1) << 1 | ((fetcher_tile_low >> bit) & 1);
-        PushBGPixel(color);
-    }
+    // Only called with bg_fifo_size <= 8: the 8 new pixels land directly
+    // behind the current tail, leftmost pixel (bit 7) first
+    uint8_t shift = 8 - bg_fifo_size;
+    bg_fifo_low |= static_cast<uint16_t>(fetcher_tile_low) << shift;
+    bg_fifo_high |= static_cast<uint16_t>(fetcher_tile_high) << shift;
+    bg_fifo_size += 8;
 }
 
 void PPU::FetchSprite() {
@@ -640,68 +660,59 @@ void PPU::FetchSprite() {
     uint8_t lo = vram[tile * 16 + line * 2];
     uint8_t hi = vram[tile * 16 + line * 2 + 1];
     
+    // X-flip: reversing the row puts tile bit 0 at the head of the FIFO
+    if (spr.flags & 0x20) {
+        lo = REVERSE_BITS[lo];
+        hi = REVERSE_BITS[hi];
+    }
+    
     // Per SameBoy display.c lines 127-130: ensure FIFO has 8 transparent slots
-    while (sprite_fifo_size < 8) {
-        PushSpritePixel(0, 0, 0, 0);  // Push transparent pixel
+    // Empty slots are already zero, so padding only extends the size
+    if (sprite_fifo_size < 8) {
+        sprite_fifo_size = 8;
     }
     
     // Per SameBoy lines 132-145: overlay sprite pixels
-    // flip_xor: when X-flip is set, XOR position with 7 to reverse order
-    uint8_t flip_xor = (spr.flags & 0x20) ? 0 : 7;
-    
-    for (int i = 7; i >= 0; i--) {
-        // Always read MSB (bit 7), shift after each read (like SameBoy)
-        uint8_t color = ((hi >> 7) & 1) << 1 | ((lo >> 7) & 1);
-        lo <<= 1;
-        hi <<= 1;
-        
-        // Target position: XOR with flip_xor for X-flip
-        uint8_t pos = i ^ flip_xor;
-        FIFOPixel* target = &sprite_fifo[(sprite_fifo_head + pos) & 0xF];
-        
-        // Only overlay if pixel is non-transparent AND target is transparent
-        // Per SameBoy line 137: for DMG, all sprites have priority=0, so only
-        // transparent pixels can be overwritten.
-        // This gives X-coordinate priority: sprites processed first (lower X) keep their pixels.
-        if (color != 0 && target->color == 0) {
-            target->color = color;
-            target->palette = (spr.flags >> 4) & 1;
-            target->bg_priority = (spr.flags >> 7) & 1;
-            target->oam_index = spr.oam_index;
-        }
-    }
+    // Only overlay if pixel is non-transparent AND target is transparent
+    // Per SameBoy line 137: for DMG, all sprites have priority=0, so only
+    // transparent pixels can be overwritten.
+    // This gives X-coordinate priority: sprites processed first (lower X) keep their pixels.
+    uint16_t row_low = static_cast<uint16_t>(lo) << 8;
+    uint16_t row_high = static_cast<uint16_t>(hi) << 8;
+    uint16_t mask = (row_low | row_high) & ~(sprite_fifo_low | sprite_fifo_high);
+    
+    sprite_fifo_low |= row_low & mask;
+    sprite_fifo_high |= row_high & mask;
+    sprite_fifo_palette = (sprite_fifo_palette & ~mask) | ((spr.flags & 0x10) ? mask : 0);
+    sprite_fifo_priority = (sprite_fifo_priority & ~mask) | ((spr.flags & 0x80) ? mask : 0);
 }
 
 // === FIFO Operations ===
 void PPU::ClearFIFOs() {
-    bg_fifo_head = bg_fifo_size = 0;
-    sprite_fifo_head = sprite_fifo_size = 0;
+    bg_fifo_low = bg_fifo_high = 0;
+    bg_fifo_size = 0;
+    sprite_fifo_low = sprite_fifo_high = 0;
+    sprite_fifo_palette = sprite_fifo_priority = 0;
+    sprite_fifo_size = 0;
 }
 
-void PPU::PushBGPixel(uint8_t color) {
-    if (bg_fifo_size < 16) {
-        bg_fifo[(bg_fifo_head + bg_fifo_size) & 0xF] = {color, 0, 0, 0};
-        bg_fifo_size++;
-    }
-}
-
-PPU::FIFOPixel PPU::PopBGPixel() {
-    FIFOPixel p = bg_fifo[bg_fifo_head];
-    bg_fifo_head = (bg_fifo_head + 1) & 0xF;
+uint8_t PPU::PopBGPixel() {
+    uint8_t color = ((bg_fifo_high >> 14) & 2) | (bg_fifo_low >> 15);
+    bg_fifo_low <<= 1;
+    bg_fifo_high <<= 1;
     bg_fifo_size--;
-    return p;
-}
-
-void PPU::PushSpritePixel(uint8_t color, uint8_t pal, bool bgpri, uint8_t idx) {
-    if (sprite_fifo_size < 16) {
-        sprite_fifo[(sprite_fifo_head + sprite_fifo_size) & 0xF] = {color, pal, bgpri ? (uint8_t)1 : (uint8_t)0, idx};
-        sprite_fifo_size++;
-    }
+    return color;
 }
 
 PPU::FIFOPixel PPU::PopSpritePixel() {
-    FIFOPixel p = sprite_fifo[sprite_fifo_head];
-    sprite_fifo_head = (sprite_fifo_head + 1) & 0xF;
+    FIFOPixel p;
+    p.color = ((sprite_fifo_high >> 14) & 2) | (sprite_fifo_low >> 15);
+    p.palette = sprite_fifo_palette >> 15;
+    p.bg_priority = sprite_fifo_priority >> 15;
+    sprite_fifo_low <<= 1;
+    sprite_fifo_high <<= 1;
+    sprite_fifo_palette <<= 1;
+    sprite_fifo_priority <<= 1;
     sprite_fifo_size--;
     return p;
 }
@@ -710,17 +721,17 @@ bool PPU::RenderPixel() {
     // Window trigger is now checked in StepPixelTransfer using position_in_line
     // This function just renders the pixel
     
-    FIFOPixel bg = PopBGPixel();
-    FIFOPixel obj = {0, 0, 0, 0};
+    uint8_t bg_color = PopBGPixel();
+    FIFOPixel obj = {0, 0, 0};
     if (sprite_fifo_size > 0) obj = PopSpritePixel();
     
     uint8_t color;
-    if (obj.color != 0 && IsSpritesEnabled() && (!obj.bg_priority || bg.color == 0)) {
+    if (obj.color != 0 && IsSpritesEnabled() && (!obj.bg_priority || bg_color == 0)) {
         color = ((obj.palette ? obp1 : obp0) >> (obj.color * 2)) & 3;
     } else {
         // Per SameBoy display.c line 1243:
         // When BG disabled on DMG, use color 0 from BGP palette, not raw 0
-        color = IsBGEnabled() ? ((bgp >> (bg.color * 2)) & 3) : (bgp & 3);
+        color = IsBGEnabled() ? ((bgp >> (bg_color * 2)) & 3) : (bgp & 3);
     }
     
     if (lcd_x < 160 && ly < 144) {
@@ -913,15 +924,13 @@ uint8_t PPU::ReadVRAM(uint16_t addr) const {
 
 void PPU::WriteVRAM(uint16_t addr, uint8_t value) {
     // Per SameBoy: VRAM writable when LCD is OFF or when not blocked
-    if (!IsLCDEnabled()) {
-        vram[addr - 0x8000] = value;  // LCD off - always accessible
+    // (vram_write_blocked is set at specific T-cycle timings during Mode 3)
+    if (IsLCDEnabled() && vram_write_blocked) {
         return;
     }
     
-    // Per SameBoy: check vram_write_blocked flag
-    if (!vram_write_blocked) {
-        vram[addr - 0x8000] = value;
-    }
+    if (tile_maps) tile_maps->Invalidate(addr - 0x8000);
+    vram[addr - 0x8000] = value;
 }
 
 uint8_t PPU::ReadOAM(uint16_t addr) const {
@@ -956,3 +965,49 @@ void PPU::WriteOAM(uint16_t addr, uint8_t value) {
 void PPU::DMAWriteOAM(uint8_t index, uint8_t value) {
     if (index < 160) oam[index] = value;
 }
+
+// === Save State ===
+
+template <typename Self, typename Archive>
+void PPU::Serialize(Self& self, Archive& archive) {
+    archive(self.mode, self.mode_visible, self.next_mode_visible, self.mode_visibility_delay);
+    archive(self.dot_counter, self.ly, self.ly_for_comparison, self.window_line);
+    archive(self.window_active, self.window_triggered, self.lcd_just_enabled, self.first_line_after_lcd);
+    archive(self.ly_update_pending, self.ly_comparator_delay, self.next_ly);
+    archive(self.oam_read_blocked, self.oam_write_blocked, self.vram_read_blocked, self.vram_write_blocked);
+    archive(self.lcdc, self.stat, self.scy, self.scx, self.lyc, self.bgp, self.obp0, self.obp1, self.wy, self.wx);
+    archive(self.vram, self.oam, self.framebuffer);
+    archive(self.vblank_irq, self.stat_irq, self.frame_complete, self.frame_count);
+    archive(self.stat_line, self.mode0_interrupt_pending, self.mode_for_interrupt);
+    archive(self.debug_global_cycle, self.debug_mode0_cycle, self.debug_mode0_pending);
+    archive(self.bg_fifo_low, self.bg_fifo_high, self.bg_fifo_size);
+    archive(self.sprite_fifo_low, self.sprite_fifo_high, self.sprite_fifo_palette, self.sprite_fifo_priority, self.sprite_fifo_size);
+    archive(self.fetcher_step, self.fetcher_dots, self.fetcher_x);
+    archive(self.fetcher_tile_no, self.fetcher_tile_low, self.fetcher_tile_high, self.fetcher_window);
+    archive(self.lcd_x, self.position_in_line);
+    archive(self.scanline_sprites, self.sprite_count, self.sprite_index, self.fetching_sprite);
+}
+
+void PPU::SaveState(StateWriter& state) const {
+    Serialize(*this, state);
+}
+
+void PPU::LoadState(StateReader& state) {
+    Serialize(*this, state);
+    if (tile_maps) tile_maps->InvalidateAll();
+}
+
+// === Tile Map Layers ===
+
+void PPU::SetTileMapCacheEnabled(bool enabled) {
+    if (!enabled) {
+        tile_maps.reset();
+    } else if (!tile_maps) {
+        tile_maps = std::make_unique<TileMapCache>();
+    }
+}
+
+const TileMapCache::Layer& PPU::GetTileMapLayer(int map, bool unsigned_tiles) {
+    SetTileMapCacheEnabled(true);
+    return tile_maps->Get(vram, map & 1, unsigned_tiles);
+}
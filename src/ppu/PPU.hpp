@@ -3,6 +3,12 @@
 #include <cstdint>
 #include <array>
 #include <functional>
+#include <memory>
+#include "TileMapCache.hpp"
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
 
 /**
  * PPU - Picture Processing Unit (Hardware-Accurate Pixel FIFO)
@@ -10,7 +16,7 @@
  * Hardware Behavior:
  * - Operates on dot clock (same as T-cycle: 4.194304 MHz)
  * - Cycles through modes: OAM Scan -> Pixel Transfer -> HBlank -> VBlank
- * - Uses dual 16-pixel FIFOs for background and sprites
+ * - Uses dual 16-pixel FIFOs for background and sprites (bit-plane shift registers)
  * - 5-step fetcher: Get Tile -> Get Data Low -> Get Data High -> Sleep -> Push
  * 
  * Timing:
@@ -20,7 +26,7 @@
  * - Mode 0 (HBlank): remainder to 456
  * - Mode 1 (VBlank): 10 scanlines (4560 dots)
  */
-class PPU {
+class PPU : public ArenaAllocated {
 public:
     PPU();
     
@@ -52,6 +58,8 @@ public:
     const std::array<uint8_t, 160 * 144>& GetFramebuffer() const { return framebuffer; }
     bool IsFrameComplete() const { return frame_complete; }
     void ClearFrameComplete() { frame_complete = false; }
+    uint32_t GetFrameCount() const { return frame_count; }  // Frames completed since reset
+    const uint32_t* GetFrameCounter() const { return &frame_count; }  // For CPU::Run's stop check
     
     // === State Query ===
     uint8_t GetMode() const { return mode; }
@@ -65,6 +73,17 @@ public:
     using InterruptCallback = std::function<void(uint8_t)>;
     void SetInterruptCallback(InterruptCallback callback) { irq_callback = callback; }
     
+    // === Tile Map Layers (see TileMapCache.hpp) ===
+    // For map viewers; rendering always goes through the FIFO
+    void SetTileMapCacheEnabled(bool enabled);
+    bool IsTileMapCacheEnabled() const { return tile_maps != nullptr; }
+    // Current image of map 0 ($9800) / 1 ($9C00); turns the cache on
+    const TileMapCache::Layer& GetTileMapLayer(int map, bool unsigned_tiles);
+    
+    // === Save State (see StateBuffer.hpp) ===
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+    
 private:
     // === PPU Modes ===
     enum Mode : uint8_t {
@@ -84,12 +103,11 @@ private:
         PUSH                // Push 8 pixels to FIFO (1 T-cycle when FIFO ready)
     };
     
-    // === Pixel FIFO Entry ===
+    // === Pixel FIFO Output (one popped pixel) ===
     struct FIFOPixel {
         uint8_t color;          // 0-3 (2-bit color value)
-        uint8_t palette;        // DMG: 0-1 (OBP0/OBP1), CGB: 0-7
+        uint8_t palette;        // DMG: 0-1 (OBP0/OBP1)
         uint8_t bg_priority;    // OBJ-to-BG priority (1=behind BG colors 1-3)
-        uint8_t oam_index;      // For DMG X-priority: lower X or earlier OAM wins
     };
     
     // === Sprite Entry (OAM scan result) ===
@@ -145,10 +163,14 @@ private:
     // === Framebuffer ===
     std::array<uint8_t, 160 * 144> framebuffer;
     
+    // === Tile Map Cache (not saved: rebuilt from VRAM) ===
+    std::unique_ptr<TileMapCache> tile_maps;
+    
     // === Interrupt Flags ===
     bool vblank_irq;
     bool stat_irq;
     bool frame_complete;
+    uint32_t frame_count;    // Incremented with frame_complete (never cleared by consumers)
     bool stat_line;          // Previous STAT interrupt line state
     bool mode0_interrupt_pending;  // Per SameBoy: Mode 0 interrupt fires 1 cycle after lcd_x=160
     int8_t mode_for_interrupt;  // Per SameBoy: separate from actual mode for STAT timing
@@ -160,12 +182,16 @@ private:
     bool debug_mode0_pending;     // Waiting to measure LY change after Mode 0
     InterruptCallback irq_callback;  // Per SameBoy L558: for immediate IF bit set at exact cycle
     
-    // === Pixel FIFO (16 entries each) ===
-    std::array<FIFOPixel, 16> bg_fifo;
-    std::array<FIFOPixel, 16> sprite_fifo;
-    uint8_t bg_fifo_head;
+    // === Pixel FIFO (16-entry shift registers, packed as bit planes) ===
+    // Bit 15 is the head of the FIFO (next pixel out); popping shifts left.
+    // Slots at or beyond *_fifo_size are always zero (transparent).
+    uint16_t bg_fifo_low;       // Color bit 0 of each BG pixel
+    uint16_t bg_fifo_high;      // Color bit 1 of each BG pixel
     uint8_t bg_fifo_size;
-    uint8_t sprite_fifo_head;
+    uint16_t sprite_fifo_low;       // Color bit 0 of each OBJ pixel
+    uint16_t sprite_fifo_high;      // Color bit 1 of each OBJ pixel
+    uint16_t sprite_fifo_palette;   // 1 = OBP1
+    uint16_t sprite_fifo_priority;  // 1 = behind BG colors 1-3
     uint8_t sprite_fifo_size;
     
     // === Fetcher State ===
@@ -204,9 +230,7 @@ private:
     
     // === FIFO Operations ===
     void ClearFIFOs();
-    void PushBGPixel(uint8_t color);
-    FIFOPixel PopBGPixel();
-    void PushSpritePixel(uint8_t color, uint8_t palette, bool bg_priority, uint8_t oam_idx);
+    uint8_t PopBGPixel();
     FIFOPixel PopSpritePixel();
     bool RenderPixel();  // Returns true if pixel rendered, false if window triggered
     
@@ -225,4 +249,7 @@ private:
     uint16_t GetBGTileMapBase() const { return (lcdc & 0x08) ? 0x9C00 : 0x9800; }
     uint16_t GetWindowTileMapBase() const { return (lcdc & 0x40) ? 0x9C00 : 0x9800; }
     bool UsesSignedTileIndex() const { return !(lcdc & 0x10); }
+    
+    template <typename Self, typename Archive>
+    static void Serialize(Self& self, Archive& archive);
 };
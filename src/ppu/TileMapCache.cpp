@@ -0,0 +1,61 @@
+#include "TileMapCache.hpp"
+
+// Spread the 8 bits of a tile row byte to the even bits of a word
+static constexpr std::array<uint16_t, 256> MakeSpreadTable() {
+    std::array<uint16_t, 256> table{};
+    for (int i = 0; i < 256; i++) {
+        uint16_t spread = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            if (i & (1 << bit)) spread |= 1 << (bit * 2);
+        }
+        table[i] = spread;
+    }
+    return table;
+}
+
+static constexpr std::array<uint16_t, 256> SPREAD_BITS = MakeSpreadTable();
+
+TileMapCache::TileMapCache() {
+    InvalidateAll();
+}
+
+void TileMapCache::InvalidateAll() {
+    for (LayerState& layer : layers) {
+        layer.dirty_tiles.set();
+        layer.dirty_cells.set();
+        layer.dirty = true;
+    }
+}
+
+// === Layers ===
+
+const TileMapCache::Layer& TileMapCache::Get(const std::array<uint8_t, 8192>& vram, int map, bool unsigned_tiles) {
+    LayerState& layer = layers[map * 2 + unsigned_tiles];
+    if (layer.dirty) Refresh(layer, vram, map, unsigned_tiles);
+    return layer.pixels;
+}
+
+void TileMapCache::Refresh(LayerState& layer, const std::array<uint8_t, 8192>& vram, int map, bool unsigned_tiles) {
+    const uint8_t* cells = &vram[map ? 0x1C00 : 0x1800];
+    bool any_tile = layer.dirty_tiles.any();
+    
+    for (uint16_t cell = 0; cell < 1024; cell++) {
+        uint8_t tile_no = cells[cell];
+        // $8800 mode: tiles 0-127 at $9000, 128-255 at $8800 (tile 256 + signed index)
+        uint16_t tile = unsigned_tiles ? tile_no : static_cast<uint16_t>(256 + static_cast<int8_t>(tile_no));
+        if (!layer.dirty_cells[cell] && !(any_tile && layer.dirty_tiles[tile])) continue;
+        
+        const uint8_t* data = &vram[tile * 16];
+        uint16_t y = (cell >> 5) * 8;
+        uint8_t x = cell & 31;
+        for (int line = 0; line < 8; line++) {
+            uint8_t low = data[line * 2];
+            uint8_t high = data[line * 2 + 1];
+            layer.pixels[y + line][x] = static_cast<uint16_t>((SPREAD_BITS[high] << 1) | SPREAD_BITS[low]);
+        }
+    }
+    
+    layer.dirty_tiles.reset();
+    layer.dirty_cells.reset();
+    layer.dirty = false;
+}
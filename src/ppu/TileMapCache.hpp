@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <bitset>
+#include "../host/ArenaAllocated.hpp"
+
+/**
+ * TileMapCache - Pre-Rendered Background/Window Layers
+ *
+ * Both 32x32 tile maps ($9800 and $9C00) rendered as 256x256 2bpp images,
+ * once per tile data addressing mode ($8000 unsigned, $8800 signed), and
+ * kept current incrementally from VRAM writes:
+ * - A tile data write dirties that tile in the layers that can use it
+ * - A map write dirties that cell in both layers of its map
+ * - Get() re-renders only dirty cells and cells showing a dirty tile
+ *
+ * Row format: 32 words of 8 pixels each, 2 bits per pixel with the
+ * leftmost pixel in bits 15-14. Debug map viewers get an always-current
+ * image (see Emulator::GetTileMapImage); the PPU never draws from it.
+ */
+class TileMapCache : public ArenaAllocated {
+public:
+    using Row = std::array<uint16_t, 32>;
+    using Layer = std::array<Row, 256>;
+
+    TileMapCache();
+
+    // Call after every VRAM write (offset = address - $8000)
+    void Invalidate(uint16_t offset) {
+        if (offset < 0x1800) {
+            uint16_t tile = offset >> 4;
+            // Unsigned layers use tiles 0-255, signed layers 128-383
+            for (int map = 0; map < 2; map++) {
+                if (tile < 256) MarkTile(map * 2 + 1, tile);
+                if (tile >= 128) MarkTile(map * 2, tile);
+            }
+        } else {
+            int map = offset >= 0x1C00;
+            uint16_t cell = offset & 0x3FF;
+            MarkCell(map * 2, cell);
+            MarkCell(map * 2 + 1, cell);
+        }
+    }
+
+    // After VRAM changed wholesale (Reset, LoadState)
+    void InvalidateAll();
+
+    // Layer for map 0 ($9800) / 1 ($9C00) in $8000 (true) or $8800 mode
+    const Layer& Get(const std::array<uint8_t, 8192>& vram, int map, bool unsigned_tiles);
+
+private:
+    struct LayerState {
+        Layer pixels;
+        std::bitset<384> dirty_tiles;
+        std::bitset<1024> dirty_cells;
+        bool dirty;
+    };
+
+    std::array<LayerState, 4> layers;   // Index: map * 2 + unsigned_tiles
+
+    void MarkTile(int layer, uint16_t tile) {
+        layers[layer].dirty_tiles.set(tile);
+        layers[layer].dirty = true;
+    }
+
+    void MarkCell(int layer, uint16_t cell) {
+        layers[layer].dirty_cells.set(cell);
+        layers[layer].dirty = true;
+    }
+
+    void Refresh(LayerState& layer, const std::array<uint8_t, 8192>& vram, int map, bool unsigned_tiles);
+};
@@ -0,0 +1,206 @@
+#include "LuaScript.hpp"
+#include "../Emulator.hpp"
+#include "../input/Joypad.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <lua.hpp>
+
+LuaScript::LuaScript(Emulator& emu)
+    : emu(emu)
+    , state(luaL_newstate())
+{
+    luaL_openlibs(state);
+
+    static const luaL_Reg functions[] = {
+        { "read", Read },
+        { "write", Write },
+        { "set_button", SetButton },
+        { "save_state", SaveState },
+        { "load_state", LoadState },
+        { "on_frame", OnFrame },
+        { "on_write", OnWrite },
+        { "on_exec", OnExec },
+        { "remove_hook", RemoveHook },
+        { "frame", Frame },
+        { "cycles", Cycles },
+        { "registers", Registers },
+        { nullptr, nullptr }
+    };
+
+    // Every function gets this object as its upvalue
+    lua_newtable(state);
+    lua_pushlightuserdata(state, this);
+    luaL_setfuncs(state, functions, 1);
+    lua_setglobal(state, "emu");
+}
+
+LuaScript::~LuaScript() {
+    for (const auto& hook : hook_refs) {
+        emu.RemoveHook(hook.first);
+    }
+    lua_close(state);
+}
+
+bool LuaScript::Load(const std::string& path) {
+    if (luaL_loadfile(state, path.c_str()) != LUA_OK) {
+        std::cerr << "Lua: " << lua_tostring(state, -1) << "\n";
+        lua_pop(state, 1);
+        return false;
+    }
+    if (lua_pcall(state, 0, 0, 0) != LUA_OK) {
+        std::cerr << "Lua: " << lua_tostring(state, -1) << "\n";
+        lua_pop(state, 1);
+        return false;
+    }
+    std::cout << "Script loaded: " << path << "\n";
+    return true;
+}
+
+// Calls the function sitting below `nargs` arguments on the stack
+void LuaScript::Call(int nargs) {
+    if (lua_pcall(state, nargs, 0, 0) != LUA_OK) {
+        std::cerr << "Lua: " << lua_tostring(state, -1) << "\n";
+        lua_pop(state, 1);
+    }
+}
+
+uint32_t LuaScript::Register(uint32_t id, int ref) {
+    if (id == 0) {
+        luaL_unref(state, LUA_REGISTRYINDEX, ref);
+        return 0;
+    }
+    hook_refs[id] = ref;
+    return id;
+}
+
+LuaScript& LuaScript::Self(lua_State* L) {
+    return *static_cast<LuaScript*>(lua_touserdata(L, lua_upvalueindex(1)));
+}
+
+// === Memory / Input / State ===
+
+int LuaScript::Read(lua_State* L) {
+    uint16_t addr = static_cast<uint16_t>(luaL_checkinteger(L, 1));
+    lua_pushinteger(L, Self(L).emu.DebugRead(addr));
+    return 1;
+}
+
+int LuaScript::Write(lua_State* L) {
+    uint16_t addr = static_cast<uint16_t>(luaL_checkinteger(L, 1));
+    uint8_t value = static_cast<uint8_t>(luaL_checkinteger(L, 2));
+    Self(L).emu.DebugWrite(addr, value);
+    return 0;
+}
+
+int LuaScript::SetButton(lua_State* L) {
+    static const char* const names[] = { "a", "b", "select", "start", "right", "left", "up", "down", nullptr };
+    // Order matches the Joypad::BUTTON_* indices
+    int button = luaL_checkoption(L, 1, nullptr, names);
+    Self(L).emu.SetButton(static_cast<uint8_t>(Joypad::BUTTON_A + button), lua_toboolean(L, 2) != 0);
+    return 0;
+}
+
+int LuaScript::SaveState(lua_State* L) {
+    std::vector<uint8_t> data;
+    Self(L).emu.SaveState(data);
+    lua_pushlstring(L, reinterpret_cast<const char*>(data.data()), data.size());
+    return 1;
+}
+
+int LuaScript::LoadState(lua_State* L) {
+    size_t size = 0;
+    const char* bytes = luaL_checklstring(L, 1, &size);
+    std::vector<uint8_t> data(size);
+    if (size) std::memcpy(data.data(), bytes, size);
+    lua_pushboolean(L, Self(L).emu.LoadState(data));
+    return 1;
+}
+
+// === Hooks ===
+
+int LuaScript::OnFrame(lua_State* L) {
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    lua_pushvalue(L, 1);
+    LuaScript& self = Self(L);
+    int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    uint32_t id = self.emu.AddFrameHook([&self, ref]() {
+        lua_rawgeti(self.state, LUA_REGISTRYINDEX, ref);
+        self.Call(0);
+    });
+    lua_pushinteger(L, self.Register(id, ref));
+    return 1;
+}
+
+int LuaScript::OnWrite(lua_State* L) {
+    uint16_t first = static_cast<uint16_t>(luaL_checkinteger(L, 1));
+    uint16_t last = static_cast<uint16_t>(luaL_checkinteger(L, 2));
+    luaL_checktype(L, 3, LUA_TFUNCTION);
+    lua_pushvalue(L, 3);
+    LuaScript& self = Self(L);
+    int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    uint32_t id = self.emu.AddWriteHook(first, last, [&self, ref](uint16_t addr, uint8_t value) {
+        lua_rawgeti(self.state, LUA_REGISTRYINDEX, ref);
+        lua_pushinteger(self.state, addr);
+        lua_pushinteger(self.state, value);
+        self.Call(2);
+    });
+    lua_pushinteger(L, self.Register(id, ref));
+    return 1;
+}
+
+int LuaScript::OnExec(lua_State* L) {
+    uint16_t addr = static_cast<uint16_t>(luaL_checkinteger(L, 1));
+    luaL_checktype(L, 2, LUA_TFUNCTION);
+    lua_pushvalue(L, 2);
+    LuaScript& self = Self(L);
+    int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    uint32_t id = self.emu.AddExecHook(addr, [&self, ref](uint16_t pc) {
+        lua_rawgeti(self.state, LUA_REGISTRYINDEX, ref);
+        lua_pushinteger(self.state, pc);
+        self.Call(1);
+    });
+    lua_pushinteger(L, self.Register(id, ref));
+    return 1;
+}
+
+int LuaScript::RemoveHook(lua_State* L) {
+    LuaScript& self = Self(L);
+    uint32_t id = static_cast<uint32_t>(luaL_checkinteger(L, 1));
+    auto it = self.hook_refs.find(id);
+    bool removed = it != self.hook_refs.end() && self.emu.RemoveHook(id);
+    if (removed) {
+        // The hook may be the one running right now; its function stays
+        // on the Lua stack until it returns, so dropping the ref is safe
+        luaL_unref(L, LUA_REGISTRYINDEX, it->second);
+        self.hook_refs.erase(it);
+    }
+    lua_pushboolean(L, removed);
+    return 1;
+}
+
+// === Machine Info ===
+
+int LuaScript::Frame(lua_State* L) {
+    lua_pushinteger(L, Self(L).emu.GetFrameCount());
+    return 1;
+}
+
+int LuaScript::Cycles(lua_State* L) {
+    lua_pushinteger(L, static_cast<lua_Integer>(Self(L).emu.GetTotalCycles()));
+    return 1;
+}
+
+int LuaScript::Registers(lua_State* L) {
+    const Emulator& emu = Self(L).emu;
+    lua_createtable(L, 0, 6);
+    lua_pushinteger(L, emu.GetPC()); lua_setfield(L, -2, "pc");
+    lua_pushinteger(L, emu.GetSP()); lua_setfield(L, -2, "sp");
+    lua_pushinteger(L, emu.GetAF()); lua_setfield(L, -2, "af");
+    lua_pushinteger(L, emu.GetBC()); lua_setfield(L, -2, "bc");
+    lua_pushinteger(L, emu.GetDE()); lua_setfield(L, -2, "de");
+    lua_pushinteger(L, emu.GetHL()); lua_setfield(L, -2, "hl");
+    return 1;
+}
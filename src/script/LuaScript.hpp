@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+class Emulator;
+struct lua_State;
+
+/**
+ * LuaScript - Lua Front End for the Scripting Hooks
+ *
+ * Built only when CMake finds a system Lua 5.2+ (GB_HAVE_LUA); nothing is
+ * vendored. The script runs in-process on the emulation thread, so hooks
+ * are plain function calls from the emulator's hot paths (see
+ * ScriptHooks.hpp) rather than IPC round trips.
+ *
+ * Script API (global `emu` table):
+ * - emu.read(addr), emu.write(addr, value)   bus access, no write hooks
+ * - emu.set_button(name, pressed)            a b select start right left up down
+ * - emu.save_state() -> string               binary snapshot
+ * - emu.load_state(string) -> bool           frame hooks / top level only
+ * - emu.on_frame(fn)                         fn()
+ * - emu.on_write(first, last, fn)            fn(addr, value)
+ * - emu.on_exec(addr, fn)                    fn(pc)
+ * - emu.remove_hook(id)                      ids come from the on_* calls
+ * - emu.frame(), emu.cycles()
+ * - emu.registers() -> {pc, sp, af, bc, de, hl}
+ *
+ * Errors inside hooks are printed to stderr and emulation continues.
+ */
+class LuaScript {
+public:
+    explicit LuaScript(Emulator& emu);
+    ~LuaScript();
+
+    LuaScript(const LuaScript&) = delete;
+    LuaScript& operator=(const LuaScript&) = delete;
+
+    // Run the script's top level (which normally registers hooks)
+    bool Load(const std::string& path);
+
+private:
+    Emulator& emu;
+    lua_State* state;
+    std::unordered_map<uint32_t, int> hook_refs;   // Hook id -> registry ref of its function
+
+    void Call(int nargs);
+    uint32_t Register(uint32_t id, int ref);
+
+    static LuaScript& Self(lua_State* L);
+    static int Read(lua_State* L);
+    static int Write(lua_State* L);
+    static int SetButton(lua_State* L);
+    static int SaveState(lua_State* L);
+    static int LoadState(lua_State* L);
+    static int OnFrame(lua_State* L);
+    static int OnWrite(lua_State* L);
+    static int OnExec(lua_State* L);
+    static int RemoveHook(lua_State* L);
+    static int Frame(lua_State* L);
+    static int Cycles(lua_State* L);
+    static int Registers(lua_State* L);
+};
@@ -0,0 +1,126 @@
+#include "ScriptHooks.hpp"
+
+#include <algorithm>
+
+// === Registration ===
+
+ScriptHooks::HookId ScriptHooks::AddFrameHook(FrameHook hook) {
+    if (!hook) return 0;
+    HookId id = next_id++;
+    entries.push_back({id, Kind::FRAME, 0, 0, std::move(hook), nullptr, nullptr, false});
+    frame_count++;
+    return id;
+}
+
+ScriptHooks::HookId ScriptHooks::AddWriteHook(uint16_t first, uint16_t last, WriteHook hook) {
+    if (!hook) return 0;
+    if (first > last) std::swap(first, last);
+    HookId id = next_id++;
+    entries.push_back({id, Kind::WRITE, first, last, nullptr, std::move(hook), nullptr, false});
+    for (uint32_t page = first >> 8; page <= static_cast<uint32_t>(last >> 8); page++) {
+        write_pages[page]++;
+    }
+    write_count++;
+    return id;
+}
+
+ScriptHooks::HookId ScriptHooks::AddExecHook(uint16_t addr, ExecHook hook) {
+    if (!hook) return 0;
+    HookId id = next_id++;
+    entries.push_back({id, Kind::EXEC, addr, addr, nullptr, nullptr, std::move(hook), false});
+    exec_map[addr >> 3] |= static_cast<uint8_t>(1 << (addr & 7));
+    exec_count++;
+    return id;
+}
+
+bool ScriptHooks::Remove(HookId id) {
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [id](const Entry& entry) { return entry.id == id && !entry.removed; });
+    if (it == entries.end()) return false;
+
+    it->removed = true;
+    switch (it->kind) {
+        case Kind::FRAME:
+            frame_count--;
+            break;
+        case Kind::WRITE:
+            for (uint32_t page = it->first >> 8; page <= static_cast<uint32_t>(it->last >> 8); page++) {
+                write_pages[page]--;
+            }
+            write_count--;
+            break;
+        case Kind::EXEC:
+            exec_count--;
+            RebuildExecBit(it->first);
+            break;
+    }
+
+    needs_compact = true;
+    if (dispatch_depth == 0) Compact();
+    return true;
+}
+
+void ScriptHooks::Clear() {
+    for (Entry& entry : entries) entry.removed = true;
+    frame_count = write_count = exec_count = 0;
+    write_pages.fill(0);
+    exec_map.fill(0);
+    needs_compact = true;
+    if (dispatch_depth == 0) Compact();
+}
+
+void ScriptHooks::RebuildExecBit(uint16_t addr) {
+    bool any = std::any_of(entries.begin(), entries.end(), [addr](const Entry& entry) {
+        return !entry.removed && entry.kind == Kind::EXEC && entry.first == addr;
+    });
+    uint8_t bit = static_cast<uint8_t>(1 << (addr & 7));
+    if (any) exec_map[addr >> 3] |= bit;
+    else exec_map[addr >> 3] &= ~bit;
+}
+
+void ScriptHooks::Compact() {
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const Entry& entry) { return entry.removed; }),
+                  entries.end());
+    needs_compact = false;
+}
+
+// === Dispatch ===
+// Only hooks registered before the dispatch started are visited; entries
+// are looked up by index each time because a hook may add more.
+
+void ScriptHooks::DispatchWrite(uint16_t addr, uint8_t value) {
+    dispatch_depth++;
+    size_t count = entries.size();
+    for (size_t i = 0; i < count; i++) {
+        Entry& entry = entries[i];
+        if (entry.kind == Kind::WRITE && !entry.removed && addr >= entry.first && addr <= entry.last) {
+            entry.on_write(addr, value);
+        }
+    }
+    if (--dispatch_depth == 0 && needs_compact) Compact();
+}
+
+void ScriptHooks::DispatchExec(uint16_t pc) {
+    dispatch_depth++;
+    size_t count = entries.size();
+    for (size_t i = 0; i < count; i++) {
+        Entry& entry = entries[i];
+        if (entry.kind == Kind::EXEC && !entry.removed && entry.first == pc) {
+            entry.on_exec(pc);
+        }
+    }
+    if (--dispatch_depth == 0 && needs_compact) Compact();
+}
+
+void ScriptHooks::DispatchFrame() {
+    dispatch_depth++;
+    size_t count = entries.size();
+    for (size_t i = 0; i < count; i++) {
+        Entry& entry = entries[i];
+        if (entry.kind == Kind::FRAME && !entry.removed) {
+            entry.on_frame();
+        }
+    }
+    if (--dispatch_depth == 0 && needs_compact) Compact();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include "../host/ArenaAllocated.hpp"
+
+/**
+ * ScriptHooks - Frame, Memory-Write and Execution Callbacks
+ *
+ * Registry behind the Emulator's scripting API (Emulator::Add*Hook).
+ * Nothing here costs anything until a hook of that kind is registered:
+ * the Emulator only splices the write filter into the CPU's bus lines
+ * while write hooks exist, the CPU only consults the execution bitmap
+ * while it is connected, and frame hooks are a single flag test per
+ * instruction.
+ *
+ * Dispatch:
+ * - Write hooks: per-page counts reject most addresses with one load,
+ *   then each hook's [first, last] range is checked
+ * - Exec hooks: one bit per address, tested before each opcode fetch
+ * - Frame hooks: once per completed frame, between instructions
+ *
+ * Hooks run on the emulation thread. Write and exec hooks fire inside an
+ * instruction and may read/write memory or set input; anything that
+ * replaces the whole machine (LoadState) belongs in a frame hook.
+ * Hooks may add or remove hooks (including themselves) while running.
+ */
+class ScriptHooks : public ArenaAllocated {
+public:
+    using HookId = uint32_t;
+    using FrameHook = std::function<void()>;
+    using WriteHook = std::function<void(uint16_t addr, uint8_t value)>;
+    using ExecHook = std::function<void(uint16_t pc)>;
+
+    // === Registration (ids are never reused; 0 is never returned) ===
+    HookId AddFrameHook(FrameHook hook);
+    HookId AddWriteHook(uint16_t first, uint16_t last, WriteHook hook);
+    HookId AddExecHook(uint16_t addr, ExecHook hook);
+    bool Remove(HookId id);
+    void Clear();
+
+    bool HasFrameHooks() const { return frame_count > 0; }
+    bool HasWriteHooks() const { return write_count > 0; }
+    bool HasExecHooks() const { return exec_count > 0; }
+
+    // === Dispatch (called from the emulation hot paths) ===
+    bool WatchesWrite(uint16_t addr) const { return write_pages[addr >> 8] != 0; }
+    void DispatchWrite(uint16_t addr, uint8_t value);
+    void DispatchExec(uint16_t pc);
+    void DispatchFrame();
+
+    // One bit per address, set where an exec hook is registered
+    const uint8_t* GetExecMap() const { return exec_map.data(); }
+
+private:
+    enum class Kind : uint8_t { FRAME, WRITE, EXEC };
+
+    struct Entry {
+        HookId id;
+        Kind kind;
+        uint16_t first;     // Write range / exec address
+        uint16_t last;
+        FrameHook on_frame;
+        WriteHook on_write;
+        ExecHook on_exec;
+        bool removed;
+    };
+
+    // Deque: push_back keeps references to running hooks valid
+    std::deque<Entry> entries;
+    HookId next_id = 1;
+    uint32_t dispatch_depth = 0;   // Erasing is deferred while > 0
+    bool needs_compact = false;
+
+    uint32_t frame_count = 0;
+    uint32_t write_count = 0;
+    uint32_t exec_count = 0;
+
+    std::array<uint16_t, 256> write_pages = {};    // Write hooks touching each page
+    std::array<uint8_t, 0x2000> exec_map = {};
+
+    void RebuildExecBit(uint16_t addr);
+    void Compact();
+};
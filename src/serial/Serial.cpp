@@ -1,4 +1,5 @@
 #include "Serial.hpp"
+#include "../state/StateBuffer.hpp"
 
 Serial::Serial() {
     Reset();
@@ -41,6 +42,7 @@ void Serial::Step(uint8_t cycles) {
             sc &= ~0x80;  // Clear transfer flag
             interrupt_requested = true;
             transfer_complete = true;
+            if (transfer_callback) transfer_callback(transfer_data);
         }
     }
 }
@@ -60,6 +62,7 @@ void Serial::SetClockIn(bool value) {
                 sc &= ~0x80;
                 interrupt_requested = true;
                 transfer_complete = true;
+                if (transfer_callback) transfer_callback(transfer_data);
             }
         }
         clock_out = value;
@@ -91,3 +94,20 @@ void Serial::WriteRegister(uint16_t addr, uint8_t value) {
             break;
     }
 }
+
+// === Save State ===
+
+template <typename Self, typename Archive>
+void Serial::Serialize(Self& self, Archive& archive) {
+    archive(self.sb, self.sc, self.shift_clock, self.bits_transferred, self.transfer_active);
+    archive(self.serial_out, self.serial_in, self.clock_out);
+    archive(self.interrupt_requested, self.transfer_complete, self.transfer_data);
+}
+
+void Serial::SaveState(StateWriter& state) const {
+    Serialize(*this, state);
+}
+
+void Serial::LoadState(StateReader& state) {
+    Serialize(*this, state);
+}
@@ -1,6 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
 
 /**
  * Serial - Serial Transfer Hardware
@@ -17,7 +22,7 @@
  * - Interrupt output signal
  * - Serial in/out pins (directly exposed for link cable emulation)
  */
-class Serial {
+class Serial : public ArenaAllocated {
 public:
     Serial();
     
@@ -52,6 +57,14 @@ public:
     bool IsTransferComplete() const { return transfer_complete; }
     void ClearTransferComplete() { transfer_complete = false; }
     
+    // Called with the sent byte as each transfer completes (test ROM output)
+    using TransferCallback = std::function<void(uint8_t)>;
+    void SetTransferCallback(TransferCallback callback) { transfer_callback = callback; }
+    
+    // === Save State (see StateBuffer.hpp) ===
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+    
 private:
     // === Registers (directly exposed memory-mapped) ===
     uint8_t sb;     // $FF01 - Serial transfer data
@@ -71,6 +84,7 @@ private:
     bool interrupt_requested;
     bool transfer_complete;     // For test ROM detection
     uint8_t transfer_data;      // Byte that was sent (for Blargg tests)
+    TransferCallback transfer_callback;
     
     // === Helpers (directly expose the serial protocol) ===
     bool IsTransferEnabled() const { return sc & 0x80; }
@@ -79,4 +93,7 @@ private:
     // DMG serial clock rate: 8192 Hz (internally exposed)
     // Each bit takes 512 T-cycles = 128 M-cycles
     static constexpr uint16_t CYCLES_PER_BIT = 512;
+    
+    template <typename Self, typename Archive>
+    static void Serialize(Self& self, Archive& archive);
 };
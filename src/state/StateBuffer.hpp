@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/**
+ * StateWriter / StateReader - Save State Byte Streams
+ *
+ * Each component lists its state once, in a static Serialize(self, archive)
+ * template, and SaveState()/LoadState() instantiate it with a writer or a
+ * reader. Fields are stored as raw host-endian bytes in declaration order:
+ * states are meant for the same build on the same machine (rewind,
+ * timelines, lockstep comparison, scripting), not as an interchange format.
+ *
+ * Interface:
+ * - archive(a, b, c...): save or load each field (trivially copyable)
+ * - archive.Bytes(v): length-prefixed byte vector; loading requires the
+ *   same length (cartridge RAM is sized by the ROM and never reallocated,
+ *   since the bank windows point into it)
+ * - StateReader::IsValid(): false after a short read or Fail()
+ */
+class StateWriter {
+public:
+    explicit StateWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    template <typename... T>
+    void operator()(const T&... values) { (Write(values), ...); }
+
+    void Bytes(const std::vector<uint8_t>& data) {
+        Write(static_cast<uint32_t>(data.size()));
+        out.insert(out.end(), data.begin(), data.end());
+    }
+
+private:
+    std::vector<uint8_t>& out;
+
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "State fields must be trivially copyable");
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+};
+
+class StateReader {
+public:
+    StateReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    template <typename... T>
+    void operator()(T&... values) { (Read(values), ...); }
+
+    void Bytes(std::vector<uint8_t>& out) {
+        uint32_t length = 0;
+        Read(length);
+        if (length != out.size() || !Take(length)) {
+            Fail();
+            return;
+        }
+        if (length) std::memcpy(out.data(), data + position - length, length);
+    }
+
+    void Fail() { valid = false; }
+    bool IsValid() const { return valid; }
+    bool AtEnd() const { return position == size; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t position = 0;
+    bool valid = true;
+
+    bool Take(size_t count) {
+        if (!valid || size - position < count) {
+            valid = false;
+            return false;
+        }
+        position += count;
+        return true;
+    }
+
+    template <typename T>
+    void Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "State fields must be trivially copyable");
+        if (Take(sizeof(T))) std::memcpy(&value, data + position - sizeof(T), sizeof(T));
+    }
+};
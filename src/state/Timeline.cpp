@@ -0,0 +1,359 @@
+#include "Timeline.hpp"
+#include "../Emulator.hpp"
+#include "../util/Hash.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+static constexpr char TIMELINE_MAGIC[4] = { 'G', 'B', 'T', 'L' };
+static constexpr uint32_t TIMELINE_VERSION = 1;
+
+// Encoded keyframe tokens: 0x00-0x7F = 1-128 literal bytes follow,
+// 0x80-0xFF = 1-128 zero bytes (unchanged ones, when XORed)
+static constexpr uint32_t MAX_RUN = 128;
+
+static void ApplyButtons(Emulator& emu, uint8_t buttons) {
+    for (uint8_t button = 0; button < 8; button++) {
+        emu.SetButton(button, (buttons >> button) & 1);
+    }
+}
+
+bool Timeline::Start(Emulator& emu) {
+    Clear();
+    spacing = min_spacing;
+    AddKeyframe(emu);
+    return true;
+}
+
+void Timeline::Clear() {
+    inputs.clear();
+    keyframes.clear();
+    keyframe_bytes = 0;
+    position = 0;
+}
+
+void Timeline::SetMemoryBudget(size_t bytes) {
+    budget = bytes;
+    EnforceBudget();
+}
+
+// === Recording ===
+
+void Timeline::RunFrame(Emulator& emu, uint8_t buttons) {
+    if (position < inputs.size() && inputs[position] != buttons) Truncate();
+
+    bool recording = position == inputs.size();
+    if (recording && position % spacing == 0 && (keyframes.empty() || keyframes.back().frame < position)) {
+        AddKeyframe(emu);
+    }
+
+    ApplyButtons(emu, buttons);
+    emu.RunFrame();
+    if (recording) inputs.push_back(buttons);
+    position++;
+}
+
+void Timeline::Truncate() {
+    inputs.resize(position);
+    while (keyframes.size() > 1 && keyframes.back().frame > position) {
+        keyframe_bytes -= keyframes.back().data.size();
+        keyframes.pop_back();
+    }
+}
+
+void Timeline::AddKeyframe(Emulator& emu) {
+    emu.SaveState(state);
+
+    Keyframe keyframe;
+    keyframe.frame = position;
+    keyframe.base = position;
+
+    // XOR against the keyframe starting this group (stored whole when it
+    // was taken, since it is a multiple of every smaller group size). A
+    // keyframe strictly inside the group is never a multiple of a 16x
+    // larger spacing, so no doubling drops a base but keeps its dependents.
+    uint32_t group = position - position % (spacing * BASE_INTERVAL);
+    if (!keyframes.empty() && group != position) {
+        size_t base = FindKeyframe(group);
+        if (keyframes[base].frame == group && keyframes[base].base == group &&
+            Decode(base, base_state) && base_state.size() == state.size()) {
+            keyframe.base = group;
+        }
+    }
+
+    Encode(state, keyframe.base != keyframe.frame ? &base_state : nullptr, encoded);
+    keyframe.data.assign(encoded.begin(), encoded.end());
+    keyframe_bytes += keyframe.data.size();
+    keyframes.push_back(std::move(keyframe));
+    EnforceBudget();
+}
+
+// Double the spacing until the keyframes fit (frame 0 always stays)
+void Timeline::EnforceBudget() {
+    while (GetMemoryUsed() > budget && keyframes.size() > 1) {
+        spacing *= 2;
+        keyframes.erase(std::remove_if(keyframes.begin(), keyframes.end(),
+                                       [this](const Keyframe& keyframe) { return keyframe.frame % spacing != 0; }),
+                        keyframes.end());
+        keyframe_bytes = 0;
+        for (const Keyframe& keyframe : keyframes) keyframe_bytes += keyframe.data.size();
+    }
+}
+
+// === Seeking ===
+
+bool Timeline::Seek(Emulator& emu, uint32_t frame) {
+    if (keyframes.empty()) return false;
+    frame = std::min(frame, GetLength());
+
+    // Short hops forward just keep running; everything else starts from a keyframe
+    size_t index = FindKeyframe(frame);
+    uint32_t from = keyframes[index].frame;
+    if (frame >= position && position > from) {
+        from = position;
+    } else {
+        if (!Decode(index, state) || !emu.LoadState(state)) return false;
+    }
+
+    for (uint32_t f = from; f < frame; f++) {
+        ApplyButtons(emu, inputs[f]);
+        emu.RunFrame();
+    }
+    position = frame;
+    return true;
+}
+
+// Last keyframe at or before `frame`
+size_t Timeline::FindKeyframe(uint32_t frame) const {
+    auto after = std::upper_bound(keyframes.begin(), keyframes.end(), frame,
+                                  [](uint32_t value, const Keyframe& keyframe) { return value < keyframe.frame; });
+    return static_cast<size_t>(after - keyframes.begin()) - 1;
+}
+
+bool Timeline::Decode(size_t index, std::vector<uint8_t>& out) const {
+    const Keyframe& keyframe = keyframes[index];
+    if (keyframe.base == keyframe.frame) return DecodeInto(keyframe.data, out, false);
+
+    if (!DecodeInto(keyframes[FindKeyframe(keyframe.base)].data, out, false)) return false;
+    return DecodeInto(keyframe.data, out, true);
+}
+
+// === Parallel Verification ===
+
+bool Timeline::Verify(const std::function<bool(Emulator&)>& load_rom, unsigned threads,
+                      VerifyReport& report) const {
+    report = VerifyReport();
+    if (keyframes.empty()) return false;
+    report.segments = static_cast<uint32_t>(keyframes.size());
+    report.first_mismatch = GetLength();
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, report.segments);
+
+    // Segments are handed out in order; with even spacing they cost the same
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::mutex report_mutex;
+
+    auto worker = [&]() {
+        auto emu = std::make_unique<Emulator>();
+        if (!load_rom(*emu)) {
+            failed = true;
+            return;
+        }
+
+        std::vector<uint8_t> start;
+        std::vector<uint8_t> end;
+        std::vector<uint8_t> expected;
+        for (size_t index = next++; index < keyframes.size() && !failed; index = next++) {
+            if (!Decode(index, start) || !emu->LoadState(start)) {
+                failed = true;
+                return;
+            }
+
+            bool last = index + 1 == keyframes.size();
+            uint32_t to = last ? GetLength() : keyframes[index + 1].frame;
+            for (uint32_t f = keyframes[index].frame; f < to; f++) {
+                ApplyButtons(*emu, inputs[f]);
+                emu->RunFrame();
+            }
+            emu->SaveState(end);
+
+            if (last) {
+                std::lock_guard<std::mutex> lock(report_mutex);
+                report.final_hash = HashBytes(end);
+            } else if (!Decode(index + 1, expected) || end != expected) {
+                std::lock_guard<std::mutex> lock(report_mutex);
+                report.mismatches++;
+                report.first_mismatch = std::min(report.first_mismatch, keyframes[index].frame);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& thread : pool) thread.join();
+
+    if (failed) std::cerr << "Timeline verification couldn't load the ROM or a keyframe\n";
+    return !failed;
+}
+
+// === Keyframe Encoding ===
+
+void Timeline::Encode(const std::vector<uint8_t>& data, const std::vector<uint8_t>* reference,
+                      std::vector<uint8_t>& out) {
+    auto value = [&](size_t i) -> uint8_t { return reference ? data[i] ^ (*reference)[i] : data[i]; };
+    size_t size = data.size();
+
+    out.clear();
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(size >> (i * 8)));
+
+    size_t i = 0;
+    while (i < size) {
+        size_t run = 0;
+        while (i + run < size && run < MAX_RUN && value(i + run) == 0) run++;
+        if (run > 0) {
+            out.push_back(static_cast<uint8_t>(0x80 + run - 1));
+            i += run;
+            continue;
+        }
+
+        // Literals until a zero pair (a lone zero is cheaper inline)
+        size_t start = out.size();
+        out.push_back(0);
+        size_t count = 0;
+        while (i < size && count < MAX_RUN) {
+            if (value(i) == 0 && (i + 1 == size || value(i + 1) == 0)) break;
+            out.push_back(value(i++));
+            count++;
+        }
+        out[start] = static_cast<uint8_t>(count - 1);
+    }
+}
+
+bool Timeline::DecodeInto(const std::vector<uint8_t>& data, std::vector<uint8_t>& out, bool xor_into) {
+    if (data.size() < 4) return false;
+    size_t size = data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<size_t>(data[3]) << 24);
+    if (xor_into) {
+        if (out.size() != size) return false;
+    } else {
+        out.assign(size, 0);
+    }
+
+    size_t i = 0;
+    size_t in = 4;
+    while (in < data.size()) {
+        uint8_t token = data[in++];
+        size_t count = (token & 0x7F) + 1u;
+        if (i + count > size) return false;
+        if (token & 0x80) {
+            i += count;   // Zeros: already there, or XOR with nothing
+            continue;
+        }
+        if (in + count > data.size()) return false;
+        for (size_t k = 0; k < count; k++) {
+            out[i + k] = xor_into ? out[i + k] ^ data[in + k] : data[in + k];
+        }
+        i += count;
+        in += count;
+    }
+    return i == size;
+}
+
+// === Files ===
+
+bool Timeline::Save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to write timeline: " << path << "\n";
+        return false;
+    }
+
+    auto write32 = [&file](uint32_t value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    file.write(TIMELINE_MAGIC, sizeof(TIMELINE_MAGIC));
+    write32(TIMELINE_VERSION);
+    write32(min_spacing);
+    write32(spacing);
+    write32(GetLength());
+    write32(static_cast<uint32_t>(keyframes.size()));
+    file.write(reinterpret_cast<const char*>(inputs.data()), static_cast<std::streamsize>(inputs.size()));
+    for (const Keyframe& keyframe : keyframes) {
+        write32(keyframe.frame);
+        write32(keyframe.base);
+        write32(static_cast<uint32_t>(keyframe.data.size()));
+        file.write(reinterpret_cast<const char*>(keyframe.data.data()), static_cast<std::streamsize>(keyframe.data.size()));
+    }
+    return static_cast<bool>(file);
+}
+
+bool Timeline::Load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open timeline: " << path << "\n";
+        return false;
+    }
+
+    auto read32 = [&file] {
+        uint32_t value = 0;
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    };
+    char magic[4] = {};
+    file.read(magic, sizeof(magic));
+    uint32_t version = read32();
+    uint32_t file_min_spacing = read32();
+    uint32_t file_spacing = read32();
+    uint32_t length = read32();
+    uint32_t count = read32();
+    if (!file || std::memcmp(magic, TIMELINE_MAGIC, sizeof(magic)) != 0 || version != TIMELINE_VERSION ||
+        file_spacing == 0 || count == 0) {
+        std::cerr << "Not a gb-emu3 v" << TIMELINE_VERSION << " timeline: " << path << "\n";
+        return false;
+    }
+
+    std::vector<uint8_t> loaded_inputs(length);
+    file.read(reinterpret_cast<char*>(loaded_inputs.data()), static_cast<std::streamsize>(length));
+    std::vector<Keyframe> loaded(count);
+    size_t bytes = 0;
+    for (Keyframe& keyframe : loaded) {
+        keyframe.frame = read32();
+        keyframe.base = read32();
+        keyframe.data.resize(read32());
+        file.read(reinterpret_cast<char*>(keyframe.data.data()), static_cast<std::streamsize>(keyframe.data.size()));
+        bytes += keyframe.data.size();
+    }
+    if (!file) {
+        std::cerr << "Timeline is truncated: " << path << "\n";
+        return false;
+    }
+
+    // Ascending from frame 0, each XORed keyframe against an earlier whole one
+    bool valid = loaded[0].frame == 0 && loaded[0].base == 0;
+    for (size_t i = 1; i < loaded.size() && valid; i++) {
+        const Keyframe& keyframe = loaded[i];
+        valid = keyframe.frame > loaded[i - 1].frame && keyframe.frame <= length;
+        if (valid && keyframe.base != keyframe.frame) {
+            auto base = std::find_if(loaded.begin(), loaded.begin() + static_cast<std::ptrdiff_t>(i),
+                                     [&](const Keyframe& other) { return other.frame == keyframe.base; });
+            valid = base != loaded.begin() + static_cast<std::ptrdiff_t>(i) && base->base == base->frame;
+        }
+    }
+    if (!valid) {
+        std::cerr << "Timeline keyframes are inconsistent: " << path << "\n";
+        return false;
+    }
+
+    inputs = std::move(loaded_inputs);
+    keyframes = std::move(loaded);
+    keyframe_bytes = bytes;
+    min_spacing = file_min_spacing ? file_min_spacing : 1;
+    spacing = file_spacing;
+    position = 0;
+    return true;
+}
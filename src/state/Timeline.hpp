@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class Emulator;
+
+/**
+ * Timeline - Seekable Session Recording
+ *
+ * A session is one button mask per frame plus whole-machine keyframes
+ * (Emulator::SaveState) every `spacing` frames. Seek(frame) loads the
+ * nearest keyframe at or before it and re-runs the logged inputs from
+ * there, so any frame is at most spacing - 1 frames of emulation away.
+ *
+ * Frames are numbered from Start(): frame N's input is applied at the
+ * boundary after N frames have run, and keyframe N is the state at that
+ * boundary before the input. Running a frame with a different input than
+ * the log has at the current position cuts the log there (a new branch);
+ * the same input just moves along it.
+ *
+ * Memory budget:
+ * - Keyframes are stored as zero/literal byte runs, XORed against the
+ *   keyframe that starts their group of BASE_INTERVAL (stored whole).
+ *   Nearby states differ in a few hundred bytes to a few KB out of ~40 KB,
+ *   so most keyframes shrink to a fraction of a state. Seeking decodes at
+ *   most two keyframes.
+ * - When keyframes outgrow the budget, the spacing doubles and every
+ *   other keyframe is dropped; a group's base outlives its members.
+ *
+ * Replayed frames run through Emulator::RunFrame with the emulator's
+ * outputs as they are: disconnect the audio buffer around Seek() (frame
+ * hooks still run). Keyframes are save states, so a timeline file only
+ * loads into the same build with the same ROM.
+ *
+ * Verify() replays the whole log as independent keyframe-to-keyframe
+ * segments spread over worker threads, each on its own Emulator: a
+ * segment starts from its keyframe and must end on exactly the next one.
+ * An hour of play is a few thousand segments, so it scales with cores.
+ */
+class Timeline {
+public:
+    static constexpr uint32_t DEFAULT_SPACING = 60;           // 1 s
+    static constexpr size_t DEFAULT_BUDGET = 32 * 1024 * 1024;
+    static constexpr uint32_t BASE_INTERVAL = 16;             // Keyframes per stored-whole base
+
+    // Start recording at the emulator's current state (frame 0)
+    bool Start(Emulator& emu);
+    void Clear();
+
+    // Run one frame with `buttons` (bit n = Emulator::SetButton n) at the
+    // current position, logging it and taking keyframes as due
+    void RunFrame(Emulator& emu, uint8_t buttons);
+
+    // Put the emulator at `frame` (0-GetLength()); false if the keyframe
+    // doesn't load (another ROM or build)
+    bool Seek(Emulator& emu, uint32_t frame);
+
+    // Drop everything after the current position
+    void Truncate();
+
+    uint32_t GetPosition() const { return position; }
+    uint32_t GetLength() const { return static_cast<uint32_t>(inputs.size()); }
+    uint8_t GetInput(uint32_t frame) const { return frame < inputs.size() ? inputs[frame] : 0; }
+    bool IsEmpty() const { return keyframes.empty(); }
+
+    // Smallest spacing; the budget may double it. Applies from Start().
+    void SetSpacing(uint32_t frames) { min_spacing = frames ? frames : 1; }
+    // Inputs and encoded keyframes stay under this (once spacing allows)
+    void SetMemoryBudget(size_t bytes);
+    uint32_t GetSpacing() const { return spacing; }
+    size_t GetKeyframeCount() const { return keyframes.size(); }
+    size_t GetMemoryUsed() const { return keyframe_bytes + inputs.size(); }
+
+    struct VerifyReport {
+        uint32_t segments = 0;
+        uint32_t mismatches = 0;            // Segments not ending on the next keyframe
+        uint32_t first_mismatch = 0;        // Start frame of the earliest one
+        uint64_t final_hash = 0;            // FNV-1a of the state at GetLength()
+    };
+
+    // `load_rom` prepares each worker's Emulator (ROM, boot ROM); false
+    // if it fails or a keyframe doesn't load. threads = 0: one per core.
+    bool Verify(const std::function<bool(Emulator&)>& load_rom, unsigned threads, VerifyReport& report) const;
+
+    // Binary file: header, input log, encoded keyframes
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+private:
+    struct Keyframe {
+        uint32_t frame;
+        uint32_t base;                  // Frame of the keyframe it's XORed against; `frame` = stored whole
+        std::vector<uint8_t> data;      // Encoded (see Encode)
+    };
+
+    std::vector<uint8_t> inputs;
+    std::vector<Keyframe> keyframes;    // Ascending frame
+    size_t keyframe_bytes = 0;
+    uint32_t position = 0;
+    uint32_t min_spacing = DEFAULT_SPACING;
+    uint32_t spacing = DEFAULT_SPACING;
+    size_t budget = DEFAULT_BUDGET;
+
+    // Scratch buffers, reused across keyframes and seeks
+    std::vector<uint8_t> state;
+    std::vector<uint8_t> base_state;
+    std::vector<uint8_t> encoded;
+
+    void AddKeyframe(Emulator& emu);
+    void EnforceBudget();
+    size_t FindKeyframe(uint32_t frame) const;
+    bool Decode(size_t index, std::vector<uint8_t>& out) const;
+
+    // Zero runs and literals; `reference` (same size, or null) is XORed in
+    static void Encode(const std::vector<uint8_t>& data, const std::vector<uint8_t>* reference,
+                       std::vector<uint8_t>& out);
+    static bool DecodeInto(const std::vector<uint8_t>& data, std::vector<uint8_t>& out, bool xor_into);
+};
@@ -1,4 +1,5 @@
 #include "Timer.hpp"
+#include "../state/StateBuffer.hpp"
 
 Timer::Timer() {
     Reset();
@@ -137,3 +138,18 @@ void Timer::WriteRegister(uint16_t addr, uint8_t value) {
     }
 }
 
+// === Save State ===
+
+template <typename Self, typename Archive>
+void Timer::Serialize(Self& self, Archive& archive) {
+    archive(self.div_counter, self.tima, self.tma, self.tac, self.tima_reload_state);
+    archive(self.interrupt_requested, self.div_bit12_fell);
+}
+
+void Timer::SaveState(StateWriter& state) const {
+    Serialize(*this, state);
+}
+
+void Timer::LoadState(StateReader& state) {
+    Serialize(*this, state);
+}
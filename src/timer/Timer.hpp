@@ -1,6 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include "../host/ArenaAllocated.hpp"
+
+class StateWriter;
+class StateReader;
 
 /**
  * Timer - DIV and TIMA Timer Hardware
@@ -21,7 +25,7 @@
  * - Interrupt output signal
  * - DIV bit 12 output (for APU frame sequencer at 512 Hz)
  */
-class Timer {
+class Timer : public ArenaAllocated {
 public:
     Timer();
     
@@ -46,6 +50,10 @@ public:
     // Full DIV counter for precise timing queries
     uint16_t GetDIVCounter() const { return div_counter; }
     
+    // === Save State (see StateBuffer.hpp) ===
+    void SaveState(StateWriter& state) const;
+    void LoadState(StateReader& state);
+    
 private:
     // === TIMA Reload State Machine (per SameBoy) ===
     enum TimaReloadState {
@@ -96,4 +104,7 @@ private:
         };
         return BIT_SELECT[tac_value & 0x03];
     }
+    
+    template <typename Self, typename Archive>
+    static void Serialize(Self& self, Archive& archive);
 };
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Hash - 64-bit FNV-1a
+ *
+ * The one hash behind screen verdicts, lockstep comparison, hang
+ * detection, lane convergence and timeline checks. Values are printed
+ * and passed back on the command line (--pass-hash, --fail-hash), so
+ * the function must not change - including the offset basis, which is
+ * one digit short of the published 14695981039346656037.
+ *
+ * Header-only: standalone tools (gb-shm-reader) use it without linking
+ * the core.
+ */
+
+static constexpr uint64_t FNV_OFFSET_BASIS = 1469598103934665603ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+// Folds one more byte into a running hash (start from FNV_OFFSET_BASIS)
+inline uint64_t HashByte(uint64_t hash, uint8_t byte) {
+    return (hash ^ byte) * FNV_PRIME;
+}
+
+inline uint64_t HashBytes(const uint8_t* data, size_t size) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; i++) hash = HashByte(hash, data[i]);
+    return hash;
+}
+
+inline uint64_t HashBytes(const std::vector<uint8_t>& bytes) {
+    return HashBytes(bytes.data(), bytes.size());
+}
+
+// The 160x144 color indices from Emulator::GetFramebuffer()
+inline uint64_t HashFramebuffer(const uint8_t* framebuffer) {
+    return HashBytes(framebuffer, 160 * 144);
+}
@@ -0,0 +1,125 @@
+/**
+ * test_result_monitor - Blargg RAM protocol cases for TestResultMonitor
+ *
+ * Each case assembles a small MBC1+RAM ROM that speaks the protocol
+ * (signature, $80 while running, then a final status) and runs it under
+ * the monitor. Covers a plain pass, an error code, a $81 reset request
+ * that passes after the reset, and a ROM that asks for reset forever.
+ *
+ * Usage: test-result-monitor (exit code 0 = all cases passed)
+ */
+
+#include "Emulator.hpp"
+#include "debug/TestResultMonitor.hpp"
+#include "sm83_assembler.hpp"
+#include <cstdio>
+#include <string>
+
+// Statuses are written once per boot; the restarted ROM reads the boot
+// count it keeps at $A010 to pick the next one. Each status is held for
+// a few frames, since the monitor only looks at frame boundaries.
+static std::string BlarggSource(int first_status, int later_status) {
+    return R"(
+    org $100
+    nop
+    jp Start
+
+    org $150
+Start:
+    ld sp, $E000
+    ld a, $0A                   ; Enable cartridge RAM
+    ld [$0000], a
+    ld a, $80
+    ld [$A000], a
+    ld a, $DE
+    ld [$A001], a
+    ld a, $B0
+    ld [$A002], a
+    ld a, $61
+    ld [$A003], a
+    call Wait
+    ld hl, $A010
+    ld a, [hl]
+    inc a
+    ld [hl], a
+    cp 1
+    ld a, )" + std::to_string(first_status) + R"(
+    jr z, .report
+    ld a, )" + std::to_string(later_status) + R"(
+.report:
+    ld hl, $A004                ; "Done" text
+    ld [hl], 'D'
+    inc hl
+    ld [hl], 'o'
+    inc hl
+    ld [hl], 'n'
+    inc hl
+    ld [hl], 'e'
+    inc hl
+    ld [hl], 0
+    ld [$A000], a
+.idle:
+    jr .idle
+
+; About 3 frames
+Wait:
+    ld bc, 0
+.loop:
+    dec bc
+    ld a, b
+    or c
+    jr nz, .loop
+    ret
+)";
+}
+
+struct Case {
+    const char* name;
+    int first_status;
+    int later_status;
+    TestResultMonitor::Verdict verdict;
+    uint32_t resets;
+};
+
+static bool RunCase(const Case& test) {
+    SM83Assembler assembler;
+    if (!assembler.Assemble(BlarggSource(test.first_status, test.later_status), test.name)) return false;
+    SM83Assembler::Header header;
+    header.title = "MONITOR TEST";
+    header.cartridge_type = 0x02;   // MBC1+RAM, no battery file
+    header.ram_size = 0x02;         // 8 KB
+    std::string path = std::string("test_result_monitor_") + test.name + ".gb";
+    if (!assembler.WriteROM(path, header)) return false;
+
+    Emulator emu;
+    if (!emu.LoadROM(path)) return false;
+    emu.Reset();
+    TestResultMonitor monitor(emu);
+    for (int frame = 0; frame < 600 && !monitor.HasResult(); frame++) {
+        emu.RunFrame();
+        monitor.Check();
+    }
+    std::remove(path.c_str());
+
+    const TestResultMonitor::Result& result = monitor.GetResult();
+    bool ok = result.verdict == test.verdict && monitor.GetResetCount() == test.resets;
+    std::printf("%-14s %s (verdict %d, %u resets; %s)\n", test.name, ok ? "ok" : "FAILED",
+                static_cast<int>(result.verdict), monitor.GetResetCount(), result.detail.c_str());
+    return ok;
+}
+
+int main() {
+    using Verdict = TestResultMonitor::Verdict;
+    const Case cases[] = {
+        { "pass",          0x00, 0x00, Verdict::PASSED, 0 },
+        { "error_code",    0x03, 0x03, Verdict::FAILED, 0 },
+        { "reset_pass",    0x81, 0x00, Verdict::PASSED, 1 },
+        { "reset_forever", 0x81, 0x81, Verdict::FAILED, 9 },
+    };
+
+    int failures = 0;
+    for (const Case& test : cases) {
+        if (!RunCase(test)) failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,255 @@
+/**
+ * alloc_check - Heap Allocations per Emulated Frame
+ *
+ * Replaces the global operator new/delete with counting versions, warms
+ * each scenario up (first-use growth, lazily created buffers), then runs
+ * more frames and fails (exit code 1) if any of them allocated. Threads
+ * count too, so the APU synthesis worker is covered.
+ *
+ * Scenarios: plain RunFrame with changing input; audio on the synthesis
+ * worker drained every frame; tile map cache; frame/write/exec hooks;
+ * save state into a reused buffer; the headless test loop (result monitor,
+ * hang watchdog, serial text). --frontend adds the SDL window (FPS overlay
+ * and notifications), which needs a video driver (SDL_VIDEODRIVER=dummy
+ * works); the null audio sink is used.
+ *
+ * --trace prints a backtrace for every allocation in a checked frame.
+ *
+ * Usage: gb-alloc-check <rom> [--frames N] [--warmup N] [--frontend] [--trace]
+ */
+
+#include "Emulator.hpp"
+#include "apu/AudioBuffer.hpp"
+#include "debug/HangWatchdog.hpp"
+#include "debug/TestResultMonitor.hpp"
+#ifdef GB_ALLOC_CHECK_FRONTEND
+#include "frontend/Window.hpp"
+#endif
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+#include <execinfo.h>
+#include <unistd.h>
+
+// === Counting Allocator ===
+
+static std::atomic<uint64_t> allocation_count{0};
+static std::atomic<bool> trace_allocations{false};
+static thread_local bool in_trace = false;
+
+static void* CountedAllocate(std::size_t size, std::size_t alignment) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (trace_allocations.load(std::memory_order_relaxed) && !in_trace) {
+        // backtrace_symbols_fd writes straight to the fd without allocating
+        in_trace = true;
+        void* frames[24];
+        int depth = backtrace(frames, 24);
+        std::fprintf(stderr, "allocation of %zu bytes:\n", size);
+        backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+        in_trace = false;
+    }
+    if (size == 0) size = 1;
+    void* block = alignment > alignof(std::max_align_t)
+                      ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                      : std::malloc(size);
+    return block;
+}
+
+void* operator new(std::size_t size) {
+    if (void* block = CountedAllocate(size, 0)) return block;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* block = CountedAllocate(size, 0)) return block;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* block = CountedAllocate(size, static_cast<std::size_t>(alignment))) return block;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (void* block = CountedAllocate(size, static_cast<std::size_t>(alignment))) return block;
+    throw std::bad_alloc();
+}
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+void operator delete(void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+
+// === Scenarios ===
+
+struct Options {
+    std::string rom_path;
+    uint32_t frames = 600;
+    uint32_t warmup = 120;
+    bool trace = false;
+};
+
+// Setup, per-frame work and teardown of one scenario, run on a fresh Emulator
+struct Scenario {
+    const char* name;
+    std::function<void(Emulator&)> setup;
+    std::function<void(Emulator&, uint32_t frame)> frame;
+    std::function<void()> teardown;   // Before the Emulator goes away
+};
+
+// Presses change every 16 frames, so the joypad paths stay busy
+static void PressButtons(Emulator& emu, uint32_t frame) {
+    uint8_t buttons = static_cast<uint8_t>((frame / 16) * 0x9D);
+    for (uint8_t button = 0; button < 8; button++) {
+        emu.SetButton(button, (buttons >> button) & 1);
+    }
+}
+
+static bool RunScenario(const Options& options, const Scenario& scenario) {
+    Emulator emu;
+    if (!emu.LoadROM(options.rom_path)) return false;
+    emu.Reset();
+    if (scenario.setup) scenario.setup(emu);
+
+    uint32_t frame = 0;
+    for (; frame < options.warmup; frame++) {
+        PressButtons(emu, frame);
+        emu.RunFrame();
+        if (scenario.frame) scenario.frame(emu, frame);
+    }
+
+    uint64_t before = allocation_count.load();
+    trace_allocations = options.trace;
+    uint32_t dirty_frames = 0;
+    for (uint32_t end = frame + options.frames; frame < end; frame++) {
+        uint64_t start = allocation_count.load();
+        PressButtons(emu, frame);
+        emu.RunFrame();
+        if (scenario.frame) scenario.frame(emu, frame);
+        if (allocation_count.load() != start) dirty_frames++;
+    }
+    trace_allocations = false;
+    uint64_t allocations = allocation_count.load() - before;
+    if (scenario.teardown) scenario.teardown();
+
+    std::printf("  %-14s %8llu allocations in %u frames (%u frames allocated)%s\n", scenario.name,
+                static_cast<unsigned long long>(allocations), options.frames, dirty_frames,
+                allocations ? "  FAIL" : "");
+    return allocations == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <rom> [--frames N] [--warmup N] [--frontend] [--trace]\n", argv[0]);
+        return 2;
+    }
+
+    Options options;
+    options.rom_path = argv[1];
+    bool frontend = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) options.frames = std::atoi(argv[++i]);
+        else if (arg == "--warmup" && i + 1 < argc) options.warmup = std::atoi(argv[++i]);
+        else if (arg == "--frontend") frontend = true;
+        else if (arg == "--trace") options.trace = true;
+    }
+
+    // Pull in the unwinder now; its first use allocates
+    void* probe[1];
+    backtrace(probe, 1);
+
+    AudioBuffer audio;
+    float block[1024 * 2];
+    std::vector<uint8_t> map_image(256 * 256);
+    std::vector<uint8_t> state;
+    std::unique_ptr<TestResultMonitor> monitor;
+    std::unique_ptr<HangWatchdog> watchdog;
+    uint32_t hook_calls = 0;
+
+    std::vector<Scenario> scenarios = {
+        { "core", nullptr, nullptr, nullptr },
+        { "audio worker",
+          [&](Emulator& emu) { emu.ConnectAudioBuffer(&audio); },
+          [&](Emulator& emu, uint32_t) {
+              emu.SyncAudio();
+              while (audio.Read(block, 1024)) {}
+          },
+          nullptr },
+        { "map viewer",
+          [](Emulator& emu) { emu.SetTileMapCacheEnabled(true); },
+          [&](Emulator& emu, uint32_t) { emu.GetTileMapImage(0, true, map_image.data()); },
+          nullptr },
+        { "hooks",
+          [&](Emulator& emu) {
+              emu.AddFrameHook([&] { hook_calls++; });
+              emu.AddWriteHook(0xC000, 0xDFFF, [&](uint16_t, uint8_t) { hook_calls++; });
+              emu.AddExecHook(0x0040, [&](uint16_t) { hook_calls++; });
+          },
+          nullptr, nullptr },
+        { "save state",
+          nullptr,
+          [&](Emulator& emu, uint32_t) { emu.SaveState(state); },
+          nullptr },
+        { "headless",
+          [&](Emulator& emu) {
+              monitor = std::make_unique<TestResultMonitor>(emu);
+              watchdog = std::make_unique<HangWatchdog>(0);
+          },
+          [&](Emulator& emu, uint32_t) {
+              monitor->Check();
+              watchdog->Poll(emu);
+          },
+          [&] {
+              monitor.reset();
+              watchdog.reset();
+          } },
+    };
+
+#ifdef GB_ALLOC_CHECK_FRONTEND
+    std::unique_ptr<Window> window;
+    if (frontend) {
+        scenarios.push_back({ "frontend",
+            [&](Emulator& emu) {
+                window = std::make_unique<Window>();
+                if (!window->Init("gb-alloc-check", 1)) {
+                    std::fprintf(stderr, "Window init failed (try SDL_VIDEODRIVER=dummy)\n");
+                    std::exit(2);
+                }
+                if (window->InitAudio(&audio, "null")) emu.ConnectAudioBuffer(&audio);
+                window->ToggleFPS();
+            },
+            [&](Emulator& emu, uint32_t frame) {
+                window->ProcessEvents();
+                window->RenderFrame(emu.GetFramebuffer());
+                if (frame % 30 == 0) window->AdjustVolume(frame % 60 ? 0.1f : -0.1f);
+                if (frame % 45 == 0) window->ShowNotification("NOTIFICATION");
+            },
+            [&] {
+                window->CloseAudio();
+                window.reset();
+            } });
+    }
+#else
+    if (frontend) {
+        std::fprintf(stderr, "Built without the SDL frontend\n");
+        return 2;
+    }
+#endif
+
+    std::printf("Heap allocations after %u warmup frames:\n", options.warmup);
+    bool clean = true;
+    for (const Scenario& scenario : scenarios) {
+        if (!RunScenario(options, scenario)) clean = false;
+    }
+    std::printf(clean ? "Steady state is allocation-free\n" : "Steady state allocates\n");
+    return clean ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/**
+ * automation_client - Example client for gb-emu3 --automation
+ *
+ * Drives an instance the way an agent loop would: every step is one batch
+ * (buttons, run K frames, read a RAM range, grab the screen) and one round
+ * trip. Prints round-trip latency and emulated frames per second. Needs
+ * AutomationProtocol.hpp (and ObservationEncoder for --observe spec
+ * parsing); doesn't link against the emulator.
+ *
+ * Usage: gb-auto-client <socket> [--steps N] [--frames K] [--read addr:len]
+ *                       [--observe spec] [--pgm out.pgm] [--verify] [--quit]
+ *
+ * --observe fetches GET_OBSERVATION (e.g. "packed" or "gray,down=2,stack=4")
+ * instead of the raw framebuffer; --pgm then only applies without it.
+ * --verify saves slot 0 first, replays the same button sequence from it
+ * and exits non-zero if any step's RAM or screen differs.
+ * --quit stops the instance afterwards.
+ */
+
+#include "automation/AutomationProtocol.hpp"
+#include "export/ObservationEncoder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using Protocol = AutomationProtocol;
+
+static void Append(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+static uint32_t Read32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static bool SendAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(fd, data, size, 0);
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+static bool ReceiveAll(int fd, uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t received = recv(fd, data, size, 0);
+        if (received <= 0) return false;
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+// One batch, one round trip. `payloads` receives everything after the
+// response header; false on a broken connection or a failed command.
+static bool Exchange(int fd, const std::vector<uint8_t>& commands, std::vector<uint8_t>& payloads) {
+    std::vector<uint8_t> request;
+    Append(request, commands.size(), 4);
+    request.insert(request.end(), commands.begin(), commands.end());
+    if (!SendAll(fd, request.data(), request.size())) return false;
+
+    uint8_t header[9];
+    if (!ReceiveAll(fd, header, sizeof(header))) return false;
+    payloads.resize(Read32(header) - 5);
+    if (!ReceiveAll(fd, payloads.data(), payloads.size())) return false;
+
+    if (header[8] != Protocol::OK) {
+        std::fprintf(stderr, "Command %u failed with status %u\n", Read32(header + 4), header[8]);
+        return false;
+    }
+    return true;
+}
+
+static void WritePGM(const std::string& path, const uint8_t* pixels) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return;
+    std::fprintf(f, "P5\n160 144\n255\n");
+    for (uint32_t i = 0; i < Protocol::FRAME_BYTES; i++) {
+        std::fputc(255 - (pixels[i] & 3) * 85, f);
+    }
+    std::fclose(f);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <socket> [--steps N] [--frames K] [--read addr:len] "
+                             "[--observe spec] [--pgm out.pgm] [--verify] [--quit]\n", argv[0]);
+        return 1;
+    }
+
+    std::string path = argv[1];
+    uint32_t steps = 1000;
+    uint32_t frames = 4;
+    uint32_t read_addr = 0xC000;
+    uint32_t read_length = 256;
+    std::string pgm_path;
+    bool observe = false;
+    ObservationEncoder::Config observation;
+    bool verify = false;
+    bool quit = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--steps" && i + 1 < argc) steps = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--frames" && i + 1 < argc) frames = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--read" && i + 1 < argc) {
+            std::string range = argv[++i];
+            read_addr = static_cast<uint32_t>(std::strtoul(range.c_str(), nullptr, 16));
+            size_t colon = range.find(':');
+            if (colon != std::string::npos) read_length = static_cast<uint32_t>(std::atoi(range.c_str() + colon + 1));
+        }
+        else if (arg == "--observe" && i + 1 < argc) {
+            if (!ObservationEncoder::ParseSpec(argv[++i], observation)) {
+                std::fprintf(stderr, "Bad observation spec: %s\n", argv[i]);
+                return 1;
+            }
+            observe = true;
+        }
+        else if (arg == "--pgm" && i + 1 < argc) pgm_path = argv[++i];
+        else if (arg == "--verify") verify = true;
+        else if (arg == "--quit") quit = true;
+    }
+    if (read_addr + read_length > 0x10000) read_length = 0x10000 - read_addr;
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::perror(("connect " + path).c_str());
+        return 1;
+    }
+
+    std::vector<uint8_t> commands;
+    std::vector<uint8_t> payloads;
+    if (verify) {
+        commands = { Protocol::SAVE_SLOT, 0 };
+        if (!Exchange(fd, commands, payloads)) return 1;
+    }
+
+    // Also restarts the frame stack, so a verify replay sees the same stacks
+    auto configure_observation = [&] {
+        commands = { Protocol::SET_OBSERVATION, static_cast<uint8_t>(observation.format),
+                     observation.crop_x, observation.crop_y, observation.crop_width, observation.crop_height,
+                     observation.downsample, observation.stack };
+        return Exchange(fd, commands, payloads);
+    };
+    if (observe && !configure_observation()) return 1;
+
+    // Buttons change every step; the sequence only depends on the step number
+    auto step_batch = [&](uint32_t step) {
+        commands.clear();
+        commands.push_back(Protocol::SET_BUTTONS);
+        commands.push_back(static_cast<uint8_t>((step / 8) * 0x9D));
+        commands.push_back(Protocol::RUN_FRAMES);
+        Append(commands, frames, 4);
+        commands.push_back(Protocol::READ_MEMORY);
+        Append(commands, read_addr, 2);
+        Append(commands, read_length, 2);
+        commands.push_back(observe ? Protocol::GET_OBSERVATION : Protocol::GET_FRAMEBUFFER);
+    };
+
+    std::vector<std::vector<uint8_t>> recorded;
+    std::vector<double> latencies;
+    latencies.reserve(steps);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t step = 0; step < steps; step++) {
+        step_batch(step);
+        auto sent = std::chrono::steady_clock::now();
+        if (!Exchange(fd, commands, payloads)) return 1;
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+        if (verify) recorded.push_back(payloads);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    if (!latencies.empty()) {
+        std::printf("%u steps of %u frames: %.0f frames/s, round trip median %.0f us, p99 %.0f us, "
+                    "%zu bytes/step\n",
+                    steps, frames, steps * frames / std::max(seconds, 1e-9),
+                    latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], payloads.size());
+    }
+    if (!pgm_path.empty() && !observe && payloads.size() >= Protocol::FRAME_BYTES) {
+        WritePGM(pgm_path, payloads.data() + payloads.size() - Protocol::FRAME_BYTES);
+    }
+
+    int result = 0;
+    if (verify) {
+        commands = { Protocol::LOAD_SLOT, 0 };
+        if (!Exchange(fd, commands, payloads)) return 1;
+        if (observe && !configure_observation()) return 1;
+        for (uint32_t step = 0; step < steps; step++) {
+            step_batch(step);
+            if (!Exchange(fd, commands, payloads)) return 1;
+            if (payloads != recorded[step]) {
+                std::printf("Replay diverged at step %u\n", step);
+                result = 1;
+                break;
+            }
+        }
+        if (result == 0) std::printf("Replay from slot 0 matched all %u steps\n", steps);
+    }
+
+    if (quit) {
+        commands = { Protocol::QUIT };
+        Exchange(fd, commands, payloads);
+    }
+    close(fd);
+    return result;
+}
@@ -0,0 +1,1075 @@
+/**
+ * bench_roms - Generate the synthetic benchmark ROMs
+ *
+ * Commercial ROMs can't ship with the repository, so benchmarks and
+ * profiling runs use these instead. Each workload is SM83 source built by
+ * SM83Assembler into a ROM with a valid header; generation is
+ * deterministic, so the same build always writes the same bytes.
+ *
+ * Workloads (each runs forever and keeps the screen moving, so the hang
+ * watchdog leaves them alone):
+ *   alu      8/16-bit ALU and CB-prefixed chains over a WRAM buffer
+ *   memcpy   WRAM block copies (byte, unrolled, pop-based), OAM DMA and
+ *            VRAM copies every VBlank
+ *   raster   LYC interrupt on every visible line, rewriting SCX/SCY/WX/BGP
+ *            in HBlank
+ *   sprites  40 8x16 sprites, 10 per line, moved and re-animated through
+ *            OAM DMA each frame, window on
+ *   sound    ~1 kHz timer-driven sound driver: arpeggios on both pulse
+ *            channels, wave RAM rewrites, noise retriggers, panning
+ *   banks    ROM/RAM bank-switch storm, one ROM per MBC type
+ *            (banks_mbc1.gb, banks_mbc2.gb, banks_mbc3.gb, banks_mbc5.gb)
+ *   halt     Idle in HALT, woken by VBlank only
+ *
+ * Usage: gb-bench-roms <out_dir> [--workload name] [--mbc type] [--banks N]
+ *                                [--asm] [--list]
+ *
+ * --workload builds one workload (default: all). --mbc (none, mbc1, mbc2,
+ * mbc3, mbc5) sets the cartridge for the non-bank workloads, or limits
+ * banks to one MBC; --banks sets the ROM size of the bank workload.
+ * --asm also writes each ROM's source next to it.
+ */
+
+#include "sm83_assembler.hpp"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Mbc {
+    const char* name;
+    uint8_t cartridge_type;
+    uint8_t ram_size;           // Header code; MBC2's 512x4 bits are built in
+    uint32_t banks;             // Default ROM banks for the bank workload
+    uint32_t max_banks;
+    bool has_ram;
+};
+
+static const Mbc MBCS[] = {
+    { "none", 0x00, 0x00,   2,   2, false },
+    { "mbc1", 0x02, 0x03,  32,  32, true },    // MBC1+RAM, 32 KB; 5-bit bank register only
+    { "mbc2", 0x05, 0x00,  16,  16, true },
+    { "mbc3", 0x12, 0x03,  64, 128, true },    // MBC3+RAM, 32 KB
+    { "mbc5", 0x1A, 0x04, 256, 512, true },    // MBC5+RAM, 128 KB
+};
+
+struct Options {
+    const Mbc* mbc = &MBCS[0];
+    uint32_t banks = 0;         // 0 = the MBC's default
+};
+
+// === Common Source ===
+
+// Hardware registers, the interrupt vectors and entry point, and start-up
+// shared by every workload: LCD off, tiles and both tile maps filled with
+// a procedural pattern, OAM and WRAM ($C000-$DEFF) cleared, palettes set. Workloads
+// define Setup (jumped to with the LCD off and interrupts disabled),
+// VBlank, Stat and Timer.
+static const char* COMMON_SOURCE = R"(
+rP1     equ $00
+rDIV    equ $04
+rTIMA   equ $05
+rTMA    equ $06
+rTAC    equ $07
+rIF     equ $0F
+rNR10   equ $10
+rNR11   equ $11
+rNR12   equ $12
+rNR13   equ $13
+rNR14   equ $14
+rNR21   equ $16
+rNR22   equ $17
+rNR23   equ $18
+rNR24   equ $19
+rNR30   equ $1A
+rNR31   equ $1B
+rNR32   equ $1C
+rNR33   equ $1D
+rNR34   equ $1E
+rNR41   equ $20
+rNR42   equ $21
+rNR43   equ $22
+rNR44   equ $23
+rNR50   equ $24
+rNR51   equ $25
+rNR52   equ $26
+rLCDC   equ $40
+rSTAT   equ $41
+rSCY    equ $42
+rSCX    equ $43
+rLY     equ $44
+rLYC    equ $45
+rDMA    equ $46
+rBGP    equ $47
+rOBP0   equ $48
+rOBP1   equ $49
+rWY     equ $4A
+rWX     equ $4B
+rIE     equ $FF
+
+IE_VBLANK equ %00001
+IE_STAT   equ %00010
+IE_TIMER  equ %00100
+
+ShadowOAM equ $C100         ; 160 bytes, page-aligned for OAM DMA
+Vars      equ $C000         ; Workload variables ($C000-$C0FF)
+HramDMA   equ $FF80
+
+    bank 0
+    org $40
+    jp VBlank
+    org $48
+    jp Stat
+    org $50
+    jp Timer
+
+    org $100
+    nop
+    jp Start
+
+    org $150
+Start:
+    di
+    ld sp, $E000
+    call LcdOff
+
+    ld hl, $8000                ; Tiles: 4 KB of shifted/XORed address bits
+.tiles:
+    ld a, l
+    rrca
+    xor l
+    xor h
+    ld [hl+], a
+    ld a, h
+    cp $90
+    jr nz, .tiles
+
+    ld hl, $9800                ; Both maps: diagonal runs of tiles 0-127
+.map:
+    ld a, l
+    add a, h
+    and $7F
+    ld [hl+], a
+    ld a, h
+    cp $A0
+    jr nz, .map
+
+    ld hl, $FE00
+    ld bc, 160
+    xor a
+    call Memset
+    ld hl, $C000                ; All WRAM but the stack page
+    ld bc, $1F00
+    xor a
+    call Memset
+
+    ld a, %11100100
+    ldh [rBGP], a
+    ldh [rOBP0], a
+    ld a, %00011011
+    ldh [rOBP1], a
+    xor a
+    ldh [rSCX], a
+    ldh [rSCY], a
+    ldh [rIF], a
+    jp Setup
+
+; Wait for VBlank and turn the LCD off
+LcdOff:
+    ldh a, [rLCDC]
+    bit 7, a
+    ret z
+.wait:
+    ldh a, [rLY]
+    cp 144
+    jr c, .wait
+    xor a
+    ldh [rLCDC], a
+    ret
+
+; hl = destination, bc = count (> 0), a = value
+Memset:
+    ld d, a
+.loop:
+    ld a, d
+    ld [hl+], a
+    dec bc
+    ld a, b
+    or c
+    jr nz, .loop
+    ret
+
+; hl = source, de = destination, bc = count (> 0)
+Memcpy:
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    dec bc
+    ld a, b
+    or c
+    jr nz, Memcpy
+    ret
+
+; Copy the OAM DMA routine to HRAM; start a transfer with
+; ld a, high(ShadowOAM) / call HramDMA
+InstallDMA:
+    ld hl, DmaRoutine
+    ld de, HramDMA
+    ld bc, DmaRoutineEnd - DmaRoutine
+    jp Memcpy
+
+DmaRoutine:
+    ldh [rDMA], a
+    ld a, 40
+.wait:
+    dec a
+    jr nz, .wait
+    ret
+DmaRoutineEnd:
+)";
+
+// 256-byte triangle wave (0-31, period 64), page-aligned for ld h, high()
+static std::string WaveTable(const char* label) {
+    std::ostringstream out;
+    out << "    org $3F00\n" << label << ":\n";
+    for (int row = 0; row < 16; row++) {
+        out << "    db ";
+        for (int col = 0; col < 16; col++) {
+            int t = (row * 16 + col) & 63;
+            out << (t < 32 ? t : 63 - t) << (col < 15 ? ", " : "\n");
+        }
+    }
+    return out.str();
+}
+
+// === Workloads ===
+
+static std::string AluSource(const Options&) {
+    return R"(
+Checksum equ Vars
+
+Setup:
+    ld a, %10010001             ; LCD on, BG tiles at $8000, BG on
+    ldh [rLCDC], a
+    ld a, IE_VBLANK
+    ldh [rIE], a
+    ei
+    ld de, $1234
+    ld c, $5A
+
+Main:
+    ld hl, $C200
+    ld b, 64
+.loop:
+    ld a, [hl]
+    add a, b
+    adc a, e
+    xor d
+    rlca
+    sub c
+    swap a
+    and $7E
+    or b
+    sbc a, $13
+    cp e
+    jr c, .low
+    rra
+    inc a
+    daa
+.low:
+    srl a
+    ld [hl+], a
+    ld c, a
+    push hl
+    ld h, d
+    ld l, e
+    add hl, bc
+    add hl, hl
+    inc hl
+    ld d, h
+    ld e, l
+    pop hl
+    rl e
+    rr d
+    sla c
+    sra c
+    rlc e
+    rrc d
+    bit 0, a
+    jr z, .even
+    res 3, d
+    set 5, e
+    cpl
+.even:
+    ccf
+    dec b
+    jr nz, .loop
+
+    ld hl, Checksum
+    ld a, [hl]
+    add a, d
+    xor e
+    ld [hl+], a
+    ld a, [hl]
+    adc a, c
+    ld [hl], a
+    jr Main
+
+VBlank:
+    push af
+    ldh a, [rSCX]
+    inc a
+    ldh [rSCX], a
+    ld a, [Checksum]
+    ldh [rSCY], a
+    pop af
+    reti
+
+Stat:
+Timer:
+    reti
+)";
+}
+
+static std::string MemcpySource(const Options&) {
+    return R"(
+Frame   equ Vars
+SavedSP equ Vars + 2
+Source  equ $C200               ; 3.5 KB each way
+Dest    equ $D000
+Size    equ $0E00
+
+Setup:
+    call InstallDMA
+    ld hl, ShadowOAM            ; 40 sprites in an 8x5 grid
+    ld b, 0
+.oam:
+    ld a, b
+    and %11100000
+    rrca
+    add a, 32
+    ld [hl+], a                 ; Y
+    ld a, b
+    and %00011111
+    rlca
+    rlca
+    add a, 8
+    ld [hl+], a                 ; X
+    ld a, b
+    ld [hl+], a                 ; Tile
+    xor a
+    ld [hl+], a                 ; Attributes
+    ld a, b
+    add a, 4
+    ld b, a
+    cp 160
+    jr c, .oam
+
+    ld a, %10010011             ; LCD on, BG tiles at $8000, sprites on, BG on
+    ldh [rLCDC], a
+    ld a, IE_VBLANK
+    ldh [rIE], a
+    ei
+
+Main:
+    ld hl, Source               ; Byte loop
+    ld de, Dest
+    ld bc, Size
+    call Memcpy
+
+    ld hl, Dest                 ; Unrolled, 16 bytes per iteration
+    ld de, Source
+    ld b, Size / 16
+.unrolled:
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    ld a, [hl+]
+    ld [de], a
+    inc de
+    dec b
+    jr nz, .unrolled
+
+    di                          ; Stack copy: pop two bytes at a time
+    ld [SavedSP], sp
+    ld sp, Source
+    ld hl, Dest
+    ld b, 0
+.pop:
+    pop de
+    ld a, e
+    ld [hl+], a
+    ld a, d
+    ld [hl+], a
+    dec b
+    jr nz, .pop
+    ld hl, SavedSP
+    ld a, [hl+]
+    ld h, [hl]
+    ld l, a
+    ld sp, hl
+    ei
+
+    ld hl, Source               ; Stir the source so copies aren't repeats
+    ld a, [Frame]
+    add a, [hl]
+    inc a
+    ld [hl+], a
+    xor [hl]
+    ld [hl], a
+    jp Main
+
+VBlank:
+    push af
+    push bc
+    push de
+    push hl
+    ld a, high(ShadowOAM)
+    call HramDMA
+
+    ld hl, ShadowOAM + 1        ; Slide every sprite right
+    ld b, 40
+.move:
+    inc [hl]
+    inc l
+    inc l
+    inc l
+    inc l
+    dec b
+    jr nz, .move
+
+    ld a, [Frame]               ; 32 bytes of WRAM into a rotating tile row
+    inc a
+    ld [Frame], a
+    and 7
+    swap a
+    add a, a
+    ld e, a
+    ld d, $88
+    ld hl, Dest
+    ld bc, 32
+    call Memcpy
+    pop hl
+    pop de
+    pop bc
+    pop af
+    reti
+
+Stat:
+Timer:
+    reti
+)";
+}
+
+static std::string RasterSource(const Options&) {
+    return R"(
+Phase equ Vars
+
+Setup:
+    ld a, %11110001             ; LCD on, window (map $9C00) on, BG tiles at $8000, BG on
+    ldh [rLCDC], a
+    ld a, 72
+    ldh [rWY], a
+    ld a, 87
+    ldh [rWX], a
+    ld a, %01000000             ; STAT interrupt on LY=LYC
+    ldh [rSTAT], a
+    xor a
+    ldh [rLYC], a
+    ld a, IE_VBLANK | IE_STAT
+    ldh [rIE], a
+    ei
+
+Main:
+    halt
+    nop
+    jr Main
+
+; Every visible line: look up this line's offsets, wait for its HBlank,
+; then rewrite the scroll and window registers (and the palette every
+; 8 lines) and move LYC on to the next line
+Stat:
+    push af
+    push hl
+    ldh a, [rLY]
+    ld hl, Phase
+    add a, [hl]
+    ld l, a
+    ld h, high(Wave)
+    ld l, [hl]
+.hblank:
+    ldh a, [rSTAT]
+    and %11
+    jr nz, .hblank
+    ld a, l
+    ldh [rSCX], a
+    srl a
+    srl a
+    ldh [rSCY], a
+    add a, 47
+    ldh [rWX], a
+    ldh a, [rLY]
+    and 7
+    jr nz, .next
+    ldh a, [rBGP]
+    rlca
+    rlca
+    ldh [rBGP], a
+.next:
+    ldh a, [rLYC]
+    inc a
+    cp 144
+    jr c, .set
+    xor a
+.set:
+    ldh [rLYC], a
+    pop hl
+    pop af
+    reti
+
+VBlank:
+    push hl
+    ld hl, Phase
+    inc [hl]
+    pop hl
+    reti
+
+Timer:
+    reti
+)" + WaveTable("Wave");
+}
+
+static std::string SpritesSource(const Options&) {
+    std::ostringstream out;
+    out << R"(
+Frame equ Vars
+
+Setup:
+    call InstallDMA
+    ld hl, SpriteTable
+    ld de, ShadowOAM
+    ld bc, 160
+    call Memcpy
+
+    ld a, 128                   ; Window over the bottom 16 lines
+    ldh [rWY], a
+    ld a, 7
+    ldh [rWX], a
+    ld a, %11110111             ; LCD on, window (map $9C00) on, BG tiles at $8000, 8x16 sprites on, BG on
+    ldh [rLCDC], a
+    ld a, IE_VBLANK
+    ldh [rIE], a
+    ei
+
+Main:
+    halt
+    nop
+    jr Main
+
+; DMA last frame's positions, then move row r right by r + 1 pixels and
+; step every sprite's tile every 8 frames
+VBlank:
+    push af
+    push bc
+    push de
+    push hl
+    ld a, high(ShadowOAM)
+    call HramDMA
+
+    ld hl, ShadowOAM + 1
+    ld d, 1
+.row:
+    ld e, 10
+.sprite:
+    ld a, [hl]
+    add a, d
+    ld [hl+], a
+    ld a, [Frame]
+    and 7
+    jr nz, .same
+    ld a, [hl]
+    add a, 2
+    ld [hl], a
+.same:
+    inc l
+    inc l
+    inc l
+    dec e
+    jr nz, .sprite
+    inc d
+    ld a, d
+    cp 5
+    jr nz, .row
+
+    ld hl, Frame
+    inc [hl]
+    ldh a, [rSCX]
+    dec a
+    ldh [rSCX], a
+    pop hl
+    pop de
+    pop bc
+    pop af
+    reti
+
+Stat:
+Timer:
+    reti
+
+; 4 rows of 10 on lines 24, 56, 88 and 120; rows alternate flip and
+; palette, the last sprite of each row sits behind the background
+SpriteTable:
+)";
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 10; col++) {
+            int y = 16 + 24 + row * 32;
+            int x = 8 + col * 16 + row * 3;
+            int tile = (row * 20 + col * 2) & 0xFE;
+            int attributes = ((col & 1) << 4) | ((row & 1) << 5) | (col == 9 ? 0x80 : 0);
+            out << "    db " << y << ", " << x << ", " << tile << ", " << attributes << "\n";
+        }
+    }
+    return out.str();
+}
+
+static std::string SoundSource(const Options&) {
+    return R"(
+Tick  equ Vars
+Frame equ Vars + 1
+
+Setup:
+    ld a, $80                   ; APU on, full volume, channels panned unevenly
+    ldh [rNR52], a
+    ld a, $77
+    ldh [rNR50], a
+    ld a, %11101101
+    ldh [rNR51], a
+    ld a, $15                   ; Pulse 1: slow upward sweep, 50% duty, decaying
+    ldh [rNR10], a
+    ld a, $80
+    ldh [rNR11], a
+    ld a, $F3
+    ldh [rNR12], a
+    ld a, $40                   ; Pulse 2: 25% duty
+    ldh [rNR21], a
+    ld a, $C2
+    ldh [rNR22], a
+    ld a, $A1                   ; Noise envelope
+    ldh [rNR42], a
+
+    xor a                       ; Timer: 262144 Hz / 256 = 1024 Hz
+    ldh [rTMA], a
+    ld a, %101
+    ldh [rTAC], a
+    ld a, %10010001             ; LCD on, BG tiles at $8000, BG on
+    ldh [rLCDC], a
+    ld a, IE_VBLANK | IE_TIMER
+    ldh [rIE], a
+    ei
+
+Main:
+    halt
+    nop
+    jr Main
+
+; One driver tick: both pulse channels step through an arpeggio
+; (retriggered every 4 ticks), the wave channel gets new samples every 16,
+; the noise channel a new pattern every 8, and panning rotates every 32
+Timer:
+    push af
+    push bc
+    push hl
+    ld hl, Tick
+    inc [hl]
+    ld c, [hl]
+
+    ld a, c
+    and 15
+    add a, a
+    ld l, a
+    ld h, high(Notes)
+    ld a, [hl+]
+    ldh [rNR13], a
+    ld b, [hl]
+    ld a, c
+    and 3
+    jr nz, .hold1
+    set 7, b
+.hold1:
+    ld a, b
+    ldh [rNR14], a
+
+    ld a, c
+    add a, 7
+    and 15
+    add a, a
+    ld l, a
+    ld a, [hl+]
+    ldh [rNR23], a
+    ld b, [hl]
+    ld a, c
+    and 3
+    jr nz, .hold2
+    set 7, b
+    ld a, c
+    or $80
+    ldh [rNR22], a              ; New envelope with each trigger
+.hold2:
+    ld a, b
+    ldh [rNR24], a
+
+    ld a, c
+    and 15
+    jr nz, .noise
+    xor a                       ; Wave RAM is only written with the DAC off
+    ldh [rNR30], a
+    ld hl, $FF30
+    ld b, 16
+    ld a, c
+.wave:
+    ld [hl+], a
+    add a, $11
+    dec b
+    jr nz, .wave
+    ld a, $80
+    ldh [rNR30], a
+    ld a, $20
+    ldh [rNR32], a
+    ld a, c
+    ldh [rNR33], a
+    ld a, $87
+    ldh [rNR34], a
+
+.noise:
+    ld a, c
+    and 7
+    jr nz, .pan
+    ld a, c
+    ldh [rNR43], a
+    ld a, $80
+    ldh [rNR44], a
+
+.pan:
+    ld a, c
+    and 31
+    jr nz, .done
+    ldh a, [rNR51]
+    rlca
+    ldh [rNR51], a
+.done:
+    pop hl
+    pop bc
+    pop af
+    reti
+
+VBlank:
+    push af
+    ld a, [Frame]               ; Master volume sweeps, never silent
+    inc a
+    ld [Frame], a
+    and $66
+    or $11
+    ldh [rNR50], a
+    ldh a, [rSCX]
+    inc a
+    ldh [rSCX], a
+    pop af
+    reti
+
+Stat:
+    reti
+
+; 16 notes as 11-bit pulse frequencies (two octaves of a major scale)
+    org $3E00
+Notes:
+    dw 1046, 1155, 1253, 1297, 1379, 1452, 1517, 1547
+    dw 1602, 1650, 1694, 1714, 1750, 1783, 1812, 1825
+)";
+}
+
+static std::string HaltSource(const Options&) {
+    return R"(
+Setup:
+    ld a, %10010001             ; LCD on, BG tiles at $8000, BG on
+    ldh [rLCDC], a
+    ld a, IE_VBLANK
+    ldh [rIE], a
+    ei
+
+Main:
+    halt
+    nop
+    jr Main
+
+VBlank:
+    push af
+    ldh a, [rSCX]
+    inc a
+    ldh [rSCX], a
+    pop af
+    reti
+
+Stat:
+Timer:
+    reti
+)";
+}
+
+// Main loop walks every switchable bank: select it, check the signature
+// at $4000, call the routine at $4002, and (with cartridge RAM) switch RAM
+// banks and read-modify-write a byte in each
+static std::string BanksSource(const Options& options) {
+    const Mbc& mbc = *options.mbc;
+    bool mbc1 = std::string(mbc.name) == "mbc1";
+    bool mbc2 = std::string(mbc.name) == "mbc2";
+    bool mbc5 = std::string(mbc.name) == "mbc5";
+    uint32_t ram_banks = mbc.ram_size == 0x03 ? 4 : mbc.ram_size == 0x04 ? 16 : 1;
+
+    std::ostringstream out;
+    out << "\nBANKS     equ " << options.banks << "\n"
+        << "RAM_BANKS equ " << ram_banks << "\n"
+        << R"(Errors    equ Vars
+Sum       equ Vars + 1
+
+Setup:
+)";
+    if (mbc.has_ram) {
+        out << "    ld a, $0A                   ; Enable cartridge RAM\n"
+            << "    ld [$0000], a\n";
+    }
+    if (mbc1) {
+        out << "    ld a, 1                     ; RAM banking mode\n"
+            << "    ld [$6000], a\n";
+    }
+    out << R"(    ld a, %10010001             ; LCD on, BG tiles at $8000, BG on
+    ldh [rLCDC], a
+    ld a, IE_VBLANK
+    ldh [rIE], a
+    ei
+
+Main:
+    ld de, 1
+.bank:
+    ld a, e
+    ld [$2100], a
+)";
+    if (mbc5) {
+        out << "    ld a, d\n"
+            << "    ld [$3100], a\n";
+    }
+    out << R"(    ld a, [$4000]
+    cp e
+    jr z, .checked
+    ld hl, Errors
+    inc [hl]
+.checked:
+    ld a, [Sum]
+    ld c, a
+    call $4002
+    ld a, c
+    ld [Sum], a
+)";
+    if (mbc.has_ram) {
+        if (!mbc2) {
+            out << "    ld a, e\n"
+                << "    and RAM_BANKS - 1\n"
+                << "    ld [$4100], a\n";
+        }
+        out << "    ld h, $A0\n"
+            << "    ld l, e\n";
+        out << "    ld a, [hl]\n"
+            << "    add a, c\n"
+            << "    ld [hl], a\n";
+    }
+    out << R"(    inc de
+    ld a, e
+    cp low(BANKS)
+    jr nz, .bank
+    ld a, d
+    cp high(BANKS)
+    jr nz, .bank
+    jp Main
+
+VBlank:
+    push af
+    ldh a, [rSCX]
+    inc a
+    ldh [rSCX], a
+    ld a, [Sum]
+    ldh [rSCY], a
+    pop af
+    reti
+
+Stat:
+Timer:
+    reti
+)";
+
+    // Each switchable bank: its number, then a routine folding in its byte
+    for (uint32_t bank = 1; bank < options.banks; bank++) {
+        out << "\n    bank " << bank << "\n"
+            << "    db " << (bank & 0xFF) << ", " << (bank >> 8) << "\n"
+            << "    ld a, [$4000]\n"
+            << "    add a, c\n"
+            << "    xor " << ((bank * 37) & 0xFF) << "\n"
+            << "    ld c, a\n"
+            << "    ret\n";
+    }
+    return out.str();
+}
+
+struct Workload {
+    const char* name;
+    const char* title;
+    std::string (*source)(const Options&);
+};
+
+static const Workload WORKLOADS[] = {
+    { "alu",     "BENCH ALU",     AluSource },
+    { "memcpy",  "BENCH MEMCPY",  MemcpySource },
+    { "raster",  "BENCH RASTER",  RasterSource },
+    { "sprites", "BENCH SPRITES", SpritesSource },
+    { "sound",   "BENCH SOUND",   SoundSource },
+    { "banks",   "BENCH BANKS",   BanksSource },
+    { "halt",    "BENCH HALT",    HaltSource },
+};
+
+static bool Build(const Workload& workload, const Options& options, const std::string& out_dir, bool write_asm) {
+    std::string name = workload.name;
+    std::string title = workload.title;
+    if (name == "banks") {
+        name += std::string("_") + options.mbc->name;
+        title = "BENCH ";
+        for (const char* c = options.mbc->name; *c; c++) title += static_cast<char>(std::toupper(static_cast<unsigned char>(*c)));
+    }
+    std::string path = out_dir + "/" + name;
+    std::string source = COMMON_SOURCE + workload.source(options);
+
+    if (write_asm) {
+        std::ofstream file(path + ".asm");
+        file << source;
+    }
+
+    SM83Assembler assembler;
+    if (!assembler.Assemble(source, name + ".asm")) return false;
+
+    SM83Assembler::Header header;
+    header.title = title;
+    header.cartridge_type = options.mbc->cartridge_type;
+    header.ram_size = options.mbc->ram_size;
+    header.min_banks = name.compare(0, 5, "banks") == 0 ? options.banks : 2;
+    if (!assembler.WriteROM(path + ".gb", header)) return false;
+
+    std::printf("%-16s %4zu KB  %s\n", (name + ".gb").c_str(), assembler.BuildROM(header).size() / 1024,
+                options.mbc->name);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <out_dir> [--workload name] [--mbc none|mbc1|mbc2|mbc3|mbc5] "
+                             "[--banks N] [--asm] [--list]\n", argv[0]);
+        return 2;
+    }
+
+    std::string out_dir = argv[1];
+    std::string only;
+    const Mbc* mbc = nullptr;
+    uint32_t banks = 0;
+    bool write_asm = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--workload" && i + 1 < argc) only = argv[++i];
+        else if (arg == "--banks" && i + 1 < argc) banks = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--asm") write_asm = true;
+        else if (arg == "--list") {
+            for (const Workload& workload : WORKLOADS) std::printf("%s\n", workload.name);
+            return 0;
+        } else if (arg == "--mbc" && i + 1 < argc) {
+            std::string name = argv[++i];
+            for (const Mbc& entry : MBCS) {
+                if (name == entry.name) mbc = &entry;
+            }
+            if (!mbc) {
+                std::fprintf(stderr, "Unknown MBC: %s\n", name.c_str());
+                return 2;
+            }
+        }
+    }
+
+    bool found = false;
+    bool ok = true;
+    for (const Workload& workload : WORKLOADS) {
+        if (!only.empty() && only != workload.name) continue;
+        found = true;
+
+        if (std::string(workload.name) != "banks") {
+            Options options;
+            if (mbc) options.mbc = mbc;
+            ok = Build(workload, options, out_dir, write_asm) && ok;
+            continue;
+        }
+        for (const Mbc& entry : MBCS) {
+            if (!entry.has_ram || (mbc && mbc != &entry)) continue;
+            Options options;
+            options.mbc = &entry;
+            options.banks = banks ? banks : entry.banks;
+            if (options.banks < 2 || options.banks > entry.max_banks) {
+                std::fprintf(stderr, "%s takes 2-%u banks\n", entry.name, entry.max_banks);
+                ok = false;
+                continue;
+            }
+            ok = Build(workload, options, out_dir, write_asm) && ok;
+        }
+    }
+    if (!found) {
+        std::fprintf(stderr, "Unknown workload: %s (see --list)\n", only.c_str());
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
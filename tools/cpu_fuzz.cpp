@@ -0,0 +1,768 @@
+/**
+ * cpu_fuzz - Randomized differential fuzzer for the SM83 core
+ *
+ * Generates random instruction sequences (weighted toward ALU, CB, stack
+ * and conditional ops), runs each on the real CPU class over a flat 64KB
+ * RAM bus and on the small reference interpreter below, and compares
+ * registers, flags, IME, T-cycles (both Step()'s return and the ticks it
+ * actually issued) and the ordered list of memory writes after every
+ * instruction. Links only the CPU sources; no PPU/APU/timer involvement.
+ *
+ * Usage: gb-cpu-fuzz [--threads N] [--seconds S] [--sequences N]
+ *                    [--seed S] [--length L]
+ *
+ * Each thread fuzzes its own RAM image with its own seed, so a reported
+ * failure is reproducible with --threads 1 and the printed seed. The
+ * first mismatch stops every thread; exit code 1.
+ *
+ * Not covered: HALT, STOP, illegal opcodes and interrupt dispatch (those
+ * depend on the interrupt controller and are covered by the Mooneye ROMs).
+ * A sequence ends early when control flow lands on one of them.
+ */
+
+#include "cpu/CPU.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr size_t MAX_LENGTH = 256;
+static constexpr size_t MAX_WRITES = 4 * MAX_LENGTH;   // PUSH/CALL/RST write two bytes each
+
+struct Write {
+    uint16_t addr;
+    uint8_t value;
+};
+
+// Memory writes in bus order, reset per sequence
+struct WriteLog {
+    Write entries[MAX_WRITES];
+    size_t count = 0;
+
+    void Add(uint16_t addr, uint8_t value) {
+        if (count < MAX_WRITES) entries[count] = { addr, value };
+        count++;
+    }
+};
+
+// === Random Source ===
+
+// xorshift64*: fast, seedable, good enough to pick opcodes
+struct Random {
+    uint64_t state;
+
+    explicit Random(uint64_t seed) : state(seed ? seed : 0x9E3779B97F4A7C15ull) {}
+
+    uint64_t Next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+    uint8_t Byte() { return static_cast<uint8_t>(Next() >> 56); }
+    uint32_t Below(uint32_t n) { return static_cast<uint32_t>((Next() >> 32) % n); }
+};
+
+// === Opcode Tables ===
+
+// HALT, STOP and the 11 holes in the opcode map
+static bool IsExcluded(uint8_t op) {
+    switch (op) {
+        case 0x10: case 0x76:
+        case 0xD3: case 0xDB: case 0xDD: case 0xE3: case 0xE4:
+        case 0xEB: case 0xEC: case 0xED: case 0xF4: case 0xFC: case 0xFD:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Operand bytes following the opcode
+static int OperandLength(uint8_t op) {
+    switch (op) {
+        case 0x01: case 0x11: case 0x21: case 0x31: case 0x08:
+        case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA:
+        case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC:
+        case 0xEA: case 0xFA:
+            return 2;
+        case 0x06: case 0x0E: case 0x16: case 0x1E: case 0x26: case 0x2E: case 0x36: case 0x3E:
+        case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+        case 0xC6: case 0xCE: case 0xD6: case 0xDE: case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+        case 0xE0: case 0xF0: case 0xE8: case 0xF8: case 0xCB:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static const uint8_t ALU_OPS[] = {
+    0xC6, 0xCE, 0xD6, 0xDE, 0xE6, 0xEE, 0xF6, 0xFE,     // ALU A,n
+    0x04, 0x05, 0x0C, 0x0D, 0x14, 0x15, 0x1C, 0x1D,     // INC/DEC r
+    0x24, 0x25, 0x2C, 0x2D, 0x34, 0x35, 0x3C, 0x3D,
+    0x03, 0x0B, 0x13, 0x1B, 0x23, 0x2B, 0x33, 0x3B,     // INC/DEC rr
+    0x09, 0x19, 0x29, 0x39, 0xE8, 0xF8,                 // 16-bit adds
+    0x07, 0x0F, 0x17, 0x1F, 0x27, 0x2F, 0x37, 0x3F,     // Rotates, DAA, CPL, SCF, CCF
+};
+
+static const uint8_t STACK_OPS[] = {
+    0xC1, 0xD1, 0xE1, 0xF1, 0xC5, 0xD5, 0xE5, 0xF5,     // POP/PUSH
+    0xC9, 0xD9, 0xCD, 0xF9, 0x08,                       // RET, RETI, CALL, LD SP,HL, LD (nn),SP
+    0xC7, 0xCF, 0xD7, 0xDF, 0xE7, 0xEF, 0xF7, 0xFF,     // RST
+};
+
+static const uint8_t CONDITIONAL_OPS[] = {
+    0x20, 0x28, 0x30, 0x38,                             // JR cc
+    0xC2, 0xCA, 0xD2, 0xDA,                             // JP cc
+    0xC4, 0xCC, 0xD4, 0xDC,                             // CALL cc
+    0xC0, 0xC8, 0xD0, 0xD8,                             // RET cc
+};
+
+template <size_t N>
+static uint8_t Pick(Random& random, const uint8_t (&ops)[N]) {
+    return ops[random.Below(N)];
+}
+
+static uint8_t RandomOpcode(Random& random) {
+    uint32_t roll = random.Below(100);
+    if (roll < 20) return static_cast<uint8_t>(0x80 + random.Below(0x40));   // ALU A,r
+    if (roll < 35) return Pick(random, ALU_OPS);
+    if (roll < 55) return 0xCB;
+    if (roll < 70) return Pick(random, STACK_OPS);
+    if (roll < 85) return Pick(random, CONDITIONAL_OPS);
+    for (;;) {
+        uint8_t op = random.Byte();
+        if (!IsExcluded(op)) return op;
+    }
+}
+
+// === Reference Model ===
+// Straight from the opcode map (x/y/z/p/q decoding), one access = 4 T-cycles.
+// Deliberately naive: no tables, no shortcuts, nothing shared with the core.
+
+struct Registers {
+    uint8_t a, f, b, c, d, e, h, l;
+    uint16_t sp, pc;
+    bool ime;
+};
+
+class Reference {
+public:
+    Registers r = {};
+    bool ei_pending = false;
+    uint8_t* mem = nullptr;
+    WriteLog* log = nullptr;
+
+    // Returns T-cycles
+    int Step() {
+        cycles = 0;
+        if (ei_pending) {
+            r.ime = true;
+            ei_pending = false;
+        }
+        Execute(Fetch());
+        return cycles;
+    }
+
+private:
+    int cycles = 0;
+
+    enum : uint8_t { FZ = 0x80, FN = 0x40, FH = 0x20, FC = 0x10 };
+
+    uint8_t Read(uint16_t addr) { cycles += 4; return mem[addr]; }
+    void Store(uint16_t addr, uint8_t value) { cycles += 4; mem[addr] = value; log->Add(addr, value); }
+    void Internal() { cycles += 4; }
+    uint8_t Fetch() { return Read(r.pc++); }
+    uint16_t Fetch16() { uint8_t lo = Fetch(); return static_cast<uint16_t>(lo | (Fetch() << 8)); }
+
+    bool Flag(uint8_t mask) const { return (r.f & mask) != 0; }
+    void Flags(bool z, bool n, bool h, bool c) {
+        r.f = static_cast<uint8_t>((z ? FZ : 0) | (n ? FN : 0) | (h ? FH : 0) | (c ? FC : 0));
+    }
+
+    uint16_t HL() const { return static_cast<uint16_t>(r.h << 8 | r.l); }
+    void SetHL(uint16_t v) { r.h = v >> 8; r.l = v & 0xFF; }
+
+    // rp table: BC DE HL SP
+    uint16_t GetRP(int p) const {
+        switch (p) {
+            case 0: return static_cast<uint16_t>(r.b << 8 | r.c);
+            case 1: return static_cast<uint16_t>(r.d << 8 | r.e);
+            case 2: return HL();
+            default: return r.sp;
+        }
+    }
+    void SetRP(int p, uint16_t v) {
+        switch (p) {
+            case 0: r.b = v >> 8; r.c = v & 0xFF; break;
+            case 1: r.d = v >> 8; r.e = v & 0xFF; break;
+            case 2: SetHL(v); break;
+            default: r.sp = v; break;
+        }
+    }
+
+    // r table: B C D E H L (HL) A
+    uint8_t GetR(int i) {
+        switch (i) {
+            case 0: return r.b;
+            case 1: return r.c;
+            case 2: return r.d;
+            case 3: return r.e;
+            case 4: return r.h;
+            case 5: return r.l;
+            case 6: return Read(HL());
+            default: return r.a;
+        }
+    }
+    void SetR(int i, uint8_t v) {
+        switch (i) {
+            case 0: r.b = v; break;
+            case 1: r.c = v; break;
+            case 2: r.d = v; break;
+            case 3: r.e = v; break;
+            case 4: r.h = v; break;
+            case 5: r.l = v; break;
+            case 6: Store(HL(), v); break;
+            default: r.a = v; break;
+        }
+    }
+
+    // cc table: NZ Z NC C
+    bool Condition(int y) const {
+        switch (y & 3) {
+            case 0: return !Flag(FZ);
+            case 1: return Flag(FZ);
+            case 2: return !Flag(FC);
+            default: return Flag(FC);
+        }
+    }
+
+    void Push(uint16_t v) {
+        Store(--r.sp, v >> 8);
+        Store(--r.sp, v & 0xFF);
+    }
+    uint16_t Pop() {
+        uint8_t lo = Read(r.sp++);
+        return static_cast<uint16_t>(lo | (Read(r.sp++) << 8));
+    }
+
+    void Alu(int op, uint8_t v) {
+        int a = r.a;
+        int carry = Flag(FC) ? 1 : 0;
+        switch (op) {
+            case 0: r.a = static_cast<uint8_t>(a + v); Flags(r.a == 0, false, (a & 0xF) + (v & 0xF) > 0xF, a + v > 0xFF); break;
+            case 1: r.a = static_cast<uint8_t>(a + v + carry); Flags(r.a == 0, false, (a & 0xF) + (v & 0xF) + carry > 0xF, a + v + carry > 0xFF); break;
+            case 2: r.a = static_cast<uint8_t>(a - v); Flags(r.a == 0, true, (a & 0xF) < (v & 0xF), a < v); break;
+            case 3: r.a = static_cast<uint8_t>(a - v - carry); Flags(r.a == 0, true, (a & 0xF) < (v & 0xF) + carry, a < v + carry); break;
+            case 4: r.a = static_cast<uint8_t>(a & v); Flags(r.a == 0, false, true, false); break;
+            case 5: r.a = static_cast<uint8_t>(a ^ v); Flags(r.a == 0, false, false, false); break;
+            case 6: r.a = static_cast<uint8_t>(a | v); Flags(r.a == 0, false, false, false); break;
+            default: Flags(static_cast<uint8_t>(a - v) == 0, true, (a & 0xF) < (v & 0xF), a < v); break;
+        }
+    }
+
+    // SP + signed immediate, shared by ADD SP,e and LD HL,SP+e
+    uint16_t AddSP(uint8_t e) {
+        int sum = r.sp + static_cast<int8_t>(e);
+        Flags(false, false, (r.sp & 0xF) + (e & 0xF) > 0xF, (r.sp & 0xFF) + e > 0xFF);
+        return static_cast<uint16_t>(sum);
+    }
+
+    void ExecuteCB(uint8_t op) {
+        int x = op >> 6, y = (op >> 3) & 7, z = op & 7;
+        uint8_t v = GetR(z);
+        bool carry = Flag(FC);
+        if (x == 1) {   // BIT
+            Flags(!((v >> y) & 1), false, true, carry);
+            return;
+        }
+        if (x == 2) { SetR(z, static_cast<uint8_t>(v & ~(1 << y))); return; }
+        if (x == 3) { SetR(z, static_cast<uint8_t>(v | (1 << y))); return; }
+
+        uint8_t result = 0;
+        bool out = false;
+        switch (y) {
+            case 0: out = v & 0x80; result = static_cast<uint8_t>(v << 1 | v >> 7); break;   // RLC
+            case 1: out = v & 0x01; result = static_cast<uint8_t>(v >> 1 | v << 7); break;   // RRC
+            case 2: out = v & 0x80; result = static_cast<uint8_t>(v << 1 | carry); break;    // RL
+            case 3: out = v & 0x01; result = static_cast<uint8_t>(v >> 1 | carry << 7); break;  // RR
+            case 4: out = v & 0x80; result = static_cast<uint8_t>(v << 1); break;            // SLA
+            case 5: out = v & 0x01; result = static_cast<uint8_t>((v >> 1) | (v & 0x80)); break;  // SRA
+            case 6: out = false; result = static_cast<uint8_t>(v << 4 | v >> 4); break;      // SWAP
+            default: out = v & 0x01; result = static_cast<uint8_t>(v >> 1); break;           // SRL
+        }
+        Flags(result == 0, false, false, out);
+        SetR(z, result);
+    }
+
+    void Execute(uint8_t op) {
+        int x = op >> 6, y = (op >> 3) & 7, z = op & 7, p = y >> 1, q = y & 1;
+
+        if (x == 1) {   // LD r,r' (HALT excluded)
+            SetR(y, GetR(z));
+            return;
+        }
+        if (x == 2) {
+            Alu(y, GetR(z));
+            return;
+        }
+
+        if (x == 0) {
+            switch (z) {
+                case 0:
+                    if (y == 0) return;   // NOP
+                    if (y == 1) {         // LD (nn),SP
+                        uint16_t nn = Fetch16();
+                        Store(nn, r.sp & 0xFF);
+                        Store(static_cast<uint16_t>(nn + 1), r.sp >> 8);
+                        return;
+                    }
+                    {
+                        int8_t e = static_cast<int8_t>(Fetch());
+                        if (y == 3 || Condition(y - 4)) {
+                            Internal();
+                            r.pc = static_cast<uint16_t>(r.pc + e);
+                        }
+                    }
+                    return;
+                case 1:
+                    if (q == 0) {
+                        SetRP(p, Fetch16());
+                    } else {
+                        int hl = HL(), rp = GetRP(p);
+                        Internal();
+                        bool zero = Flag(FZ);
+                        Flags(zero, false, (hl & 0xFFF) + (rp & 0xFFF) > 0xFFF, hl + rp > 0xFFFF);
+                        SetHL(static_cast<uint16_t>(hl + rp));
+                    }
+                    return;
+                case 2: {
+                    uint16_t addr = p == 0 ? GetRP(0) : p == 1 ? GetRP(1) : HL();
+                    if (q == 0) Store(addr, r.a);
+                    else r.a = Read(addr);
+                    if (p == 2) SetHL(static_cast<uint16_t>(addr + 1));
+                    if (p == 3) SetHL(static_cast<uint16_t>(addr - 1));
+                    return;
+                }
+                case 3:
+                    Internal();
+                    SetRP(p, static_cast<uint16_t>(GetRP(p) + (q == 0 ? 1 : -1)));
+                    return;
+                case 4: {
+                    uint8_t v = static_cast<uint8_t>(GetR(y) + 1);
+                    Flags(v == 0, false, (v & 0xF) == 0, Flag(FC));
+                    SetR(y, v);
+                    return;
+                }
+                case 5: {
+                    uint8_t v = static_cast<uint8_t>(GetR(y) - 1);
+                    Flags(v == 0, true, (v & 0xF) == 0xF, Flag(FC));
+                    SetR(y, v);
+                    return;
+                }
+                case 6:
+                    SetR(y, Fetch());
+                    return;
+                default: {
+                    uint8_t a = r.a;
+                    bool carry = Flag(FC);
+                    switch (y) {
+                        case 0: r.a = static_cast<uint8_t>(a << 1 | a >> 7); Flags(false, false, false, a & 0x80); break;
+                        case 1: r.a = static_cast<uint8_t>(a >> 1 | a << 7); Flags(false, false, false, a & 0x01); break;
+                        case 2: r.a = static_cast<uint8_t>(a << 1 | carry); Flags(false, false, false, a & 0x80); break;
+                        case 3: r.a = static_cast<uint8_t>(a >> 1 | carry << 7); Flags(false, false, false, a & 0x01); break;
+                        case 4: {   // DAA
+                            bool n = Flag(FN), h = Flag(FH);
+                            int v = a;
+                            if (!n) {
+                                if (carry || v > 0x99) { v += 0x60; carry = true; }
+                                if (h || (v & 0x0F) > 0x09) v += 0x06;
+                            } else {
+                                if (carry) v -= 0x60;
+                                if (h) v -= 0x06;
+                            }
+                            r.a = static_cast<uint8_t>(v);
+                            Flags(r.a == 0, n, false, carry);
+                            break;
+                        }
+                        case 5: r.a = static_cast<uint8_t>(~a); Flags(Flag(FZ), true, true, carry); break;
+                        case 6: Flags(Flag(FZ), false, false, true); break;
+                        default: Flags(Flag(FZ), false, false, !carry); break;
+                    }
+                    return;
+                }
+            }
+        }
+
+        // x == 3
+        switch (z) {
+            case 0:
+                if (y < 4) {   // RET cc
+                    Internal();
+                    if (Condition(y)) {
+                        r.pc = Pop();
+                        Internal();
+                    }
+                } else if (y == 4) {
+                    Store(static_cast<uint16_t>(0xFF00 + Fetch()), r.a);
+                } else if (y == 6) {
+                    r.a = Read(static_cast<uint16_t>(0xFF00 + Fetch()));
+                } else if (y == 5) {   // ADD SP,e
+                    uint8_t e = Fetch();
+                    Internal();
+                    Internal();
+                    r.sp = AddSP(e);
+                } else {               // LD HL,SP+e
+                    uint8_t e = Fetch();
+                    Internal();
+                    SetHL(AddSP(e));
+                }
+                return;
+            case 1:
+                if (q == 0) {
+                    uint16_t v = Pop();
+                    if (p == 3) { r.a = v >> 8; r.f = v & 0xF0; }
+                    else SetRP(p, v);
+                } else if (p == 0 || p == 1) {   // RET, RETI
+                    r.pc = Pop();
+                    Internal();
+                    if (p == 1) r.ime = true;
+                } else if (p == 2) {
+                    r.pc = HL();
+                } else {
+                    Internal();
+                    r.sp = HL();
+                }
+                return;
+            case 2:
+                if (y < 4) {   // JP cc,nn
+                    uint16_t nn = Fetch16();
+                    if (Condition(y)) {
+                        Internal();
+                        r.pc = nn;
+                    }
+                } else if (y == 4) {
+                    Store(static_cast<uint16_t>(0xFF00 + r.c), r.a);
+                } else if (y == 6) {
+                    r.a = Read(static_cast<uint16_t>(0xFF00 + r.c));
+                } else if (y == 5) {
+                    Store(Fetch16(), r.a);
+                } else {
+                    r.a = Read(Fetch16());
+                }
+                return;
+            case 3:
+                if (y == 0) {
+                    uint16_t nn = Fetch16();
+                    Internal();
+                    r.pc = nn;
+                } else if (y == 1) {
+                    ExecuteCB(Fetch());
+                } else if (y == 6) {
+                    r.ime = false;
+                    ei_pending = false;
+                } else {
+                    ei_pending = true;
+                }
+                return;
+            case 4:
+            case 5: {
+                if (z == 5 && q == 0) {   // PUSH
+                    Internal();
+                    Push(p == 3 ? static_cast<uint16_t>(r.a << 8 | r.f) : GetRP(p));
+                    return;
+                }
+                uint16_t nn = Fetch16();  // CALL cc,nn / CALL nn
+                if (z == 5 || Condition(y)) {
+                    Internal();
+                    Push(r.pc);
+                    r.pc = nn;
+                }
+                return;
+            }
+            case 6:
+                Alu(y, Fetch());
+                return;
+            default:   // RST
+                Internal();
+                Push(r.pc);
+                r.pc = static_cast<uint16_t>(y * 8);
+                return;
+        }
+    }
+};
+
+// === Harness ===
+
+static std::atomic<bool> stop_requested{false};
+static std::atomic<uint64_t> total_sequences{0};
+static std::atomic<uint64_t> total_instructions{0};
+static std::mutex failure_mutex;
+static std::string failure_report;
+
+static Registers Capture(const CPU& cpu) {
+    return { cpu.GetA(), cpu.GetF(), cpu.GetB(), cpu.GetC(), cpu.GetD(), cpu.GetE(),
+             cpu.GetH(), cpu.GetL(), cpu.GetSP(), cpu.GetPC(), cpu.GetIME() };
+}
+
+static bool SameRegisters(const Registers& x, const Registers& y) {
+    return x.a == y.a && x.f == y.f && x.b == y.b && x.c == y.c && x.d == y.d && x.e == y.e &&
+           x.h == y.h && x.l == y.l && x.sp == y.sp && x.pc == y.pc && x.ime == y.ime;
+}
+
+static void AppendRegisters(std::string& out, const char* label, const Registers& regs) {
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "  %-9s A=%02X F=%02X B=%02X C=%02X D=%02X E=%02X H=%02X L=%02X SP=%04X PC=%04X IME=%d\n",
+                  label, regs.a, regs.f, regs.b, regs.c, regs.d, regs.e, regs.h, regs.l, regs.sp, regs.pc, regs.ime);
+    out += line;
+}
+
+class FuzzWorker {
+public:
+    FuzzWorker(uint64_t seed, size_t length)
+        : seed(seed), random(seed), length(length), image(0x10000), cpu_mem(0x10000), ref_mem(0x10000)
+    {
+        for (uint8_t& byte : image) byte = random.Byte();
+        cpu_mem = image;
+        ref_mem = image;
+
+        cpu.ConnectBus(
+            [this](uint16_t addr) { return cpu_mem[addr]; },
+            [this](uint16_t addr, uint8_t value) { cpu_mem[addr] = value; cpu_writes.Add(addr, value); },
+            [this](uint8_t cycles) { ticks += cycles; });
+        // No interrupt sources: keeps IF/IE reads off the flat bus
+        cpu.ConnectInterruptLine(&no_interrupts);
+        reference.mem = ref_mem.data();
+        reference.log = &ref_writes;
+    }
+
+    void Run(uint64_t max_sequences) {
+        uint64_t done = 0;
+        uint64_t instructions = 0;
+        while (!stop_requested.load(std::memory_order_relaxed) && (max_sequences == 0 || done < max_sequences)) {
+            if (!RunSequence(instructions)) {
+                stop_requested = true;
+                break;
+            }
+            done++;
+            if ((done & 1023) == 0) {
+                total_sequences += 1024;
+                total_instructions += instructions;
+                instructions = 0;
+            }
+        }
+        total_sequences += done & 1023;
+        total_instructions += instructions;
+    }
+
+private:
+    uint64_t seed;
+    Random random;
+    size_t length;
+    uint64_t sequence = 0;
+
+    CPU cpu;
+    Reference reference;
+    uint8_t no_interrupts = 0;
+    uint32_t ticks = 0;
+
+    std::vector<uint8_t> image;     // Shared starting RAM contents
+    std::vector<uint8_t> cpu_mem;
+    std::vector<uint8_t> ref_mem;
+    WriteLog cpu_writes;
+    WriteLog ref_writes;
+
+    uint16_t program_start = 0;
+    size_t program_size = 0;
+
+    bool RunSequence(uint64_t& instructions) {
+        sequence++;
+        Registers start = SetUp();
+
+        for (size_t i = 0; i < length; i++) {
+            uint16_t pc = cpu.GetPC();
+            if (IsExcluded(cpu_mem[pc])) break;
+
+            size_t writes_before = cpu_writes.count;
+            ticks = 0;
+            int cpu_cycles = cpu.Step();
+            int ref_cycles = reference.Step();
+            instructions++;
+
+            Registers actual = Capture(cpu);
+            if (!SameRegisters(actual, reference.r) || cpu_cycles != ref_cycles ||
+                static_cast<int>(ticks) != cpu_cycles || !SameWrites()) {
+                Report(start, i, pc, actual, cpu_cycles, ref_cycles, writes_before);
+                return false;
+            }
+        }
+
+        Restore();
+        return true;
+    }
+
+    // Random registers, random program at a random PC
+    Registers SetUp() {
+        program_size = 0;
+        std::vector<uint8_t> program;
+        while (program.size() < length * 3) {
+            uint8_t op = RandomOpcode(random);
+            program.push_back(op);
+            int operands = OperandLength(op);
+            for (int j = 0; j < operands; j++) program.push_back(random.Byte());
+        }
+        program_size = program.size();
+        program_start = static_cast<uint16_t>(random.Below(static_cast<uint32_t>(0x10000 - program_size)));
+        std::memcpy(&cpu_mem[program_start], program.data(), program_size);
+        std::memcpy(&ref_mem[program_start], program.data(), program_size);
+
+        Registers start = {
+            random.Byte(), static_cast<uint8_t>(random.Byte() & 0xF0),
+            random.Byte(), random.Byte(), random.Byte(), random.Byte(), random.Byte(), random.Byte(),
+            static_cast<uint16_t>(random.Next()), program_start, random.Below(2) == 1
+        };
+
+        cpu.Reset(true);
+        cpu.SetAF(static_cast<uint16_t>(start.a << 8 | start.f));
+        cpu.SetB(start.b); cpu.SetC(start.c); cpu.SetD(start.d);
+        cpu.SetE(start.e); cpu.SetH(start.h); cpu.SetL(start.l);
+        cpu.SetSP(start.sp);
+        cpu.SetPC(start.pc);
+        cpu.SetIME(start.ime);
+
+        reference.r = start;
+        reference.ei_pending = false;
+        cpu_writes.count = 0;
+        ref_writes.count = 0;
+        return start;
+    }
+
+    bool SameWrites() const {
+        if (cpu_writes.count != ref_writes.count) return false;
+        size_t count = std::min(cpu_writes.count, MAX_WRITES);
+        for (size_t i = 0; i < count; i++) {
+            if (cpu_writes.entries[i].addr != ref_writes.entries[i].addr ||
+                cpu_writes.entries[i].value != ref_writes.entries[i].value) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Undo this sequence's writes so the next one starts from the image
+    void Restore() {
+        size_t count = std::min(cpu_writes.count, MAX_WRITES);
+        for (size_t i = 0; i < count; i++) {
+            uint16_t addr = cpu_writes.entries[i].addr;
+            cpu_mem[addr] = ref_mem[addr] = image[addr];
+        }
+        std::memcpy(&cpu_mem[program_start], &image[program_start], program_size);
+        std::memcpy(&ref_mem[program_start], &image[program_start], program_size);
+    }
+
+    void Report(const Registers& start, size_t index, uint16_t pc, const Registers& actual,
+                int cpu_cycles, int ref_cycles, size_t writes_before) {
+        std::string out;
+        char line[256];
+        std::snprintf(line, sizeof(line), "Mismatch: seed %" PRIu64 ", sequence %" PRIu64 ", instruction %zu at $%04X\n",
+                      seed, sequence, index, pc);
+        out += line;
+
+        out += "  opcode   ";
+        for (int i = 0; i < 4; i++) {
+            std::snprintf(line, sizeof(line), " %02X", cpu_mem[static_cast<uint16_t>(pc + i)]);
+            out += line;
+        }
+        out += "  (after the instruction ran)\n  program   ";
+        for (size_t i = 0; i < program_size && i < 48; i++) {
+            std::snprintf(line, sizeof(line), " %02X", cpu_mem[static_cast<uint16_t>(program_start + i)]);
+            out += line;
+        }
+        out += "\n";
+
+        AppendRegisters(out, "start", start);
+        AppendRegisters(out, "cpu", actual);
+        AppendRegisters(out, "reference", reference.r);
+        std::snprintf(line, sizeof(line), "  cycles    cpu=%d (ticked %u) reference=%d\n", cpu_cycles, ticks, ref_cycles);
+        out += line;
+
+        for (const WriteLog* log : { &cpu_writes, &ref_writes }) {
+            out += log == &cpu_writes ? "  writes cpu      " : "  writes reference";
+            for (size_t i = writes_before; i < log->count && i < MAX_WRITES; i++) {
+                std::snprintf(line, sizeof(line), " $%04X=%02X", log->entries[i].addr, log->entries[i].value);
+                out += line;
+            }
+            out += "\n";
+        }
+
+        std::lock_guard<std::mutex> lock(failure_mutex);
+        if (failure_report.empty()) failure_report = out;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    double seconds = 10.0;
+    uint64_t sequences = 0;
+    uint64_t seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    size_t length = 16;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--seconds" && i + 1 < argc) seconds = std::atof(argv[++i]);
+        else if (arg == "--sequences" && i + 1 < argc) { sequences = std::strtoull(argv[++i], nullptr, 10); seconds = 0; }
+        else if (arg == "--seed" && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 0);
+        else if (arg == "--length" && i + 1 < argc) {
+            length = std::strtoull(argv[++i], nullptr, 10);
+            if (length < 1) length = 1;
+            if (length > MAX_LENGTH) length = MAX_LENGTH;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--threads N] [--seconds S] [--sequences N] [--seed S] [--length L]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("Fuzzing SM83 core: %u threads, seed %" PRIu64 ", %zu instructions per sequence\n",
+                threads, seed, length);
+
+    // Per-thread sequence budget when --sequences is given
+    uint64_t per_thread = sequences ? (sequences + threads - 1) / threads : 0;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([=] {
+            FuzzWorker worker(seed + t, length);
+            worker.Run(per_thread);
+        });
+    }
+
+    if (seconds > 0) {
+        auto deadline = start + std::chrono::duration<double>(seconds);
+        while (!stop_requested && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        stop_requested = true;
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t done = total_sequences.load();
+    std::printf("%" PRIu64 " sequences, %" PRIu64 " instructions in %.1fs (%.2fM sequences/min)\n",
+                done, total_instructions.load(), elapsed, done / std::max(elapsed, 1e-3) * 60.0 / 1e6);
+
+    if (!failure_report.empty()) {
+        std::printf("\n%s", failure_report.c_str());
+        return 1;
+    }
+    std::printf("No mismatches\n");
+    return 0;
+}
@@ -0,0 +1,188 @@
+/**
+ * shm_reader - Example consumer for gb-emu3 --export-shm
+ *
+ * Maps /dev/shm/<name> read-only and follows the frame and audio rings
+ * without copying pixel data (the hash is computed in place). Only needs
+ * SharedFrameLayout.hpp; doesn't link against the emulator.
+ *
+ * Usage: gb-shm-reader <name> [--frames N] [--pgm out.pgm] [--verify]
+ *
+ * --verify turns it into a local test consumer: exits non-zero if no
+ * frames arrive or frame numbers/cycle stamps go backwards. Torn reads
+ * (slot overwritten while hashing) are counted and skipped.
+ */
+
+#include "export/SharedFrameLayout.hpp"
+#include "util/Hash.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif
+
+// Block until `word` differs from `seen` or ~100ms pass
+static void WaitForChange(const std::atomic<uint32_t>& word, uint32_t seen) {
+#ifdef __linux__
+    timespec timeout = { 0, 100 * 1000 * 1000 };
+    syscall(SYS_futex, reinterpret_cast<const uint32_t*>(&word), FUTEX_WAIT, seen, &timeout, nullptr, 0);
+#else
+    (void)word; (void)seen;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+}
+
+static void WritePGM(const std::string& path, const uint8_t* pixels) {
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return;
+    std::fprintf(f, "P5\n%u %u\n255\n", SharedFrameLayout::FRAME_WIDTH, SharedFrameLayout::FRAME_HEIGHT);
+    for (uint32_t i = 0; i < SharedFrameLayout::FRAME_WIDTH * SharedFrameLayout::FRAME_HEIGHT; i++) {
+        std::fputc(255 - (pixels[i] & 3) * 85, f);
+    }
+    std::fclose(f);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <name> [--frames N] [--pgm out.pgm] [--verify]\n", argv[0]);
+        return 2;
+    }
+
+    std::string name = std::string("/") + argv[1];
+    uint64_t max_frames = 0;
+    std::string pgm_path;
+    bool verify = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) max_frames = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--pgm" && i + 1 < argc) pgm_path = argv[++i];
+        else if (arg == "--verify") verify = true;
+    }
+
+    // Wait up to 5s for the emulator to create the object
+    int fd = -1;
+    for (int tries = 0; tries < 500 && fd < 0; tries++) {
+        fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (fd < 0) {
+        std::fprintf(stderr, "shm_open %s: %s\n", name.c_str(), std::strerror(errno));
+        return 1;
+    }
+
+    struct stat st;
+    fstat(fd, &st);
+    void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::fprintf(stderr, "mmap: %s\n", std::strerror(errno));
+        return 1;
+    }
+
+    const uint8_t* base = static_cast<const uint8_t*>(mapping);
+    const SharedFrameHeader* header = reinterpret_cast<const SharedFrameHeader*>(base);
+    for (int tries = 0; tries < 500 && std::memcmp(header->magic, SharedFrameLayout::MAGIC, 8) != 0; tries++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (std::memcmp(header->magic, SharedFrameLayout::MAGIC, 8) != 0 ||
+        header->version != SharedFrameLayout::VERSION) {
+        std::fprintf(stderr, "%s is not a gb-emu3 v%u export\n", name.c_str(), SharedFrameLayout::VERSION);
+        return 1;
+    }
+
+    std::printf("Attached to %s (writer pid %u)\n", name.c_str(), header->writer_pid);
+
+    uint32_t frames_seen = header->frame_seq.load(std::memory_order_acquire);
+    uint32_t audio_seen = header->audio_seq.load(std::memory_order_acquire);
+    uint64_t frames_read = 0, frames_dropped = 0, frames_torn = 0;
+    uint64_t audio_samples = 0;
+    uint64_t last_frame = 0, last_cycle = 0;
+    bool ordering_ok = true;
+
+    while (max_frames == 0 || frames_read < max_frames) {
+        uint32_t published = header->frame_seq.load(std::memory_order_acquire);
+        if (published == frames_seen) {
+            if (!header->writer_alive.load(std::memory_order_acquire)) break;
+            WaitForChange(header->frame_seq, frames_seen);
+            continue;
+        }
+
+        // Skip anything already overwritten
+        if (published - frames_seen > SharedFrameLayout::FRAME_SLOTS) {
+            frames_dropped += published - frames_seen - SharedFrameLayout::FRAME_SLOTS;
+            frames_seen = published - SharedFrameLayout::FRAME_SLOTS;
+        }
+
+        for (; frames_seen != published; frames_seen++) {
+            const SharedFrameSlot* slot = reinterpret_cast<const SharedFrameSlot*>(
+                base + header->frame_offset + (frames_seen % header->frame_slots) * header->frame_slot_size);
+
+            // Seqlock read: use the pixels in place, then confirm the slot
+            // wasn't rewritten underneath us
+            uint64_t before = slot->sequence.load(std::memory_order_acquire);
+            uint64_t number = slot->frame_number;
+            uint64_t cycle = slot->cycle;
+            uint64_t hash = HashBytes(slot->pixels, sizeof(slot->pixels));
+            if (!pgm_path.empty()) WritePGM(pgm_path, slot->pixels);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = slot->sequence.load(std::memory_order_relaxed);
+
+            if ((before & 1) || before != after) {
+                frames_torn++;
+                continue;
+            }
+
+            if (frames_read > 0 && (number <= last_frame || cycle < last_cycle)) {
+                ordering_ok = false;
+            }
+            last_frame = number;
+            last_cycle = cycle;
+            frames_read++;
+
+            if (!verify || frames_read % 60 == 0) {
+                std::printf("frame %llu cycle %llu hash %016llx\n",
+                            (unsigned long long)number, (unsigned long long)cycle, (unsigned long long)hash);
+            }
+        }
+
+        // Drain audio too (sample count only - a real consumer would copy)
+        uint32_t audio_published = header->audio_seq.load(std::memory_order_acquire);
+        if (audio_published - audio_seen > SharedFrameLayout::AUDIO_SLOTS) {
+            audio_seen = audio_published - SharedFrameLayout::AUDIO_SLOTS;
+        }
+        for (; audio_seen != audio_published; audio_seen++) {
+            const SharedAudioSlot* slot = reinterpret_cast<const SharedAudioSlot*>(
+                base + header->audio_offset + (audio_seen % header->audio_slots) * header->audio_slot_size);
+            uint64_t before = slot->sequence.load(std::memory_order_acquire);
+            uint32_t count = slot->sample_count;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (!(before & 1) && before == slot->sequence.load(std::memory_order_relaxed)) {
+                audio_samples += count;
+            }
+        }
+    }
+
+    std::printf("Read %llu frames (%llu dropped, %llu torn), %llu audio samples\n",
+                (unsigned long long)frames_read, (unsigned long long)frames_dropped,
+                (unsigned long long)frames_torn, (unsigned long long)audio_samples);
+
+    munmap(mapping, st.st_size);
+
+    if (verify && (frames_read == 0 || !ordering_ok)) {
+        std::fprintf(stderr, "VERIFY FAILED: %s\n", frames_read == 0 ? "no frames" : "out-of-order frames");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,781 @@
+#include "sm83_assembler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+using Immediate = SM83Assembler::Immediate;
+
+// Checked by the boot ROM
+static constexpr uint8_t NINTENDO_LOGO[48] = {
+    0xCE, 0xED, 0x66, 0x66, 0xCC, 0x0D, 0x00, 0x0B, 0x03, 0x73, 0x00, 0x83,
+    0x00, 0x0C, 0x00, 0x0D, 0x00, 0x08, 0x11, 0x1F, 0x88, 0x89, 0x00, 0x0E,
+    0xDC, 0xCC, 0x6E, 0xE6, 0xDD, 0xDD, 0xD9, 0x99, 0xBB, 0xBB, 0x67, 0x63,
+    0x6E, 0x0E, 0xEC, 0xCC, 0xDD, 0xDC, 0x99, 0x9F, 0xBB, 0xB9, 0x33, 0x3E,
+};
+
+static std::string Lower(std::string text) {
+    for (char& c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return text;
+}
+
+static std::string Trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+// === Instruction Table ===
+
+// Keyed by mnemonic and operand shapes, e.g. "ld a,[hl+]", "jr nz,n",
+// "bit 3,[hl]" (see Classify)
+struct Opcode {
+    uint8_t code[2];
+    uint8_t length;
+    Immediate immediate;
+};
+
+static std::unordered_map<std::string, Opcode> BuildTable() {
+    static const char* r8[] = { "b", "c", "d", "e", "h", "l", "[hl]", "a" };
+    static const char* r16[] = { "bc", "de", "hl", "sp" };
+    static const char* r16_stack[] = { "bc", "de", "hl", "af" };
+    static const char* conditions[] = { "nz", "z", "nc", "c" };
+    static const char* alu[] = { "add", "adc", "sub", "sbc", "and", "xor", "or", "cp" };
+    static const char* shifts[] = { "rlc", "rrc", "rl", "rr", "sla", "sra", "swap", "srl" };
+    static const char* accumulator[] = { "rlca", "rrca", "rla", "rra", "daa", "cpl", "scf", "ccf" };
+
+    std::unordered_map<std::string, Opcode> table;
+    auto add = [&](const std::string& key, int code, Immediate immediate = Immediate::NONE) {
+        table[key] = { { static_cast<uint8_t>(code), 0 }, 1, immediate };
+    };
+    auto add_cb = [&](const std::string& key, int code) {
+        table[key] = { { 0xCB, static_cast<uint8_t>(code) }, 2, Immediate::NONE };
+    };
+
+    add("nop", 0x00);
+    table["stop"] = { { 0x10, 0x00 }, 2, Immediate::NONE };
+    add("halt", 0x76);
+    add("di", 0xF3);
+    add("ei", 0xFB);
+    add("ret", 0xC9);
+    add("reti", 0xD9);
+    for (int i = 0; i < 8; i++) add(accumulator[i], 0x07 + 8 * i);
+
+    for (int i = 0; i < 4; i++) {
+        std::string pair = r16[i];
+        std::string cc = conditions[i];
+        add("ld " + pair + ",n", 0x01 + 16 * i, Immediate::U16);
+        add("inc " + pair, 0x03 + 16 * i);
+        add("dec " + pair, 0x0B + 16 * i);
+        add("add hl," + pair, 0x09 + 16 * i);
+        add("pop " + std::string(r16_stack[i]), 0xC1 + 16 * i);
+        add("push " + std::string(r16_stack[i]), 0xC5 + 16 * i);
+        add("jr " + cc + ",n", 0x20 + 8 * i, Immediate::REL);
+        add("ret " + cc, 0xC0 + 8 * i);
+        add("jp " + cc + ",n", 0xC2 + 8 * i, Immediate::U16);
+        add("call " + cc + ",n", 0xC4 + 8 * i, Immediate::U16);
+    }
+
+    add("ld [bc],a", 0x02);
+    add("ld [de],a", 0x12);
+    add("ld [hl+],a", 0x22);
+    add("ld [hl-],a", 0x32);
+    add("ld a,[bc]", 0x0A);
+    add("ld a,[de]", 0x1A);
+    add("ld a,[hl+]", 0x2A);
+    add("ld a,[hl-]", 0x3A);
+    add("ld [n],sp", 0x08, Immediate::U16);
+    add("jr n", 0x18, Immediate::REL);
+    add("jp n", 0xC3, Immediate::U16);
+    add("jp hl", 0xE9);
+    add("jp [hl]", 0xE9);
+    add("call n", 0xCD, Immediate::U16);
+    add("ldh [n],a", 0xE0, Immediate::HIGH);
+    add("ldh a,[n]", 0xF0, Immediate::HIGH);
+    add("ld [c],a", 0xE2);
+    add("ld a,[c]", 0xF2);
+    add("ldh [c],a", 0xE2);
+    add("ldh a,[c]", 0xF2);
+    add("ld [n],a", 0xEA, Immediate::U16);
+    add("ld a,[n]", 0xFA, Immediate::U16);
+    add("add sp,n", 0xE8, Immediate::S8);
+    add("ld hl,sp+n", 0xF8, Immediate::S8);
+    add("ld sp,hl", 0xF9);
+
+    for (int d = 0; d < 8; d++) {
+        std::string dst = r8[d];
+        add("inc " + dst, 0x04 + 8 * d);
+        add("dec " + dst, 0x05 + 8 * d);
+        add("ld " + dst + ",n", 0x06 + 8 * d, Immediate::U8);
+        for (int s = 0; s < 8; s++) {
+            if (d == 6 && s == 6) continue;   // HALT
+            add("ld " + dst + "," + r8[s], 0x40 + 8 * d + s);
+        }
+    }
+
+    // ALU ops take "a," or not, like most assemblers
+    for (int k = 0; k < 8; k++) {
+        std::string op = alu[k];
+        add(op + " a,n", 0xC6 + 8 * k, Immediate::U8);
+        add(op + " n", 0xC6 + 8 * k, Immediate::U8);
+        for (int s = 0; s < 8; s++) {
+            add(op + " a," + r8[s], 0x80 + 8 * k + s);
+            add(op + " " + r8[s], 0x80 + 8 * k + s);
+            add_cb(std::string(shifts[k]) + " " + r8[s], 8 * k + s);
+        }
+    }
+    for (int b = 0; b < 8; b++) {
+        for (int s = 0; s < 8; s++) {
+            std::string operands = std::to_string(b) + "," + r8[s];
+            add_cb("bit " + operands, 0x40 + 8 * b + s);
+            add_cb("res " + operands, 0x80 + 8 * b + s);
+            add_cb("set " + operands, 0xC0 + 8 * b + s);
+        }
+    }
+    return table;
+}
+
+static const std::unordered_map<std::string, Opcode>& Table() {
+    static const std::unordered_map<std::string, Opcode> table = BuildTable();
+    return table;
+}
+
+// Operand shape for the table key; `expr` receives the expression part
+static std::string Classify(const std::string& operand, std::string& expr) {
+    static const char* registers[] = { "a", "b", "c", "d", "e", "h", "l", "af", "bc", "de", "hl", "sp", "nz", "z", "nc" };
+    std::string lower = Lower(operand);
+    expr.clear();
+
+    for (const char* name : registers) {
+        if (lower == name) return lower;
+    }
+    if (lower.size() >= 2 && lower.front() == '[' && lower.back() == ']') {
+        std::string inner = lower.substr(1, lower.size() - 2);
+        if (inner == "hl+" || inner == "hli") return "[hl+]";
+        if (inner == "hl-" || inner == "hld") return "[hl-]";
+        if (inner == "hl" || inner == "bc" || inner == "de" || inner == "c") return "[" + inner + "]";
+        if (inner == "$ff00+c" || inner == "0xff00+c") return "[c]";
+        expr = operand.substr(1, operand.size() - 2);
+        return "[n]";
+    }
+    if (lower.size() > 3 && lower.compare(0, 2, "sp") == 0 && (lower[2] == '+' || lower[2] == '-')) {
+        expr = operand.substr(lower[2] == '+' ? 3 : 2);
+        return "sp+n";
+    }
+    expr = operand;
+    return "n";
+}
+
+// === Expressions ===
+
+// Recursive descent over one expression; symbols come from `lookup`
+class ExpressionParser {
+public:
+    using Lookup = bool (*)(const void* context, const std::string& name, bool bank_of, int64_t& value);
+
+    ExpressionParser(const std::string& text, uint32_t at, Lookup lookup, const void* context)
+        : text(text), at(at), lookup(lookup), context(context) {}
+
+    bool Parse(int64_t& value, bool& known) {
+        value = Or();
+        Skip();
+        known = this->known;
+        return !error && pos == text.size();
+    }
+
+private:
+    const std::string& text;
+    size_t pos = 0;
+    uint32_t at;
+    Lookup lookup;
+    const void* context;
+    bool error = false;
+    bool known = true;
+
+    void Skip() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+    }
+
+    bool Accept(const char* token) {
+        Skip();
+        size_t length = std::char_traits<char>::length(token);
+        if (text.compare(pos, length, token) != 0) return false;
+        pos += length;
+        return true;
+    }
+
+    int64_t Or() {
+        int64_t value = Xor();
+        while (Accept("|")) value |= Xor();
+        return value;
+    }
+
+    int64_t Xor() {
+        int64_t value = And();
+        while (Accept("^")) value ^= And();
+        return value;
+    }
+
+    int64_t And() {
+        int64_t value = Shift();
+        while (Accept("&")) value &= Shift();
+        return value;
+    }
+
+    int64_t Shift() {
+        int64_t value = Sum();
+        for (;;) {
+            if (Accept("<<")) value = static_cast<int64_t>(static_cast<uint64_t>(value) << (Sum() & 63));
+            else if (Accept(">>")) value >>= (Sum() & 63);
+            else return value;
+        }
+    }
+
+    int64_t Sum() {
+        int64_t value = Product();
+        for (;;) {
+            if (Accept("+")) value += Product();
+            else if (Accept("-")) value -= Product();
+            else return value;
+        }
+    }
+
+    int64_t Product() {
+        int64_t value = Unary();
+        for (;;) {
+            bool divide = false;
+            if (Accept("*")) {
+                value *= Unary();
+                continue;
+            }
+            if (Accept("/")) divide = true;
+            else if (!Accept("%")) return value;
+
+            int64_t divisor = Unary();
+            if (divisor == 0) {
+                if (known) error = true;
+                continue;
+            }
+            value = divide ? value / divisor : value % divisor;
+        }
+    }
+
+    int64_t Unary() {
+        if (Accept("-")) return -Unary();
+        if (Accept("+")) return Unary();
+        if (Accept("~")) return ~Unary();
+        return Primary();
+    }
+
+    int64_t Digits(int base) {
+        size_t start = pos;
+        int64_t value = 0;
+        while (pos < text.size()) {
+            char c = static_cast<char>(std::tolower(static_cast<unsigned char>(text[pos])));
+            int digit = std::isdigit(static_cast<unsigned char>(c)) ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : 99;
+            if (c == '_') {
+                pos++;
+                continue;
+            }
+            if (digit >= base) break;
+            value = value * base + digit;
+            pos++;
+        }
+        if (pos == start) error = true;
+        return value;
+    }
+
+    int64_t Primary() {
+        Skip();
+        if (pos >= text.size()) {
+            error = true;
+            return 0;
+        }
+
+        char c = text[pos];
+        if (c == '(') {
+            pos++;
+            int64_t value = Or();
+            if (!Accept(")")) error = true;
+            return value;
+        }
+        if (c == '$') {
+            pos++;
+            return Digits(16);
+        }
+        if (c == '%') {
+            pos++;
+            return Digits(2);
+        }
+        if (c == '0' && pos + 1 < text.size() && (text[pos + 1] == 'x' || text[pos + 1] == 'X')) {
+            pos += 2;
+            return Digits(16);
+        }
+        if (std::isdigit(static_cast<unsigned char>(c))) return Digits(10);
+        if (c == '\'' && pos + 2 < text.size() && text[pos + 2] == '\'') {
+            pos += 3;
+            return static_cast<unsigned char>(text[pos - 2]);
+        }
+        if (c == '@') {
+            pos++;
+            return at;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '.') {
+            size_t start = pos;
+            while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_' ||
+                                         text[pos] == '.')) {
+                pos++;
+            }
+            std::string name = text.substr(start, pos - start);
+            std::string function = Lower(name);
+
+            Skip();
+            if (pos < text.size() && text[pos] == '(' && (function == "low" || function == "high" || function == "bank")) {
+                pos++;
+                int64_t value = 0;
+                if (function == "bank") {
+                    Skip();
+                    size_t label_start = pos;
+                    while (pos < text.size() && text[pos] != ')' && !std::isspace(static_cast<unsigned char>(text[pos]))) pos++;
+                    Resolve(text.substr(label_start, pos - label_start), true, value);
+                } else {
+                    value = Or();
+                    value = function == "low" ? (value & 0xFF) : ((value >> 8) & 0xFF);
+                }
+                if (!Accept(")")) error = true;
+                return value;
+            }
+
+            int64_t value = 0;
+            Resolve(name, false, value);
+            return value;
+        }
+
+        error = true;
+        return 0;
+    }
+
+    void Resolve(const std::string& name, bool bank_of, int64_t& value) {
+        if (name.empty()) {
+            error = true;
+            return;
+        }
+        if (!lookup(context, name, bank_of, value)) {
+            known = false;
+            value = 0;
+        }
+    }
+};
+
+// === Assembly ===
+
+bool SM83Assembler::Assemble(const std::string& source, const std::string& name) {
+    image.clear();
+    symbols.clear();
+    fixups.clear();
+    scope.clear();
+    source_name = name;
+    line_number = 0;
+    error_line = 0;
+    bank = 0;
+    pc = 0;
+    failed = false;
+
+    std::istringstream stream(source);
+    std::string line;
+    while (std::getline(stream, line)) {
+        line_number++;
+        AssembleLine(line);
+    }
+
+    for (const Fixup& fixup : fixups) {
+        line_number = fixup.line;
+        int64_t value = 0;
+        bool known = false;
+        if (!Evaluate(fixup.expr, fixup.scope, fixup.at, value, known)) {
+            Error("bad expression: " + fixup.expr);
+        } else if (!known) {
+            Error("undefined symbol in: " + fixup.expr);
+        } else {
+            Patch(fixup.offset, fixup.next_pc, fixup.kind, value);
+        }
+    }
+    return !failed;
+}
+
+// First error of each line only (a bad statement tends to fail per byte)
+void SM83Assembler::Error(const std::string& message) {
+    if (failed && line_number == error_line) return;
+    error_line = line_number;
+    std::cerr << source_name << ":" << line_number << ": " << message << "\n";
+    failed = true;
+}
+
+// Split on commas outside quotes and parentheses
+static std::vector<std::string> SplitOperands(const std::string& text) {
+    std::vector<std::string> operands;
+    std::string current;
+    int depth = 0;
+    char quote = 0;
+    for (char c : text) {
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '(' || c == '[') {
+            depth++;
+        } else if (c == ')' || c == ']') {
+            depth--;
+        } else if (c == ',' && depth == 0) {
+            operands.push_back(Trim(current));
+            current.clear();
+            continue;
+        }
+        current += c;
+    }
+    if (!Trim(current).empty() || !operands.empty()) operands.push_back(Trim(current));
+    return operands;
+}
+
+bool SM83Assembler::AssembleLine(const std::string& raw) {
+    // Comment, outside quotes
+    std::string line;
+    char quote = 0;
+    for (char c : raw) {
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == ';') {
+            break;
+        }
+        line += c;
+    }
+    line = Trim(line);
+    statement_pc = pc;
+    if (line.empty()) return true;
+
+    // Label (label: or label::), maybe followed by a statement
+    size_t word_end = line.find_first_of(" \t");
+    std::string first = line.substr(0, word_end);
+    if (first.size() > 1 && first.back() == ':') {
+        while (!first.empty() && first.back() == ':') first.pop_back();
+        DefineLabel(first);
+        line = word_end == std::string::npos ? "" : Trim(line.substr(word_end));
+        if (line.empty()) return true;
+        word_end = line.find_first_of(" \t");
+        first = line.substr(0, word_end);
+    }
+    std::string rest = word_end == std::string::npos ? "" : Trim(line.substr(word_end));
+
+    // NAME equ expr, NAME = expr
+    std::string rest_lower = Lower(rest);
+    bool equ = rest_lower.compare(0, 4, "equ ") == 0;
+    if (equ || (!rest.empty() && rest[0] == '=')) {
+        int64_t value = 0;
+        if (!EvaluateNow(Trim(rest.substr(equ ? 4 : 1)), value)) return false;
+        if (symbols.count(first)) {
+            Error("redefined: " + first);
+            return false;
+        }
+        symbols[first] = { value, -1 };
+        return true;
+    }
+
+    std::string mnemonic = Lower(first);
+    std::vector<std::string> operands = SplitOperands(rest);
+    if (Directive(mnemonic, operands)) return !failed;
+
+    // Operands without spaces ("[ hl + ]" -> "[hl+]")
+    for (std::string& operand : operands) {
+        operand.erase(std::remove_if(operand.begin(), operand.end(),
+                                     [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; }),
+                      operand.end());
+    }
+    return Instruction(mnemonic, operands);
+}
+
+// True if `mnemonic` was a directive (errors are reported either way)
+bool SM83Assembler::Directive(const std::string& mnemonic, const std::vector<std::string>& operands) {
+    if (mnemonic == "db") {
+        for (const std::string& operand : operands) {
+            if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') {
+                for (size_t i = 1; i + 1 < operand.size(); i++) Emit(static_cast<uint8_t>(operand[i]));
+            } else {
+                EmitImmediate(Immediate::U8, operand);
+            }
+        }
+        return true;
+    }
+    if (mnemonic == "dw") {
+        for (const std::string& operand : operands) EmitImmediate(Immediate::U16, operand);
+        return true;
+    }
+    if (mnemonic == "ds") {
+        int64_t count = 0;
+        int64_t fill = 0;
+        if (operands.empty() || operands.size() > 2 || !EvaluateNow(operands[0], count) ||
+            (operands.size() == 2 && !EvaluateNow(operands[1], fill))) {
+            if (operands.empty() || operands.size() > 2) Error("ds count[, fill]");
+            return true;
+        }
+        for (int64_t i = 0; i < count && !failed; i++) Emit(static_cast<uint8_t>(fill));
+        return true;
+    }
+    if (mnemonic == "org" || mnemonic == "bank") {
+        int64_t value = 0;
+        if (operands.size() != 1) {
+            Error(mnemonic + " takes one value");
+            return true;
+        }
+        if (!EvaluateNow(operands[0], value)) return true;
+
+        if (mnemonic == "bank") {
+            if (value < 0 || value > 511) {
+                Error("bank out of range (0-511)");
+                return true;
+            }
+            bank = static_cast<int32_t>(value);
+            pc = bank == 0 ? 0x0000 : 0x4000;
+        } else {
+            uint32_t start = bank == 0 ? 0x0000 : 0x4000;
+            if (value < start || value >= start + 0x4000) {
+                Error("org outside bank " + std::to_string(bank));
+                return true;
+            }
+            pc = static_cast<uint32_t>(value);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool SM83Assembler::Instruction(const std::string& mnemonic, const std::vector<std::string>& operands) {
+    if (mnemonic == "rst") {
+        int64_t vector = 0;
+        if (operands.size() != 1 || !EvaluateNow(operands[0], vector) || vector < 0 || vector > 0x38 || vector % 8) {
+            if (!failed) Error("rst takes $00, $08, ... $38");
+            return false;
+        }
+        Emit(static_cast<uint8_t>(0xC7 + vector));
+        return true;
+    }
+
+    std::string key = mnemonic;
+    std::string expr;
+    for (size_t i = 0; i < operands.size(); i++) {
+        std::string part;
+        if (i == 0 && (mnemonic == "bit" || mnemonic == "res" || mnemonic == "set")) {
+            int64_t bit = 0;
+            if (!EvaluateNow(operands[0], bit)) return false;
+            part = std::to_string(bit);
+        } else {
+            std::string operand_expr;
+            part = Classify(operands[i], operand_expr);
+            if (!operand_expr.empty()) {
+                if (!expr.empty()) {
+                    Error("more than one value operand");
+                    return false;
+                }
+                expr = operand_expr;
+            }
+        }
+        key += (i == 0 ? " " : ",") + part;
+    }
+
+    auto entry = Table().find(key);
+    if (entry == Table().end()) {
+        std::string text = mnemonic;
+        for (size_t i = 0; i < operands.size(); i++) text += (i == 0 ? " " : ", ") + operands[i];
+        Error("unknown instruction: " + text);
+        return false;
+    }
+
+    const Opcode& opcode = entry->second;
+    for (uint8_t i = 0; i < opcode.length; i++) Emit(opcode.code[i]);
+    if (opcode.immediate != Immediate::NONE) EmitImmediate(opcode.immediate, expr);
+    return true;
+}
+
+void SM83Assembler::DefineLabel(const std::string& name) {
+    if (name[0] != '.') scope = name;
+    std::string full = QualifyName(name, scope);
+    if (symbols.count(full)) {
+        Error("redefined: " + full);
+        return;
+    }
+    symbols[full] = { pc, bank };
+}
+
+std::string SM83Assembler::QualifyName(const std::string& name, const std::string& label_scope) const {
+    return name[0] == '.' ? label_scope + name : name;
+}
+
+bool SM83Assembler::GetSymbol(const std::string& name, int64_t& value) const {
+    auto symbol = symbols.find(name);
+    if (symbol == symbols.end()) return false;
+    value = symbol->second.value;
+    return true;
+}
+
+// === Output ===
+
+void SM83Assembler::Emit(uint8_t value) {
+    uint32_t end = bank == 0 ? 0x4000 : 0x8000;
+    if (pc >= end) {
+        Error("bank " + std::to_string(bank) + " is full");
+        return;
+    }
+    if (bank == 0 && pc >= 0x0104 && pc < 0x0150) {
+        Error("code overlaps the cartridge header ($0104-$014F)");
+        return;
+    }
+
+    size_t offset = bank == 0 ? pc : static_cast<size_t>(bank) * 0x4000 + (pc - 0x4000);
+    if (image.size() <= offset) image.resize(offset + 1, 0x00);
+    image[offset] = value;
+    pc++;
+}
+
+void SM83Assembler::EmitImmediate(Immediate kind, const std::string& expr) {
+    size_t offset = bank == 0 ? pc : static_cast<size_t>(bank) * 0x4000 + (pc - 0x4000);
+    uint32_t start = pc;
+    Emit(0);
+    if (kind == Immediate::U16) Emit(0);
+    if (pc != start + (kind == Immediate::U16 ? 2u : 1u)) return;
+
+    int64_t value = 0;
+    bool known = false;
+    if (!Evaluate(expr, scope, statement_pc, value, known)) {
+        Error("bad expression: " + expr);
+        return;
+    }
+    uint16_t next_pc = static_cast<uint16_t>(pc);
+    if (known) {
+        Patch(offset, next_pc, kind, value);
+    } else {
+        fixups.push_back({ offset, statement_pc, next_pc, kind, expr, scope, line_number });
+    }
+}
+
+bool SM83Assembler::Patch(size_t offset, uint16_t next_pc, Immediate kind, int64_t value) {
+    switch (kind) {
+        case Immediate::U8:
+            if (value < -128 || value > 0xFF) break;
+            image[offset] = static_cast<uint8_t>(value);
+            return true;
+        case Immediate::U16:
+            if (value < -32768 || value > 0xFFFF) break;
+            image[offset] = static_cast<uint8_t>(value);
+            image[offset + 1] = static_cast<uint8_t>(value >> 8);
+            return true;
+        case Immediate::REL:
+            value -= next_pc;
+            if (value < -128 || value > 127) {
+                Error("jr target out of range (" + std::to_string(value) + ")");
+                return false;
+            }
+            image[offset] = static_cast<uint8_t>(value);
+            return true;
+        case Immediate::HIGH:
+            if (value >= 0xFF00 && value <= 0xFFFF) value -= 0xFF00;
+            if (value < 0 || value > 0xFF) break;
+            image[offset] = static_cast<uint8_t>(value);
+            return true;
+        case Immediate::S8:
+            if (value < -128 || value > 127) break;
+            image[offset] = static_cast<uint8_t>(value);
+            return true;
+        case Immediate::NONE:
+            return true;
+    }
+    Error("value out of range: " + std::to_string(value));
+    return false;
+}
+
+// === Expressions ===
+
+bool SM83Assembler::Evaluate(const std::string& expr, const std::string& label_scope, uint32_t at,
+                             int64_t& value, bool& known) const {
+    struct Context {
+        const SM83Assembler* assembler;
+        const std::string* scope;
+    } context = { this, &label_scope };
+
+    auto lookup = [](const void* opaque, const std::string& name, bool bank_of, int64_t& result) {
+        const Context& ctx = *static_cast<const Context*>(opaque);
+        auto symbol = ctx.assembler->symbols.find(ctx.assembler->QualifyName(name, *ctx.scope));
+        if (symbol == ctx.assembler->symbols.end()) return false;
+        result = bank_of ? std::max(symbol->second.bank, 0) : symbol->second.value;
+        return true;
+    };
+
+    ExpressionParser parser(expr, at, lookup, &context);
+    return parser.Parse(value, known);
+}
+
+bool SM83Assembler::EvaluateNow(const std::string& expr, int64_t& value) {
+    bool known = false;
+    if (!Evaluate(expr, scope, statement_pc, value, known)) {
+        Error("bad expression: " + expr);
+        return false;
+    }
+    if (!known) {
+        Error("must be defined before use: " + expr);
+        return false;
+    }
+    return true;
+}
+
+// === ROM ===
+
+std::vector<uint8_t> SM83Assembler::BuildROM(const Header& header) const {
+    uint32_t banks = 2;
+    while (banks < std::max(header.min_banks, GetBankCount())) banks *= 2;
+
+    std::vector<uint8_t> rom = image;
+    rom.resize(static_cast<size_t>(banks) * 0x4000, 0x00);
+
+    std::copy(std::begin(NINTENDO_LOGO), std::end(NINTENDO_LOGO), rom.begin() + 0x104);
+    std::fill(rom.begin() + 0x134, rom.begin() + 0x144, 0x00);
+    for (size_t i = 0; i < header.title.size() && i < 15; i++) {
+        rom[0x134 + i] = static_cast<uint8_t>(std::toupper(static_cast<unsigned char>(header.title[i])));
+    }
+
+    uint8_t size_code = 0;
+    while ((2u << size_code) < banks) size_code++;
+    rom[0x144] = '0';                       // New licensee "00"
+    rom[0x145] = '0';
+    rom[0x146] = 0x00;                      // No SGB functions
+    rom[0x147] = header.cartridge_type;
+    rom[0x148] = size_code;                 // 32 KB << code
+    rom[0x149] = header.ram_size;
+    rom[0x14A] = 0x01;                      // Non-Japanese
+    rom[0x14B] = 0x33;                      // See new licensee
+    rom[0x14C] = 0x00;                      // Version
+
+    uint8_t header_sum = 0;
+    for (size_t i = 0x134; i <= 0x14C; i++) header_sum = static_cast<uint8_t>(header_sum - rom[i] - 1);
+    rom[0x14D] = header_sum;
+
+    uint16_t global_sum = 0;
+    rom[0x14E] = rom[0x14F] = 0;
+    for (uint8_t byte : rom) global_sum = static_cast<uint16_t>(global_sum + byte);
+    rom[0x14E] = static_cast<uint8_t>(global_sum >> 8);   // Big-endian
+    rom[0x14F] = static_cast<uint8_t>(global_sum);
+    return rom;
+}
+
+bool SM83Assembler::WriteROM(const std::string& path, const Header& header) const {
+    std::vector<uint8_t> rom = BuildROM(header);
+    std::ofstream file(path, std::ios::binary);
+    if (!file || !file.write(reinterpret_cast<const char*>(rom.data()), static_cast<std::streamsize>(rom.size()))) {
+        std::cerr << "Failed to write ROM: " << path << "\n";
+        return false;
+    }
+    return true;
+}
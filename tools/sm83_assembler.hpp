@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * SM83Assembler - Small Two-Pass Assembler for Generated ROMs
+ *
+ * Enough of an assembler for the benchmark ROM generator (gb-bench-roms)
+ * and similar tools: every documented SM83 instruction in RGBDS-style
+ * syntax, labels, constants, banked ROM, and a ROM builder that writes a
+ * valid header (logo, title, cartridge type, sizes, both checksums).
+ *
+ * Syntax:
+ *   label:          global label; `.name:` is local to the last global one
+ *   NAME equ expr   constant (also NAME = expr); must be defined before use
+ *   ld a, [hl+]     memory operands in brackets: [hl] [hl+] [hl-] [bc]
+ *                   [de] [c] [expr]; high page via ldh [expr], a
+ *   ld hl, sp+expr  add sp, expr   jr/jp/call cc, expr   rst $38
+ *   db 1, "text"    dw expr, ...   ds count[, fill]
+ *   bank N          continue in ROM bank N ($0000 for 0, $4000 for others)
+ *   org expr        set the address within the current bank
+ * Expressions: $hex, 0x hex, %binary, decimal, 'c', symbols, @ (current
+ * address), + - * / % & | ^ << >> ~ and parentheses, plus low(x), high(x)
+ * and bank(label). `;` starts a comment.
+ *
+ * Assemble() takes the whole program. Forward references are patched
+ * after the last line; everything else is evaluated in place. Errors go
+ * to std::cerr as "name:line: message".
+ */
+class SM83Assembler {
+public:
+    struct Header {
+        std::string title;              // Up to 15 characters
+        uint8_t cartridge_type = 0x00;  // $0147: $00 ROM ONLY, $01 MBC1, $05 MBC2, $13 MBC3+RAM+BATTERY, ...
+        uint8_t ram_size = 0x00;        // $0149 code: $02 = 8 KB, $03 = 32 KB, ...
+        uint32_t min_banks = 2;         // ROM is padded to a power of two >= this and the banks used
+    };
+
+    bool Assemble(const std::string& source, const std::string& name = "source");
+
+    // Image with the header filled in; entry point ($0100-$0103) is the
+    // source's job, the header area ($0104-$014F) is rejected if written
+    std::vector<uint8_t> BuildROM(const Header& header) const;
+    bool WriteROM(const std::string& path, const Header& header) const;
+
+    uint32_t GetBankCount() const { return static_cast<uint32_t>((image.size() + 0x3FFF) / 0x4000); }
+    bool GetSymbol(const std::string& name, int64_t& value) const;
+
+    // Operand encodings: n8, n16, jr offset, ldh page offset, signed e8
+    enum class Immediate : uint8_t { NONE, U8, U16, REL, HIGH, S8 };
+
+private:
+    struct Symbol {
+        int64_t value;
+        int32_t bank;           // -1 for constants
+    };
+
+    struct Fixup {
+        size_t offset;
+        uint32_t at;            // Statement address, for @
+        uint16_t next_pc;       // Address after the instruction (REL base)
+        Immediate kind;
+        std::string expr;
+        std::string scope;
+        int line;
+    };
+
+    std::vector<uint8_t> image;
+    std::map<std::string, Symbol> symbols;
+    std::vector<Fixup> fixups;
+    std::string scope;          // Last global label, for .local names
+    std::string source_name;
+    int line_number = 0;
+    int error_line = 0;
+    int32_t bank = 0;
+    uint32_t pc = 0;
+    uint32_t statement_pc = 0;
+    bool failed = false;
+
+    void Error(const std::string& message);
+    bool AssembleLine(const std::string& line);
+    bool Directive(const std::string& mnemonic, const std::vector<std::string>& operands);
+    bool Instruction(const std::string& mnemonic, const std::vector<std::string>& operands);
+    void DefineLabel(const std::string& name);
+    std::string QualifyName(const std::string& name, const std::string& label_scope) const;
+
+    void Emit(uint8_t value);
+    void EmitImmediate(Immediate kind, const std::string& expr);
+    bool Patch(size_t offset, uint16_t next_pc, Immediate kind, int64_t value);
+
+    // False on a syntax error; `known` false if a symbol isn't defined yet
+    bool Evaluate(const std::string& expr, const std::string& label_scope, uint32_t at,
+                  int64_t& value, bool& known) const;
+    bool EvaluateNow(const std::string& expr, int64_t& value);   // Must be known
+};
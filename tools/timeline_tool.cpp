@@ -0,0 +1,173 @@
+/**
+ * timeline_tool - Record a long session into a Timeline and time seeks
+ *
+ * Records F frames of generated input (a button set held for a few to a
+ * few dozen frames at a time, like a player), noting the full save state
+ * at K random frames on the way. Then seeks to those frames in shuffled
+ * order, timing each and checking the machine matches what was recorded
+ * there byte for byte. Exits non-zero on any mismatch.
+ *
+ * The default 216,000 frames is one hour of play.
+ *
+ * Usage: gb-timeline <rom> [--frames F] [--seeks K] [--spacing N]
+ *                          [--budget MB] [--save out.gbt] [--load in.gbt]
+ *                          [--verify] [--threads T]
+ *
+ * --load replaces recording with a saved timeline (no match check);
+ * --save writes the recorded one. --verify first replays the whole
+ * timeline as parallel keyframe-to-keyframe segments (T threads, default
+ * one per core) and fails on any segment not ending on the next keyframe
+ * or, after recording, a final state other than the recorded one.
+ */
+
+#include "Emulator.hpp"
+#include "state/Timeline.hpp"
+#include "util/Hash.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <rom> [--frames F] [--seeks K] [--spacing N] "
+                             "[--budget MB] [--save out.gbt] [--load in.gbt] [--verify] [--threads T]\n", argv[0]);
+        return 2;
+    }
+
+    std::string rom_path = argv[1];
+    uint32_t frames = 216000;
+    uint32_t seeks = 200;
+    uint32_t spacing = Timeline::DEFAULT_SPACING;
+    size_t budget = Timeline::DEFAULT_BUDGET;
+    std::string save_path;
+    std::string load_path;
+    bool verify = false;
+    unsigned threads = 0;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) frames = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--seeks" && i + 1 < argc) seeks = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--spacing" && i + 1 < argc) spacing = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--budget" && i + 1 < argc) budget = static_cast<size_t>(std::atof(argv[++i]) * 1024 * 1024);
+        else if (arg == "--save" && i + 1 < argc) save_path = argv[++i];
+        else if (arg == "--load" && i + 1 < argc) load_path = argv[++i];
+        else if (arg == "--verify") verify = true;
+        else if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::atoi(argv[++i]));
+    }
+
+    Emulator emu;
+    if (!emu.LoadROM(rom_path)) {
+        std::fprintf(stderr, "Failed to load ROM: %s\n", rom_path.c_str());
+        return 1;
+    }
+    emu.Reset();
+
+    Timeline timeline;
+    timeline.SetSpacing(spacing);
+    timeline.SetMemoryBudget(budget);
+    std::mt19937 random(1234);
+    std::map<uint32_t, uint64_t> expected;   // Seek target -> state hash while recording
+    uint64_t final_hash = 0;
+
+    if (!load_path.empty()) {
+        if (!timeline.Load(load_path)) return 1;
+        frames = timeline.GetLength();
+        for (uint32_t i = 0; i < seeks && frames > 0; i++) expected[random() % (frames + 1)] = 0;
+    } else {
+        for (uint32_t i = 0; i < seeks; i++) expected[random() % (frames + 1)] = 0;
+
+        std::vector<uint8_t> state;
+        uint8_t buttons = 0;
+        uint32_t hold = 0;
+        timeline.Start(emu);
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame <= frames; frame++) {
+            auto target = expected.find(frame);
+            if (target != expected.end()) {
+                emu.SaveState(state);
+                target->second = HashBytes(state);
+            }
+            if (frame == frames) break;
+
+            if (hold-- == 0) {
+                buttons = static_cast<uint8_t>(random() & random());   // Mostly one or two buttons
+                hold = 4 + random() % 40;
+            }
+            timeline.RunFrame(emu, buttons);
+        }
+        emu.SaveState(state);
+        final_hash = HashBytes(state);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("Recorded %u frames in %.1f s (%.0f frames/s)\n", frames, seconds, frames / std::max(seconds, 1e-9));
+    }
+
+    std::printf("Keyframes: %zu every %u frames, %.1f MB (budget %.1f MB)\n",
+                timeline.GetKeyframeCount(), timeline.GetSpacing(),
+                timeline.GetMemoryUsed() / (1024.0 * 1024.0), budget / (1024.0 * 1024.0));
+
+    if (!save_path.empty() && timeline.Save(save_path)) {
+        std::printf("Saved timeline: %s\n", save_path.c_str());
+    }
+
+    if (verify) {
+        Timeline::VerifyReport report;
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        auto start = std::chrono::steady_clock::now();
+        if (!timeline.Verify([&rom_path](Emulator& worker) { return worker.LoadROM(rom_path); }, threads, report)) {
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("Verified %u segments on %u threads in %.1f s (%.0f frames/s)\n", report.segments,
+                    std::min(threads, report.segments), seconds, timeline.GetLength() / std::max(seconds, 1e-9));
+        std::printf("Final state hash: %016llx\n", static_cast<unsigned long long>(report.final_hash));
+        if (report.mismatches) {
+            std::printf("%u of %u segments don't end on the next keyframe (first from frame %u)\n",
+                        report.mismatches, report.segments, report.first_mismatch);
+            return 1;
+        }
+        if (load_path.empty() && report.final_hash != final_hash) {
+            std::printf("Final state doesn't match the recording\n");
+            return 1;
+        }
+    }
+
+    std::vector<uint32_t> targets;
+    for (const auto& entry : expected) targets.push_back(entry.first);
+    std::shuffle(targets.begin(), targets.end(), random);
+
+    std::vector<double> times;
+    std::vector<uint8_t> state;
+    uint32_t mismatches = 0;
+    for (uint32_t target : targets) {
+        auto start = std::chrono::steady_clock::now();
+        if (!timeline.Seek(emu, target)) {
+            std::fprintf(stderr, "Seek to frame %u failed\n", target);
+            return 1;
+        }
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        if (load_path.empty()) {
+            emu.SaveState(state);
+            if (HashBytes(state) != expected[target]) {
+                if (mismatches++ == 0) std::printf("State after seeking to frame %u doesn't match the recording\n", target);
+            }
+        }
+    }
+
+    std::sort(times.begin(), times.end());
+    if (!times.empty()) {
+        std::printf("%zu seeks: median %.1f ms, p99 %.1f ms, max %.1f ms\n", times.size(),
+                    times[times.size() / 2], times[times.size() * 99 / 100], times.back());
+    }
+    if (load_path.empty()) {
+        std::printf("%u of %zu seeks matched the recording\n",
+                    static_cast<uint32_t>(targets.size()) - mismatches, targets.size());
+    }
+    return mismatches ? 1 : 0;
+}